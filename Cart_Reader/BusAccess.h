@@ -0,0 +1,445 @@
+/********************************************************************
+*                   Open Source Cartridge Reader                    *
+********************************************************************/
+#ifndef BUSACCESS_H_
+#define BUSACCESS_H_
+
+#include <stdint.h>
+#include <avr/io.h>
+
+/*H******************************************************************
+* FILENAME :        BusAccess.h
+*
+* DESCRIPTION :
+*       Compile-time description of the cartridge buses used by the
+*       bigger cores. A bus is a plain struct of typedefs (ports and
+*       control pins) and constants (access timing, address shift).
+*       The read templates below are instantiated per bus and fully
+*       inlined, so the innermost dump loops compile to the same
+*       in/out/lds/sts sequence as the old hand-written functions.
+*
+* USAGE :
+*       word myWord = busStrobe16<N64Bus>();
+*       byte myByte = busRead8<GbBus>(address);
+*
+*       To change the timing of a core edit its access constant, e.g.
+*       "accessCycles = busNs(310)". The value is rounded up to whole
+*       CPU cycles at F_CPU. When 3V3FIX halves the clock at runtime
+*       every delay simply gets twice as long, which is always safe.
+*
+* NOTES :
+*       Everything in here is static inline or a template; if a core is
+*       disabled its bus description costs nothing.
+*
+*H*/
+
+/*==== PORTS & PINS ===============================================*/
+
+// Data-space address of the PINx register, DDRx and PORTx follow at
+// +1 and +2. See ATmega2560 datasheet, "Register Summary".
+template<uint16_t PinAddr>
+struct BusPort {
+  static constexpr uint16_t id = PinAddr;
+
+  static inline uint8_t in() __attribute__((always_inline)) {
+    return _SFR_MEM8(PinAddr);
+  }
+  static inline void out(uint8_t value) __attribute__((always_inline)) {
+    _SFR_MEM8(PinAddr + 2) = value;
+  }
+  static inline void output() __attribute__((always_inline)) {
+    _SFR_MEM8(PinAddr + 1) = 0xFF;
+  }
+  // Switch to input, optionally enabling the internal pull-ups
+  static inline void input(uint8_t pullups = 0x00) __attribute__((always_inline)) {
+    _SFR_MEM8(PinAddr + 1) = 0x00;
+    _SFR_MEM8(PinAddr + 2) = pullups;
+  }
+};
+
+typedef BusPort<0x20> BusPortA;
+typedef BusPort<0x26> BusPortC;
+typedef BusPort<0x2F> BusPortF;
+typedef BusPort<0x32> BusPortG;
+typedef BusPort<0x100> BusPortH;
+typedef BusPort<0x103> BusPortJ;
+typedef BusPort<0x106> BusPortK;
+typedef BusPort<0x109> BusPortL;
+
+template<class Port, uint8_t Bit>
+struct BusPin {
+  static_assert(Bit < 8, "Pin number out of range");
+
+  typedef Port port;
+  static constexpr uint16_t id = (Port::id << 3) | Bit;
+  static constexpr uint8_t mask = (1 << Bit);
+
+  static inline void low() __attribute__((always_inline)) {
+    _SFR_MEM8(Port::id + 2) &= ~mask;
+  }
+  static inline void high() __attribute__((always_inline)) {
+    _SFR_MEM8(Port::id + 2) |= mask;
+  }
+  // Read-modify-write like the old pulse_clock(), keeps the CLK period unchanged
+  static inline void toggle() __attribute__((always_inline)) {
+    _SFR_MEM8(Port::id + 2) ^= mask;
+  }
+  static inline bool read() __attribute__((always_inline)) {
+    return _SFR_MEM8(Port::id) & mask;
+  }
+  // Direction of a single pin, for serial lines that turn around
+  static inline void output() __attribute__((always_inline)) {
+    _SFR_MEM8(Port::id + 1) |= mask;
+  }
+  static inline void input() __attribute__((always_inline)) {
+    _SFR_MEM8(Port::id + 1) &= ~mask;
+  }
+};
+
+// A group of control pins that are asserted/released together, in order.
+template<class... Pins>
+struct BusPins {
+  static inline void low() __attribute__((always_inline)) {
+    int order[] = { 0, (Pins::low(), 0)... };
+    (void)order;
+  }
+  static inline void high() __attribute__((always_inline)) {
+    int order[] = { 0, (Pins::high(), 0)... };
+    (void)order;
+  }
+  static inline void toggle() __attribute__((always_inline)) {
+    int order[] = { 0, (Pins::toggle(), 0)... };
+    (void)order;
+  }
+};
+
+/*==== COMPILE-TIME CHECKS ========================================*/
+
+constexpr bool busIdIn(uint16_t) {
+  return false;
+}
+
+template<class... Rest>
+constexpr bool busIdIn(uint16_t id, uint16_t first, Rest... rest) {
+  return (id == first) || busIdIn(id, rest...);
+}
+
+constexpr bool busIdsDistinct() {
+  return true;
+}
+
+template<class... Rest>
+constexpr bool busIdsDistinct(uint16_t first, Rest... rest) {
+  return !busIdIn(first, rest...) && busIdsDistinct(rest...);
+}
+
+// True if no two pins are the same
+template<class... Pins>
+constexpr bool busPinsDistinct() {
+  return busIdsDistinct(Pins::id...);
+}
+
+// True if none of the pins sits on the given (address/data) port
+template<class Port, class... Pins>
+constexpr bool busPinsAvoid() {
+  return !busIdIn(Port::id, Pins::port::id...);
+}
+
+/*==== TIMING =====================================================*/
+
+// Nanoseconds to CPU cycles, rounded up. 1 cycle = 62.5ns at 16MHz.
+constexpr uint8_t busNs(uint16_t ns) {
+  return (uint8_t)(((uint32_t)ns * (F_CPU / 1000000UL) + 999UL) / 1000UL);
+}
+
+template<uint8_t Cycles>
+static inline void busDelay() __attribute__((always_inline));
+template<uint8_t Cycles>
+static inline void busDelay() {
+  __builtin_avr_delay_cycles(Cycles);
+}
+template<>
+inline void busDelay<0>() {}
+
+template<class Clock, uint8_t Count>
+static inline void busClockPulses() __attribute__((always_inline));
+template<class Clock, uint8_t Count>
+static inline void busClockPulses() {
+  for (uint8_t i = 0; i < Count; i++)
+    Clock::toggle();
+}
+
+/*==== BUS DESCRIPTIONS ===========================================*/
+
+/**
+ * Nintendo 64
+ * Multiplexed AD0-AD15, address is latched beforehand by setAddress_N64().
+ **/
+struct N64Bus {
+  typedef BusPortF DataLo;             // AD0-AD7
+  typedef BusPortK DataHi;             // AD8-AD15
+  typedef BusPin<BusPortH, 6> Read;    // /RD
+  typedef BusPin<BusPortH, 5> Write;   // /WR
+  typedef BusPin<BusPortC, 0> AleL;    // ALE_L
+  typedef BusPin<BusPortC, 1> AleH;    // ALE_H
+  typedef BusPin<BusPortH, 0> Reset;   // /RESET
+  static constexpr uint8_t width = 16;
+  static constexpr uint8_t accessCycles = busNs(310);
+};
+static_assert(busPinsDistinct<N64Bus::Read, N64Bus::Write, N64Bus::AleL, N64Bus::AleH, N64Bus::Reset>(), "N64 control pin conflict");
+static_assert(busPinsAvoid<N64Bus::DataLo, N64Bus::Read, N64Bus::Write, N64Bus::AleL, N64Bus::AleH, N64Bus::Reset>(), "N64 control pin on AD0-AD7");
+static_assert(busPinsAvoid<N64Bus::DataHi, N64Bus::Read, N64Bus::Write, N64Bus::AleL, N64Bus::AleH, N64Bus::Reset>(), "N64 control pin on AD8-AD15");
+
+/**
+ * Game Boy Advance ROM
+ * AD0-AD15 are shared between the low address word and the data word.
+ **/
+struct GbaRomBus {
+  typedef BusPortF AddrLo;             // AD0-AD7
+  typedef BusPortK AddrMid;            // AD8-AD15
+  typedef BusPortC AddrHi;             // A16-A23
+  typedef BusPortF DataLo;
+  typedef BusPortK DataHi;
+  typedef BusPins<BusPin<BusPortH, 3> > Select;  // /CS
+  typedef BusPins<BusPin<BusPortH, 6> > Read;    // /RD
+  typedef BusPins<> Clock;
+  static constexpr bool multiplexed = true;
+  static constexpr uint8_t width = 16;
+  static constexpr uint8_t addressShift = 1;  // byte to word address
+  static constexpr uint8_t setupCycles = 0;
+  static constexpr uint8_t accessCycles = busNs(250);  // needed for repros
+  static constexpr uint8_t recoveryCycles = 0;
+  static constexpr uint8_t clockPulses = 0;
+};
+static_assert(busPinsDistinct<BusPin<BusPortH, 3>, BusPin<BusPortH, 6> >(), "GBA control pin conflict");
+static_assert(busPinsAvoid<GbaRomBus::AddrHi, BusPin<BusPortH, 3>, BusPin<BusPortH, 6> >(), "GBA control pin on A16-A23");
+
+/**
+ * Mega Drive/Genesis
+ * Separate A1-A23 and D0-D15, SVP carts additionally need CLK pulses.
+ **/
+struct MdBus {
+  typedef BusPortF AddrLo;             // A1-A8
+  typedef BusPortK AddrMid;            // A9-A16
+  typedef BusPortL AddrHi;             // A17-A23
+  typedef BusPortC DataLo;             // D0-D7
+  typedef BusPortA DataHi;             // D8-D15
+  typedef BusPins<BusPin<BusPortH, 3> > Select;  // /CS
+  typedef BusPins<BusPin<BusPortH, 6>, BusPin<BusPortJ, 1>, BusPin<BusPortG, 5> > Read;  // /OE, /AS, ASEL
+  typedef BusPins<BusPin<BusPortH, 1> > Clock;   // CLK
+  static constexpr bool multiplexed = false;
+  static constexpr uint8_t width = 16;
+  static constexpr uint8_t addressShift = 0;
+  static constexpr uint8_t setupCycles = busNs(62);
+  // most MD ROMs are 200ns, comparable to SNES > use similar access delay
+  static constexpr uint8_t accessCycles = busNs(375);
+  static constexpr uint8_t recoveryCycles = busNs(375);
+  static constexpr uint8_t clockPulses = 10;
+};
+static_assert(busPinsDistinct<BusPin<BusPortH, 3>, BusPin<BusPortH, 6>, BusPin<BusPortJ, 1>, BusPin<BusPortG, 5>, BusPin<BusPortH, 1> >(), "MD control pin conflict");
+
+// ROM dump loop timing: no recovery wait, CLK is only pulsed for SVP carts
+struct MdFastBus : MdBus {
+  static constexpr uint8_t recoveryCycles = 0;
+  static constexpr uint8_t clockPulses = 0;
+};
+struct MdSvpBus : MdBus {
+  static constexpr uint8_t recoveryCycles = 0;
+};
+
+/**
+ * Mega Drive flash repros
+ * Same lines as MdBus, but only /OE is strobed while the flash is programmed.
+ **/
+struct MdFlashBus : MdBus {
+  typedef BusPins<> Select;
+  typedef BusPins<BusPin<BusPortH, 6> > Read;  // /OE
+  typedef BusPins<> Clock;
+  static constexpr uint8_t accessCycles = busNs(500);
+  static constexpr uint8_t recoveryCycles = busNs(500);
+  static constexpr uint8_t clockPulses = 0;
+};
+
+/**
+ * Flash adapter in 16 bit mode, also used by the CPS3 SIMMs
+ * Separate A0-A23 and D0-D15, word addressed.
+ **/
+struct Flash16Bus {
+  typedef BusPortF AddrLo;             // A0-A7
+  typedef BusPortK AddrMid;            // A8-A15
+  typedef BusPortL AddrHi;             // A16-A23
+  typedef BusPortC DataLo;             // D0-D7
+  typedef BusPortA DataHi;             // D8-D15
+  typedef BusPins<> Select;
+  typedef BusPins<BusPin<BusPortH, 1> > Read;    // /OE
+  typedef BusPins<> Clock;
+  static constexpr bool multiplexed = false;
+  static constexpr uint8_t width = 16;
+  static constexpr uint8_t addressShift = 0;
+  static constexpr uint8_t setupCycles = busNs(62);
+  static constexpr uint8_t accessCycles = busNs(375);
+  static constexpr uint8_t recoveryCycles = busNs(375);
+  static constexpr uint8_t clockPulses = 0;
+};
+
+/**
+ * Game Boy (Color)
+ * A0-A15 and D0-D7 on separate ports.
+ **/
+struct GbBus {
+  typedef BusPortF AddrLo;             // A0-A7
+  typedef BusPortK AddrHi;             // A8-A15
+  typedef BusPortC Data;               // D0-D7
+  typedef BusPin<BusPortH, 6> Read;    // /RD
+  typedef BusPin<BusPortH, 5> Write;   // /WR
+  typedef BusPin<BusPortH, 3> Select;  // /CS (SRAM)
+  static constexpr uint8_t width = 8;
+  static constexpr uint8_t setupCycles = busNs(250);
+  static constexpr uint8_t accessCycles = busNs(250);
+  static constexpr uint8_t recoveryCycles = busNs(250);
+};
+static_assert(busPinsDistinct<GbBus::Read, GbBus::Write, GbBus::Select>(), "GB control pin conflict");
+static_assert(busPinsAvoid<GbBus::Data, GbBus::Read, GbBus::Write, GbBus::Select>(), "GB control pin on D0-D7");
+
+/**
+ * NES/Famicom
+ * CPU A0-A14 and PPU A0-A13 share PORTL/PORTA, PPU /A13 is driven separately.
+ **/
+struct NesBus {
+  typedef BusPortL AddrLo;               // A0-A7
+  typedef BusPortA AddrHi;               // A8-A15
+  typedef BusPortK Data;                 // D0-D7
+  typedef BusPin<BusPortF, 0> Phi2;      // M2
+  typedef BusPin<BusPortF, 1> RomSel;    // /ROMSEL
+  typedef BusPin<BusPortF, 2> ChrWrite;  // PPU /WR
+  typedef BusPin<BusPortF, 4> PpuA13n;   // PPU /A13
+  typedef BusPin<BusPortF, 5> ChrRead;   // PPU /RD
+  typedef BusPin<BusPortF, 7> PrgRw;     // CPU R/W
+  static constexpr uint8_t width = 8;
+};
+static_assert(busPinsDistinct<NesBus::Phi2, NesBus::RomSel, NesBus::ChrWrite, NesBus::PpuA13n, NesBus::ChrRead, NesBus::PrgRw>(), "NES control pin conflict");
+static_assert(busPinsAvoid<NesBus::Data, NesBus::Phi2, NesBus::RomSel, NesBus::ChrWrite, NesBus::PpuA13n, NesBus::ChrRead, NesBus::PrgRw>(), "NES control pin on D0-D7");
+
+/*==== ACCESS TEMPLATES ===========================================*/
+
+// Strobe /RD on a bus whose address has already been latched and capture one word
+template<class Bus>
+static inline uint16_t busStrobe16() __attribute__((always_inline));
+template<class Bus>
+static inline uint16_t busStrobe16() {
+  static_assert(Bus::width == 16, "busStrobe16 needs a 16 bit bus");
+  Bus::Read::low();
+  busDelay<Bus::accessCycles>();
+  uint16_t value = (Bus::DataHi::in() << 8) | Bus::DataLo::in();
+  Bus::Read::high();
+  return value;
+}
+
+// Full 16 bit read cycle: drive address, select, strobe, capture, release
+template<class Bus>
+static inline uint16_t busRead16(uint32_t address) __attribute__((always_inline));
+template<class Bus>
+static inline uint16_t busRead16(uint32_t address) {
+  static_assert(Bus::width == 16, "busRead16 needs a 16 bit bus");
+  address >>= Bus::addressShift;
+
+  if (Bus::multiplexed) {
+    Bus::AddrLo::output();
+    Bus::AddrMid::output();
+    Bus::AddrHi::output();
+  }
+  Bus::AddrLo::out(address);
+  Bus::AddrMid::out(address >> 8);
+  Bus::AddrHi::out(address >> 16);
+  busDelay<Bus::setupCycles>();
+
+  Bus::Select::low();
+  if (Bus::multiplexed) {
+    // Hand the shared lines over to the cartridge
+    Bus::AddrLo::input();
+    Bus::AddrMid::input();
+  }
+  Bus::Read::low();
+  busClockPulses<typename Bus::Clock, Bus::clockPulses>();
+  busDelay<Bus::accessCycles>();
+
+  uint16_t value = (Bus::DataHi::in() << 8) | Bus::DataLo::in();
+
+  Bus::Read::high();
+  Bus::Select::high();
+  busClockPulses<typename Bus::Clock, Bus::clockPulses>();
+  busDelay<Bus::recoveryCycles>();
+
+  return value;
+}
+
+// Full 8 bit read cycle on a bus with separate address and data ports
+template<class Bus>
+static inline uint8_t busRead8(uint16_t address) __attribute__((always_inline));
+template<class Bus>
+static inline uint8_t busRead8(uint16_t address) {
+  static_assert(Bus::width == 8, "busRead8 needs an 8 bit bus");
+  Bus::AddrLo::out(address & 0xFF);
+  Bus::AddrHi::out(address >> 8);
+  Bus::Data::input(0xFF);
+  busDelay<Bus::setupCycles>();
+
+  Bus::Read::low();
+  busDelay<Bus::accessCycles>();
+  uint8_t value = Bus::Data::in();
+  Bus::Read::high();
+  busDelay<Bus::recoveryCycles>();
+
+  return value;
+}
+
+// Check that a run of words reads back as 0xFFFF, e.g. after an erase. A8-A23
+// are only driven once per 256 words and the words are ANDed together, so the
+// inner loop is just A0-A7 and the strobe. Stops after the first run that is
+// not blank. The data ports have to be inputs already.
+template<class Bus>
+static bool busBlank16(uint32_t address, uint32_t words) {
+  static_assert((Bus::width == 16) && !Bus::multiplexed, "busBlank16 needs a 16 bit bus with separate data lines");
+  static_assert(Bus::clockPulses == 0, "busBlank16 does not pulse CLK");
+  address >>= Bus::addressShift;
+
+  while (words) {
+    Bus::AddrMid::out(address >> 8);
+    Bus::AddrHi::out(address >> 16);
+
+    uint8_t low = address;
+    uint16_t run = 0x100 - low;
+    if (run > words)
+      run = words;
+
+    uint8_t blank = 0xFF;
+    for (uint16_t i = 0; i < run; i++) {
+      Bus::AddrLo::out(low++);
+      busDelay<Bus::setupCycles>();
+      Bus::Select::low();
+      Bus::Read::low();
+      busDelay<Bus::accessCycles>();
+      blank &= Bus::DataHi::in() & Bus::DataLo::in();
+      Bus::Read::high();
+      Bus::Select::high();
+      busDelay<Bus::recoveryCycles>();
+    }
+    if (blank != 0xFF)
+      return false;
+
+    address += run;
+    words -= run;
+  }
+  return true;
+}
+
+// Drive a 16 bit address onto two ports
+template<class Bus>
+static inline void busAddress16(uint16_t address) __attribute__((always_inline));
+template<class Bus>
+static inline void busAddress16(uint16_t address) {
+  Bus::AddrLo::out(address & 0xFF);
+  Bus::AddrHi::out(address >> 8);
+}
+
+#endif /* BUSACCESS_H_ */
@@ -329,54 +329,70 @@ void printDataLine_COL(void* entry) {
   println_Msg(F("KB"));
 }
 
+// CRC32 of the first 512 bytes of the cart, the fingerprint in field 1 of colv.txt
+uint32_t crc512_COL() {
+  // RESET ALL CS PINS HIGH (DISABLE)
+  PORTH |= (1 << 3) | (1 << 4) | (1 << 5) | (1 << 6);
+  for (uint16_t w = 0; w < 512; w++) {
+    sdBuffer[w] = readData_COL(0x8000 + w);
+  }
+  return calculateCRC(sdBuffer, 512);
+}
+
 void setCart_COL() {
   //go to root
   sd.chdir();
 
   struct database_entry_COL entry;
+  boolean selected;
 
-  // Select starting letter
-  byte myLetter = starting_letter();
+  // Known carts are identified by their first 512 bytes, the others are selected from the list
+  if (findFingerprint(myFile, "colv.txt", 1, crc512_COL())) {
+    autoCartSelection(myFile, &readDataLine_COL, &entry, &printDataLine_COL);
+    selected = true;
+  } else {
+    // Select starting letter
+    byte myLetter = starting_letter();
 
-  // Open database
-  if (myFile.open("colv.txt", O_READ)) {
+    // Open database
+    if (!myFile.open("colv.txt", O_READ))
+      print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
     seek_first_letter_in_database(myFile, myLetter);
+    selected = checkCartSelection(myFile, &readDataLine_COL, &entry, &printDataLine_COL);
+  }
 
-    if (checkCartSelection(myFile, &readDataLine_COL, &entry, &printDataLine_COL)) {
-      //byte COL[] = {8, 12, 16, 20, 24, 32};
-      switch (entry.gameSize) {
-        case 8:
-          colsize = 0;
-          break;
+  if (selected) {
+    //byte COL[] = {8, 12, 16, 20, 24, 32};
+    switch (entry.gameSize) {
+      case 8:
+        colsize = 0;
+        break;
 
-        case 12:
-          colsize = 1;
-          break;
+      case 12:
+        colsize = 1;
+        break;
 
-        case 16:
-          colsize = 2;
-          break;
+      case 16:
+        colsize = 2;
+        break;
 
-        case 20:
-          colsize = 3;
-          break;
+      case 20:
+        colsize = 3;
+        break;
 
-        case 24:
-          colsize = 4;
-          break;
+      case 24:
+        colsize = 4;
+        break;
 
-        case 32:
-          colsize = 5;
-          break;
+      case 32:
+        colsize = 5;
+        break;
 
-        default:
-          colsize = 0;
-          break;
-      }
-      EEPROM_writeAnything(8, colsize);
+      default:
+        colsize = 0;
+        break;
     }
-  } else {
-    print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
+    EEPROM_writeAnything(8, colsize);
   }
 }
 #endif
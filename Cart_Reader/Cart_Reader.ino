@@ -63,9 +63,17 @@
    Libraries
  *****************************************/
 
-// SD Card
+// SD Card, SdFat clamps the requested clock to the fastest the Mega supports (F_CPU/2)
+#ifdef OPTION_SD_DEDICATED_SPI
+#define SD_CONFIG SdSpiConfig(SS, DEDICATED_SPI, SD_SCK_MHZ(50))
+#else
+#define SD_CONFIG SdSpiConfig(SS, SHARED_SPI, SD_SCK_MHZ(50))
+#endif
 SdFs sd;
-FsFile myFile;
+#ifdef OPTION_WARM_RESTART
+#include <setjmp.h>
+#endif
+DumpFile myFile;
 #ifdef ENABLE_GLOBAL_LOG
 FsFile myLog;
 bool dont_log = false;
@@ -119,6 +127,10 @@ typedef enum COLOR_T {
 #include <U8g2lib.h>
 U8G2_SSD1306_128X64_NONAME_F_HW_I2C display(U8G2_R0, /* reset=*/U8X8_PIN_NONE);
 #endif
+#if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
+// Tile row CRCs in display_Flush()
+#include <util/crc16.h>
+#endif
 
 // Adafruit Clock Generator
 #include <si5351.h>
@@ -140,6 +152,59 @@ void _print_FatalError(void) __attribute__((noreturn));
 void print_FatalError(const __FlashStringHelper* errorMessage) __attribute__((noreturn));
 void print_FatalError(byte errorMessage) __attribute__((noreturn));
 
+// Block accessors for writeVerifySave(), offsets are relative to the start of the save file
+typedef void (*saveWriter_t)(uint32_t offset, const byte* data, uint16_t length);
+typedef void (*saveReader_t)(uint32_t offset, byte* data, uint16_t length);
+
+// Block reader for probeRomSize(), address is relative to the start of the ROM
+typedef void (*probeReader_t)(uint32_t address, byte* data, uint16_t length);
+
+// Compiled databases (.odb) made by tools/oscr_dbc, see there for the file layout
+#define DB_HEADER_SIZE 32
+#define DB_MAX_FIELDS 8
+#define DB_MAX_RECORD 64
+// Records start with the offset of their entry in the .txt and of their name in the pool
+#define DB_FIELDS_START 8
+#define DB_FIELD_HEX32 1
+#define DB_FIELD_BYTES 2
+
+struct DbInfo {
+  uint16_t recordSize;
+  uint32_t recordCount;
+  uint32_t recordsOffset;
+  uint32_t poolOffset;
+  uint8_t fieldCount;
+  uint8_t fieldType[DB_MAX_FIELDS];
+  uint8_t fieldSize[DB_MAX_FIELDS];
+  uint8_t fieldOffset[DB_MAX_FIELDS];
+};
+
+// Lengths of fileName and folder
+#define FILENAME_LENGTH 100
+#define FOLDER_LENGTH 38
+
+// Job profiles from config.txt like "n64.job=rom,save,verify,summary", see jobLoad()
+#define JOB_MAX_STEPS 8
+
+enum JOB_STEP : uint8_t {
+  JOB_ROM,
+  JOB_SAVE,
+  JOB_VERIFY,
+  JOB_SUMMARY,
+  JOB_STEP_MAX
+};
+
+struct JobState {
+  uint8_t count;
+  JOB_STEP step[JOB_MAX_STEPS];
+  // Where the ROM step left its dump, the save step changes folder and fileName
+  char romFolder[FOLDER_LENGTH];
+  char romFile[FILENAME_LENGTH];
+  uint32_t romCrc;
+  bool romDumped;
+  bool romVerified;
+};
+
 /******************************************
   End of inclusions and forward declarations
  *****************************************/
@@ -272,7 +337,6 @@ char menuOptions[7][20];
 boolean ignoreError = 0;
 
 // File browser
-#define FILENAME_LENGTH 100
 #define FILEPATH_LENGTH 132
 #define FILEOPTS_LENGTH 20
 
@@ -315,14 +379,44 @@ CORES mode = CORE_MAX;
 //remember folder number to create a new folder for every game
 int foldern;
 // 4 chars for console type, 4 chars for SAVE/ROM, 21 chars for ROM name, 4 chars for folder number, 3 chars for slashes, one char for termination, one char savety
-char folder[38];
+char folder[FOLDER_LENGTH];
 
 // Array that holds the data
 byte sdBuffer[512];
 
 // soft reset Arduino: jumps to 0
 // using the watchdog timer would be more elegant but some Mega2560 bootloaders are buggy with it
-void (*resetArduino)(void) __attribute__((noreturn)) = 0;
+void (*rebootArduino)(void) __attribute__((noreturn)) = 0;
+#ifdef OPTION_WARM_RESTART
+// Back to the main menu without rebooting, see warmRestart()
+jmp_buf warmRestartPoint;
+bool warmRestartArmed = false;
+void resetArduino() __attribute__((noreturn));
+#else
+#define resetArduino rebootArduino
+#endif
+
+// Time every startup step took, see bootStep()
+#ifdef OPTION_BOOT_TIMING
+#define BOOT_STEPS 5
+const __FlashStringHelper* bootStepName[BOOT_STEPS];
+uint16_t bootStepTime[BOOT_STEPS];
+uint8_t bootSteps = 0;
+#define BOOT_STEP(name) bootStep(F(name))
+#else
+#define BOOT_STEP(name)
+#endif
+
+#ifdef OPTION_REMOTE
+// Menu entry or button press requested over the serial port, taken by the next input loop
+#define REMOTE_NONE 0xFF
+#define REMOTE_PRESS 0xFE
+uint8_t remoteInput = REMOTE_NONE;
+// Menu shown by question_box(), DUMP and SAVE look for their entry in it
+const __FlashStringHelper* remoteMenuTitle = NULL;
+char (*remoteMenuAnswers)[20] = NULL;
+uint8_t remoteMenuCount = 0;
+#endif
 
 // Progressbar
 void draw_progressbar(uint32_t processedsize, uint32_t totalsize);
@@ -418,6 +512,372 @@ uint32_t calculateCRC(const byte* buffer, size_t length) {
   return ~crc;
 }
 
+/******************************************
+  Save restore
+ *****************************************/
+// Writes length bytes from the open myFile to the cart, reading every block back
+// right after it was written so the file is only read once. Bytes the reader
+// leaves untouched count as verified, which lets a core skip file padding.
+// Returns the number of bytes that did not verify.
+unsigned long writeVerifySave(uint32_t length, saveWriter_t writeBlock, saveReader_t readBlock) {
+  ScratchBuffer readBack(512);
+  uint32_t crc = 0xFFFFFFFF;
+  unsigned long errors = 0;
+
+  for (uint32_t offset = 0; offset < length; offset += 512) {
+    uint16_t blockSize = (length - offset < 512) ? (length - offset) : 512;
+
+    // Blink led
+    if (offset % 16384 == 0)
+      blinkLED();
+
+    myFile.read(sdBuffer, blockSize);
+    crc = updateCRC(sdBuffer, blockSize, crc);
+
+    writeBlock(offset, sdBuffer, blockSize);
+    memcpy(readBack, sdBuffer, blockSize);
+    readBlock(offset, readBack, blockSize);
+
+    for (uint16_t c = 0; c < blockSize; c++) {
+      if (readBack[c] != sdBuffer[c]) {
+        // Report the first bad address right away
+        if (errors == 0) {
+          print_Msg(F("First error at "));
+          print_Msg_PaddedHex32(offset + c);
+          println_Msg(FS(FSTRING_EMPTY));
+          display_Update();
+        }
+        errors++;
+      }
+    }
+  }
+
+  print_Msg(F("CRC32: "));
+  print_Msg_PaddedHex32(~crc);
+  println_Msg(FS(FSTRING_EMPTY));
+  display_Update();
+
+  return errors;
+}
+
+/******************************************
+  ROM size probe
+ *****************************************/
+// True if the block read at address is open bus: every byte the same, or every
+// big-endian word equal to the low half of its own address like on the N64
+boolean isOpenBus(const byte* buffer, uint16_t length, uint32_t address) {
+  boolean uniform = true;
+  boolean addressPattern = true;
+
+  for (uint16_t c = 0; c < length; c++) {
+    uniform = uniform && (buffer[c] == buffer[0]);
+    word own = (address + (c & ~1)) & 0xFFFF;
+    addressPattern = addressPattern && (buffer[c] == ((c & 1) ? (own & 0xFF) : (own >> 8)));
+  }
+  return uniform || addressPattern;
+}
+
+// CRC32 of the 512 byte block at address, sets openBus if it is not driven by the cart
+uint32_t probeBlock(probeReader_t readBlock, uint32_t address, boolean* openBus) {
+  readBlock(address, sdBuffer, 512);
+  *openBus = isOpenBus(sdBuffer, 512, address);
+  return calculateCRC(sdBuffer, 512);
+}
+
+// Finds the real size of a ROM between minSize and maxSize, both powers of two.
+// A ROM of a given size either mirrors itself or reads as open bus right after its end,
+// so the blocks at the start and the middle are compared with the same blocks one size further.
+uint32_t probeRomSize(probeReader_t readBlock, uint32_t minSize, uint32_t maxSize) {
+  boolean openBus, openBusHalf;
+  uint32_t first = probeBlock(readBlock, 0, &openBus);
+  uint32_t half = probeBlock(readBlock, minSize / 2, &openBus);
+
+  for (uint32_t size = minSize; size < maxSize; size <<= 1) {
+    uint32_t next = probeBlock(readBlock, size, &openBus);
+    uint32_t nextHalf = probeBlock(readBlock, size + size / 2, &openBusHalf);
+
+    if (((next == first) && (nextHalf == half)) || (openBus && openBusHalf))
+      return size;
+    half = next;
+  }
+  return maxSize;
+}
+
+// Formats a size in MB if possible, in KB otherwise
+void formatRomSize(char* str, uint32_t size) {
+  if ((size >= 0x100000) && ((size & 0xFFFFF) == 0))
+    sprintf(str, "%luMB", size >> 20);
+  else
+    sprintf(str, "%luKB", size >> 10);
+}
+
+// Lets the user choose if the probed size disagrees with the database, returns the size to dump
+uint32_t confirmRomSize(uint32_t detected, uint32_t expected) {
+  char sizeStr[12];
+
+  if (expected == 0)
+    return detected;
+  // A ROM that is no power of two in size ends at the next power of two
+  if ((detected == expected) || ((expected & (expected - 1)) && (detected > expected) && (detected < expected * 2)))
+    return expected;
+
+  formatRomSize(sizeStr, detected);
+  sprintf(menuOptions[0], "Detected %s", sizeStr);
+  formatRomSize(sizeStr, expected);
+  sprintf(menuOptions[1], "Database %s", sizeStr);
+  if (question_box(F("ROM size mismatch"), menuOptions, 2, 1) == 0)
+    return detected;
+  return expected;
+}
+
+#ifdef OPTION_CONTACT_CHECK
+/******************************************
+  Contact check
+ *****************************************/
+#define CONTACT_SAMPLES 32
+#define CONTACT_REPEATS 8
+
+// One bus word read through a probe reader, 16 bit buses are stored big-endian like in probeBlock_N64()
+word contactRead(probeReader_t readBlock, uint32_t address, uint8_t width) {
+  byte data[2];
+  readBlock(address, data, width);
+  return (width == 2) ? ((data[0] << 8) | data[1]) : data[0];
+}
+
+// Reads a word CONTACT_REPEATS times and returns the value seen most often, and in agree how often
+word contactSample(probeReader_t readBlock, uint32_t address, uint8_t width, word* values, uint8_t* agree) {
+  uint8_t bestCount = 0;
+  word best = 0;
+
+  for (uint8_t r = 0; r < CONTACT_REPEATS; r++) {
+    values[r] = contactRead(readBlock, address, width);
+  }
+  for (uint8_t r = 0; r < CONTACT_REPEATS; r++) {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < CONTACT_REPEATS; i++) {
+      if (values[i] == values[r])
+        count++;
+    }
+    if (count > bestCount) {
+      bestCount = count;
+      best = values[r];
+    }
+  }
+  *agree = bestCount;
+  return best;
+}
+
+// Counts every bit of a bad read that differs from the good value against its data line
+void contactTallyData(uint16_t* dataErrors, word diff) {
+  for (uint8_t b = 0; b < 16; b++) {
+    if (diff & (1 << b))
+      dataErrors[b]++;
+  }
+}
+
+// Reads words spread over the ROM several times each, and the same words with every address line flipped.
+// A read that differs from the others is an intermittent contact: if it returned the value of the word one
+// address line away that line is blamed, otherwise the data lines that flipped. The same goes the other way,
+// a differing word one line away that sometimes reads as the sample. Lines above the ROM size that the cart
+// mirrors on are ignored. Address lines are the bits of the reader's byte address. Returns true if every
+// line was stable.
+boolean contactCheck(probeReader_t readBlock, uint32_t romSize, uint8_t addressBits, uint8_t dataBits) {
+  uint16_t addressErrors[32];
+  uint16_t dataErrors[16];
+  word values[CONTACT_REPEATS];
+  word neighbours[CONTACT_REPEATS];
+  uint8_t width = dataBits / 8;
+  uint8_t romBits = 0;
+  uint32_t seed = 0x2545F491;
+  char str[12];
+
+  memset(addressErrors, 0, sizeof(addressErrors));
+  memset(dataErrors, 0, sizeof(dataErrors));
+  while (((uint32_t)1 << romBits) < romSize)
+    romBits++;
+
+  display_Clear();
+  println_Msg(F("Checking contacts..."));
+  display_Update();
+
+  for (uint8_t s = 0; s < CONTACT_SAMPLES; s++) {
+    seed = seed * 1103515245 + 12345;
+    uint32_t address = ((seed >> 2) % romSize) & ~(uint32_t)(width - 1);
+    uint8_t agree;
+    word good = contactSample(readBlock, address, width, values, &agree);
+
+    // A0 selects the byte lane on a 16 bit bus, it is no address line
+    for (uint8_t k = width - 1; k < addressBits; k++) {
+      word neighbour = contactSample(readBlock, address ^ ((uint32_t)1 << k), width, neighbours, &agree);
+      uint8_t matches = 0;
+
+      // Mirror, or too unstable to tell what the neighbour really holds
+      if ((neighbour == good) || (agree <= CONTACT_REPEATS / 2))
+        continue;
+      for (uint8_t r = 0; r < CONTACT_REPEATS; r++) {
+        if (neighbours[r] == good)
+          matches++;
+        // Explained by this address line, don't count it against the data lines later
+        if (values[r] == neighbour) {
+          addressErrors[k]++;
+          values[r] = good;
+        }
+      }
+      // An open bus or unrelated neighbour never returns this exact word unless the line is loose
+      if (matches > 0)
+        addressErrors[k]++;
+    }
+
+    for (uint8_t r = 0; r < CONTACT_REPEATS; r++) {
+      if (values[r] != good)
+        contactTallyData(dataErrors, values[r] ^ good);
+    }
+  }
+
+  // Print the error count of every suspect line, four per row
+  uint8_t suspects = 0;
+  println_Msg(F("Unstable lines:"));
+  for (uint8_t line = 0; line < addressBits + dataBits; line++) {
+    uint16_t errors = (line < addressBits) ? addressErrors[line] : dataErrors[line - addressBits];
+    if (errors == 0)
+      continue;
+    if (line < addressBits)
+      sprintf(str, "A%u:%u ", line, errors);
+    else
+      sprintf(str, "D%u:%u ", line - addressBits, errors);
+    print_Msg(str);
+    if ((++suspects & 3) == 0)
+      println_Msg(FS(FSTRING_EMPTY));
+  }
+  if (suspects == 0)
+    println_Msg(F("none"));
+  else if (suspects & 3)
+    println_Msg(FS(FSTRING_EMPTY));
+  display_Update();
+  return (suspects == 0);
+}
+
+// Runs the contact check before a dump, on suspect lines the user can stop and clean the cart
+void checkContacts(probeReader_t readBlock, uint32_t romSize, uint8_t addressBits, uint8_t dataBits) {
+  if (contactCheck(readBlock, romSize, addressBits, dataBits))
+    return;
+
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+  strcpy_P(menuOptions[0], PSTR("Dump anyway"));
+  strcpy_P(menuOptions[1], PSTR("Cancel"));
+  if (question_box(F("Bad contacts found"), menuOptions, 2, 1) == 1)
+    print_FatalError(F("Clean cart contacts"));
+  display_Clear();
+}
+#endif
+
+#ifdef ENABLE_CONFIG
+/******************************************
+  Bus check
+ *****************************************/
+#define BUS_CHECK_BLOCK 64
+
+// Set from oscr.busCheck in config.txt
+boolean busCheckEnabled = false;
+
+// Walking-one address check with the cart in the slot. The block at base is read together with the block at
+// base with every single address line flipped. A line that makes no difference is stuck or open, two lines
+// that return the same block, which also shows up with both lines flipped, are shorted. Lines inside the block
+// are only checked if base is a known header: real data can repeat, a header's bytes only do so if a line
+// inside the block is stuck or shorted. Lines at or above romSize only mirror and blocks of a single byte value
+// say nothing, both are skipped. Returns a mask of the suspect address lines.
+uint32_t busCheck(probeReader_t readBlock, uint32_t base, uint32_t romSize, uint8_t dataBits, boolean header) {
+  byte block[BUS_CHECK_BLOCK];
+  uint32_t crcs[32];
+  uint32_t suspect = 0;
+  uint8_t romBits = 0;
+  uint8_t blockBits = 0;
+  // A0 selects the byte lane on a 16 bit bus, it is no address line
+  uint8_t firstLine = dataBits / 16;
+
+  while (((uint32_t)1 << romBits) < romSize)
+    romBits++;
+  while ((1 << blockBits) < BUS_CHECK_BLOCK)
+    blockBits++;
+
+  readBlock(base, block, BUS_CHECK_BLOCK);
+  if (isOpenBus(block, BUS_CHECK_BLOCK, base))
+    return 0;
+  uint32_t baseCrc = calculateCRC(block, BUS_CHECK_BLOCK);
+
+  for (uint8_t k = firstLine; header && (k < blockBits) && (k < romBits); k++) {
+    boolean stuck = true;
+    for (uint8_t c = 0; c < BUS_CHECK_BLOCK; c++) {
+      stuck = stuck && (block[c] == block[c ^ (1 << k)]);
+    }
+    if (stuck)
+      suspect |= (uint32_t)1 << k;
+
+    for (uint8_t j = firstLine; j < k; j++) {
+      boolean shorted = true;
+      for (uint8_t c = 0; c < BUS_CHECK_BLOCK; c++) {
+        if ((c & ((1 << j) | (1 << k))) == 0)
+          shorted = shorted && (block[c | (1 << j)] == block[c | (1 << k)]);
+      }
+      if (shorted)
+        suspect |= ((uint32_t)1 << j) | ((uint32_t)1 << k);
+    }
+  }
+
+  for (uint8_t k = blockBits; k < romBits; k++) {
+    uint32_t address = base ^ ((uint32_t)1 << k);
+    readBlock(address, block, BUS_CHECK_BLOCK);
+    // 0 marks a block that can't be told apart from others
+    crcs[k] = isOpenBus(block, BUS_CHECK_BLOCK, address) ? 0 : calculateCRC(block, BUS_CHECK_BLOCK);
+    if (crcs[k] == 0)
+      continue;
+    if (crcs[k] == baseCrc)
+      suspect |= (uint32_t)1 << k;
+    for (uint8_t j = blockBits; j < k; j++) {
+      if (crcs[j] != crcs[k])
+        continue;
+      // Shorted lines are both set whichever of them is driven, identical data elsewhere isn't repeated there too
+      address = base ^ ((uint32_t)1 << j) ^ ((uint32_t)1 << k);
+      readBlock(address, block, BUS_CHECK_BLOCK);
+      if (calculateCRC(block, BUS_CHECK_BLOCK) == crcs[k])
+        suspect |= ((uint32_t)1 << j) | ((uint32_t)1 << k);
+    }
+  }
+  return suspect;
+}
+
+// Runs the bus check before a dump if enabled with oscr.busCheck=1, on suspect lines the user can stop and reseat the cart
+void checkBus(probeReader_t readBlock, uint32_t base, uint32_t romSize, uint8_t dataBits, boolean header) {
+  char str[5];
+
+  if (!busCheckEnabled)
+    return;
+  uint32_t suspect = busCheck(readBlock, base, romSize, dataBits, header);
+  if (suspect == 0)
+    return;
+
+  display_Clear();
+  println_Msg(F("Stuck or shorted:"));
+  for (uint8_t k = 0; k < 32; k++) {
+    if (suspect & ((uint32_t)1 << k)) {
+      sprintf(str, "A%u ", k);
+      print_Msg(str);
+    }
+  }
+  println_Msg(FS(FSTRING_EMPTY));
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+  strcpy_P(menuOptions[0], PSTR("Dump anyway"));
+  strcpy_P(menuOptions[1], PSTR("Cancel"));
+  if (question_box(F("Bus check failed"), menuOptions, 2, 1) == 1)
+    print_FatalError(F("Reseat the cart"));
+  display_Clear();
+}
+#endif
+
 uint32_t calculateCRC(FsFile& infile) {
   uint32_t byte_count;
   uint32_t crc = 0xFFFFFFFF;
@@ -544,9 +1004,136 @@ void rewind_line(FsFile& readfile, byte count = 1) {
     readfile.seekCur(1);
 }
 
+//******************************************
+// Functions for compiled databases
+//******************************************
+// Opens the .odb built by tools/oscr_dbc from txtName, fails if there is none or
+// if it was built from a different version of the .txt: the size differs or the
+// .txt was changed after the .odb
+boolean dbOpen(FsFile& db, const char* txtName, DbInfo* info) {
+  char odbName[24];
+  byte header[DB_HEADER_SIZE];
+  uint32_t txtSize;
+  uint16_t date;
+  uint16_t time;
+  uint32_t txtModified = 0;
+  uint32_t odbModified = 0;
+  uint16_t offset = DB_FIELDS_START;
+
+  const char* ext = strrchr(txtName, '.');
+  if ((ext == NULL) || ((size_t)(ext - txtName) + 5 > sizeof(odbName)))
+    return false;
+  memcpy(odbName, txtName, ext - txtName);
+  strcpy(odbName + (ext - txtName), ".odb");
+
+  if (!db.open(txtName, O_READ))
+    return false;
+  txtSize = db.fileSize();
+  if (db.getModifyDateTime(&date, &time))
+    txtModified = ((uint32_t)date << 16) | time;
+  db.close();
+
+  if (!db.open(odbName, O_READ))
+    return false;
+  if (db.getModifyDateTime(&date, &time))
+    odbModified = ((uint32_t)date << 16) | time;
+  if (txtModified > odbModified) {
+    db.close();
+    return false;
+  }
+
+  if ((db.read(header, sizeof(header)) != sizeof(header)) || (memcmp(header, "ODB1", 4) != 0) || (header[4] != 1) || (header[5] > DB_MAX_FIELDS)) {
+    db.close();
+    return false;
+  }
+  info->fieldCount = header[5];
+  memcpy(&info->recordSize, header + 6, 2);
+  memcpy(&info->recordCount, header + 8, 4);
+  memcpy(&info->recordsOffset, header + 12, 4);
+  memcpy(&info->poolOffset, header + 16, 4);
+  if ((info->recordSize > DB_MAX_RECORD) || (memcmp(&txtSize, header + 24, 4) != 0)) {
+    db.close();
+    return false;
+  }
+
+  for (uint8_t i = 0; i < info->fieldCount; i++) {
+    info->fieldType[i] = db.read();
+    info->fieldSize[i] = db.read();
+    info->fieldOffset[i] = offset;
+    offset += info->fieldSize[i];
+  }
+  db.seekSet(info->recordsOffset);
+  return true;
+}
+
+// Reads the next record, returns false at the end of the records
+boolean dbNext(FsFile& db, const DbInfo& info, byte* record) {
+  if (db.curPosition() >= info.poolOffset)
+    return false;
+  return (db.read(record, info.recordSize) == info.recordSize);
+}
+
+// Skips ahead to the next record whose field equals value, which must be of the field's size
+boolean dbFind(FsFile& db, const DbInfo& info, uint8_t field, const void* value, byte* record) {
+  if ((field >= info.fieldCount) || (info.fieldType[field] != DB_FIELD_HEX32 && info.fieldType[field] != DB_FIELD_BYTES))
+    return false;
+  while (dbNext(db, info, record)) {
+    if (memcmp(record + info.fieldOffset[field], value, info.fieldSize[field]) == 0)
+      return true;
+  }
+  return false;
+}
+
+// Position of the record's entry in the .txt
+uint32_t dbTxtOffset(const byte* record) {
+  uint32_t offset;
+  memcpy(&offset, record, 4);
+  return offset;
+}
+
+// Copies the record's name from the string pool
+void dbName(FsFile& db, const DbInfo& info, const byte* record, char* name, uint8_t size) {
+  uint32_t position = db.curPosition();
+  uint32_t nameOffset;
+
+  memcpy(&nameOffset, record + 4, 4);
+  db.seekSet(info.poolOffset + nameOffset);
+  int read_len = db.read(name, size - 1);
+  name[(read_len > 0) ? read_len : 0] = 0;
+  db.seekSet(position);
+}
+
+#ifdef OPTION_HASH
+// Set by a dump loop that fed the hashes itself, compareCRC() then doesn't read the file again for them
+boolean dumpHashed = false;
+#endif
+
+// Kept out of line, compareCRC() only stores the dump after it returned
+boolean lookupCRC(const char* database, uint32_t crc32sum, boolean renamerom, int offset, char* gamename, uint32_t* crcOut) __attribute__((noinline));
+
 // Calculate CRC32 if needed and compare it to CRC read from database
 boolean compareCRC(const char* database, uint32_t crc32sum, boolean renamerom, int offset) {
+#ifdef ENABLE_COMPARE
+  if (compareState == COMPARE_DONE) {
+    // Nothing was saved, the compare report took the place of the CRC32 check
+    return (compareDiffBytes == 0);
+  }
+#endif
+  ScratchBuffer nameBuffer(96);
+  char* gamename = (char*)(uint8_t*)nameBuffer;
+  uint32_t crc;
+  boolean found = lookupCRC(database, crc32sum, renamerom, offset, gamename, &crc);
+
+  // Not called from lookupCRC(), so its buffers are off the stack while the dump is stored
+  finishDump((found && renamerom) ? gamename : fileName, crc);
+  return found;
+}
+
+// Does the work of compareCRC(), gamename gets the database name and crcOut the CRC32 of the dump
+boolean lookupCRC(const char* database, uint32_t crc32sum, boolean renamerom, int offset, char* gamename, uint32_t* crcOut) {
   char crcStr[9];
+  uint32_t crc;
+
   print_Msg(F("CRC32... "));
   display_Update();
 
@@ -554,31 +1141,60 @@ boolean compareCRC(const char* database, uint32_t crc32sum, boolean renamerom, i
     //go to root
     sd.chdir();
     // Calculate CRC32
-    sprintf(crcStr, "%08lX", calculateCRC(fileName, folder, offset));
+#ifdef OPTION_HASH
+    crc = hashDump(offset);
+    dumpHashed = false;
+#else
+    crc = calculateCRC(fileName, folder, offset);
+#endif
   } else {
-    // Convert precalculated crc to string
-    sprintf(crcStr, "%08lX", ~crc32sum);
+    // Convert precalculated crc
+    crc = ~crc32sum;
+#ifdef OPTION_HASH
+    // Unless the dump loop fed them, the file still has to be read once for the hashes
+    if (!dumpHashed)
+      hashDump(offset);
+    dumpHashed = false;
+#endif
   }
+  *crcOut = crc;
+  sprintf(crcStr, "%08lX", crc);
   // Print checksum
   print_Msg(crcStr);
   display_Update();
 
   //Search for CRC32 in file
-  char gamename[96];
   char crc_search[9];
+  boolean found = false;
+  DbInfo info;
 
   //go to root
   sd.chdir();
-  if (myFile.open(database, O_READ)) {
+  if (dbOpen(myFile, database, &info)) {
+    // Compiled database, compare the CRC32 field of every record
+    ScratchBuffer record(DB_MAX_RECORD);
+    if (dbFind(myFile, info, 0, &crc, record)) {
+      found = true;
+      dbName(myFile, info, record, gamename, 96);
+#ifdef ENABLE_NES
+      if ((mode == CORE_NES) && (offset != 0) && (info.fieldCount > 2) && (info.fieldSize[2] == 16)) {
+        memcpy(iNES_HEADER, record + info.fieldOffset[2], 16);
+      }
+#endif  // ENABLE_NES
+    }
+    // Close the file:
+    myFile.close();
+  } else if (myFile.open(database, O_READ)) {
     //Search for same CRC in list
     while (myFile.available()) {
       //Read 2 lines (game name and CRC)
-      get_line(gamename, &myFile, sizeof(gamename));
+      get_line(gamename, &myFile, 96);
       get_line(crc_search, &myFile, sizeof(crc_search));
       skip_line(&myFile);  //Skip every 3rd line
 
-      //if checksum search successful, rename the file and end search
+      //if checksum search successful, end search
       if (strcmp(crc_search, crcStr) == 0) {
+        found = true;
 
 #ifdef ENABLE_NES
         if ((mode == CORE_NES) && (offset != 0)) {
@@ -599,76 +1215,587 @@ boolean compareCRC(const char* database, uint32_t crc32sum, boolean renamerom, i
           myFile.seekCur(4);
         }
 #endif  // ENABLE_NES
+        break;
+      }
+    }
+    // Close the file:
+    myFile.close();
+  } else {
+    println_Msg(F(" -> Error"));
+    print_Error(F("Database missing"));
+    return 0;
+  }
 
-        // Close the file:
-        myFile.close();
+  if (!found) {
+#ifdef OPTION_REMOTE
+    remoteCrc(crc, NULL);
+#endif
+    print_Error(F(" -> Not found"));
+    return 0;
+  }
+#ifdef OPTION_REMOTE
+  remoteCrc(crc, gamename);
+#endif
 
-        //Write iNES header
+  //Write iNES header
 #ifdef ENABLE_NES
-        if ((mode == CORE_NES) && (offset != 0)) {
-          // Write iNES header
-          sd.chdir(folder);
-          if (!myFile.open(fileName, O_RDWR)) {
-            print_FatalError(sd_error_STR);
-          }
-          for (byte z = 0; z < 16; z++) {
-            myFile.write(iNES_HEADER[z]);
-          }
-          myFile.close();
-        }
+  if ((mode == CORE_NES) && (offset != 0)) {
+    // Write iNES header
+    sd.chdir(folder);
+    if (!myFile.open(fileName, O_RDWR)) {
+      print_FatalError(sd_error_STR);
+    }
+    for (byte z = 0; z < 16; z++) {
+      myFile.write(iNES_HEADER[z]);
+    }
+    myFile.close();
+  }
 #endif  // ENABLE_NES
-        print_Msg(F(" -> "));
-        display_Update();
+  print_Msg(F(" -> "));
+  display_Update();
+
+  if (renamerom) {
+    println_Msg(gamename);
+
+    // Rename file to database name
+    sd.chdir(folder);
+    delay(100);
+    if (myFile.open(fileName, O_READ)) {
+      myFile.rename(gamename);
+      // Close the file:
+      myFile.close();
+    }
+  } else {
+    println_Msg(FS(FSTRING_OK));
+  }
+  return 1;
+}
+
+#ifdef OPTION_DEDUPE_STORE
+// Set when the last dump was a duplicate and its folder was removed, save_log() has nowhere to write to
+boolean dumpDeduped = false;
+#endif
+
+// Stores a dump after its CRC32 was checked: a duplicate is removed, the hashes of a new dump are saved next to it
+void finishDump(const char* name, uint32_t crc) {
+#ifdef OPTION_DEDUPE_STORE
+  if (dedupeStore(name, crc)) {
+    dumpDeduped = true;
+    return;
+  }
+#endif
+#ifdef OPTION_HASH
+  saveDumpHashes(name);
+#endif
+}
+
+#ifdef ENABLE_CONFIG
+/******************************************
+  Job profiles
+ *****************************************/
+static const char JobStepRom[] PROGMEM = "rom";
+static const char JobStepSave[] PROGMEM = "save";
+static const char JobStepVerify[] PROGMEM = "verify";
+static const char JobStepSummary[] PROGMEM = "summary";
+static const char* const jobStepNames[] PROGMEM = { JobStepRom, JobStepSave, JobStepVerify, JobStepSummary };
+
+// Parses the comma separated steps of a job from config.txt, returns false if the key is missing or invalid
+boolean jobLoad(const __FlashStringHelper* key, JobState* job) {
+  String steps = configGetStr(key);
+  int start = 0;
+
+  memset(job, 0, sizeof(JobState));
+  while (start < (int)steps.length()) {
+    int end = steps.indexOf(',', start);
+    if (end < 0) end = steps.length();
+    String name = steps.substring(start, end);
+    name.trim();
+    start = end + 1;
+    if (name.length() == 0) continue;
+
+    uint8_t i = 0;
+    while ((i < JOB_STEP_MAX) && (strcmp_P(name.c_str(), (char*)pgm_read_word(&(jobStepNames[i]))) != 0)) i++;
+    if ((i == JOB_STEP_MAX) || (job->count == JOB_MAX_STEPS))
+      return false;
+    job->step[job->count++] = (JOB_STEP)i;
+  }
+  return (job->count > 0);
+}
+
+// Forgets the results of the last run, the steps stay
+void jobStart(JobState* job) {
+  job->romCrc = 0;
+  job->romDumped = false;
+  job->romVerified = false;
+}
+
+// Remembers the dump of the ROM step for the verify and summary steps
+void jobSaveRom(JobState* job, uint32_t crc) {
+  strlcpy(job->romFolder, folder, sizeof(job->romFolder));
+  strlcpy(job->romFile, fileName, sizeof(job->romFile));
+  job->romCrc = crc;
+  job->romDumped = true;
+}
+
+// Points folder and fileName back to the dump of the ROM step
+void jobRestoreRom(const JobState* job) {
+  strlcpy(folder, job->romFolder, sizeof(folder));
+  strlcpy(fileName, job->romFile, sizeof(fileName));
+  sd.chdir("/");
+}
+
+// Prints what the job did and copies the log of the whole job next to the ROM
+void jobSummary(const JobState* job, const __FlashStringHelper* saveName) {
+  println_Msg(FS(FSTRING_EMPTY));
+  println_Msg(F("Job summary"));
+  print_Msg(F("Game: "));
+  println_Msg(romName);
+  print_Msg(F("ROM: "));
+  if (!job->romDumped) {
+    println_Msg(F("skipped"));
+  } else if (job->romVerified) {
+    println_Msg(FS(FSTRING_OK));
+  } else {
+    println_Msg(F("not verified"));
+  }
+  print_Msg(F("Save: "));
+  println_Msg(saveName);
+  display_Update();
+#ifdef ENABLE_GLOBAL_LOG
+  if (job->romDumped) {
+    jobRestoreRom(job);
+    save_log();
+  }
+#endif
+}
+#endif /* ENABLE_CONFIG */
+
+#ifdef OPTION_HASH
+/******************************************
+  Dump hashes
+ *****************************************/
+// Digests of the last dump as hex strings
+#ifdef OPTION_HASH_SHA1
+char dumpSha1[SHA1_DIGEST_SIZE * 2 + 1];
+#endif
+#ifdef OPTION_HASH_MD5
+char dumpMd5[MD5_DIGEST_SIZE * 2 + 1];
+#endif
+
+void digestToHex(char* str, const uint8_t* digest, uint8_t size) {
+  for (uint8_t i = 0; i < size; i++) {
+    sprintf(str + i * 2, "%02x", digest[i]);
+  }
+}
+
+// Cores that calculate the CRC32 while dumping feed the hashes from the same loop:
+// dumpHashInit(), dumpHashUpdate() for every block written, dumpHashFinal() and dumpHashed = true
+void dumpHashInit(DumpHash* hash) {
+#ifdef OPTION_HASH_SHA1
+  sha1Init(&hash->sha1);
+#endif
+#ifdef OPTION_HASH_MD5
+  md5Init(&hash->md5);
+#endif
+}
+
+void dumpHashUpdate(DumpHash* hash, const byte* data, size_t length) {
+#ifdef OPTION_HASH_SHA1
+  sha1Update(&hash->sha1, data, length);
+#endif
+#ifdef OPTION_HASH_MD5
+  md5Update(&hash->md5, data, length);
+#endif
+}
+
+// Keeps the digests of the dump as hex strings and logs them
+void dumpHashFinal(DumpHash* hash) {
+  uint8_t digest[SHA1_DIGEST_SIZE];
+
+#ifdef OPTION_HASH_SHA1
+  sha1Final(&hash->sha1, digest);
+  digestToHex(dumpSha1, digest, SHA1_DIGEST_SIZE);
+#endif
+#ifdef OPTION_HASH_MD5
+  md5Final(&hash->md5, digest);
+  digestToHex(dumpMd5, digest, MD5_DIGEST_SIZE);
+#endif
+
+#ifdef ENABLE_GLOBAL_LOG
+  if (!dont_log && loggingEnabled) {
+#ifdef OPTION_HASH_SHA1
+    myLog.print(F("SHA-1: "));
+    myLog.println(dumpSha1);
+#endif
+#ifdef OPTION_HASH_MD5
+    myLog.print(F("MD5: "));
+    myLog.println(dumpMd5);
+#endif
+  }
+#endif
+}
+
+// Reads the dump fileName in folder once, calculating the enabled hashes in the same pass as the CRC32
+uint32_t hashDump(unsigned long offset) {
+  FsFile infile;
+  uint32_t byte_count;
+  uint32_t crc = 0xFFFFFFFF;
+  unsigned long startTime = millis();
+  DumpHash hash;
+
+  dumpHashInit(&hash);
+
+  sd.chdir(folder);
+  if (!infile.open(fileName, O_READ)) {
+    display_Clear();
+    print_Msg(F("File "));
+    print_FatalError(F(" not found"));
+  }
+  infile.seek(offset);
+  while ((byte_count = infile.read(sdBuffer, sizeof(sdBuffer))) != 0) {
+    crc = updateCRC(sdBuffer, byte_count, crc);
+    dumpHashUpdate(&hash, sdBuffer, byte_count);
+  }
+  infile.close();
+  dumpHashFinal(&hash);
+
+#ifdef ENABLE_GLOBAL_LOG
+  if (!dont_log && loggingEnabled) {
+    // Time for one pass with all hashes, compare with a build without them for the cost per system
+    myLog.print(F("Hashed in "));
+    myLog.print(millis() - startTime);
+    myLog.println(F(" ms"));
+  }
+#else
+  (void)startTime;
+#endif
+  return ~crc;
+}
+
+// Writes one line in sha1sum/md5sum format to name.extension in folder
+void writeHashFile(const char* name, const char* extension, const char* digest) {
+  char hashName[FILENAME_LENGTH + 6];
+  FsFile hashFile;
 
-        if (renamerom) {
-          println_Msg(gamename);
+  snprintf(hashName, sizeof(hashName), "%s.%s", name, extension);
+  sd.chdir(folder);
+  if (!hashFile.open(hashName, O_RDWR | O_CREAT | O_TRUNC)) {
+    print_FatalError(sd_error_STR);
+  }
+  hashFile.print(digest);
+  hashFile.print(F("  "));
+  hashFile.print(name);
+  hashFile.print(F("\r\n"));
+  hashFile.close();
+}
+
+// Saves the digests of the last dump next to it
+void saveDumpHashes(const char* name) {
+#ifdef OPTION_HASH_SHA1
+  writeHashFile(name, "sha1", dumpSha1);
+#endif
+#ifdef OPTION_HASH_MD5
+  writeHashFile(name, "md5", dumpMd5);
+#endif
+}
+#endif
+
+#ifdef OPTION_DEDUPE_STORE
+//******************************************
+// Dedupe store
+//******************************************
+// One line per file: CRC32,size,path of the stored copy[|path of a removed identical copy]
+#define DEDUPE_MANIFEST "/dedupe.txt"
+
+// Looks up the file just written to folder in the manifest. If an identical file is still on the card the new
+// copy and its folder are removed and recorded as a reference, otherwise the new file is added to the manifest.
+// The folder number of a removed folder is used again for the next dump. Returns true if the new copy was removed
+boolean dedupeStore(const char* name, uint32_t crc) {
+  FsFile manifest;
+  char line[FILENAME_LENGTH + 2 * sizeof(folder)];
+  char path[FILENAME_LENGTH + sizeof(folder)];
+  char entry[20];
+  uint32_t size = 0;
+  boolean found = false;
+
+  sd.chdir(folder);
+  if (myFile.open(name, O_READ)) {
+    size = myFile.fileSize();
+    myFile.close();
+  }
+  sd.chdir();
+  snprintf(path, sizeof(path), "/%s/%s", folder, name);
+  snprintf(entry, sizeof(entry), "%08lX,%lu,", crc, size);
+
+  if (!manifest.open(DEDUPE_MANIFEST, O_RDWR | O_CREAT)) {
+    print_FatalError(sd_error_STR);
+  }
+  while (manifest.available()) {
+    get_line(line, &manifest, sizeof(line));
+    if (strncmp(line, entry, strlen(entry)) == 0) {
+      // Cut off the reference
+      char* stored = line + strlen(entry);
+      char* reference = strchr(stored, '|');
+      if (reference)
+        *reference = 0;
+      if ((strcmp(stored, path) != 0) && sd.exists(stored)) {
+        found = true;
+        break;
+      }
+    }
+  }
+
+  manifest.seekEnd();
+  manifest.print(entry);
+  if (found) {
+    // Replace the new copy with a reference
+    manifest.print(line + strlen(entry));
+    manifest.print('|');
+    manifest.print(path);
+    sd.chdir(folder);
+    sd.remove(name);
+    sd.chdir();
+    if (sd.rmdir(folder)) {
+      // Give the folder number back if it was the last one handed out
+      const char* number = strrchr(folder, '/');
+      int eepFoldern;
+      EEPROM_readAnything(0, eepFoldern);
+      if (number && (atoi(number + 1) == foldern - 1) && (eepFoldern == foldern)) {
+        foldern = foldern - 1;
+        EEPROM_writeAnything(0, foldern);
+      }
+    }
+
+    print_Msg(F("Identical to "));
+    println_Msg(line + strlen(entry));
+  } else {
+    manifest.print(path);
+  }
+  manifest.print(F("\r\n"));
+  manifest.close();
+  display_Update();
+  return found;
+}
+
+// Calculates the CRC32 of a save that was just read and only keeps it if it differs from every stored file
+boolean dedupeSave() {
+  if (dedupeStore(fileName, calculateCRC(fileName, folder, 0))) {
+    println_Msg(F("Save unchanged, not kept"));
+    display_Update();
+    return true;
+  }
+  return false;
+}
+#endif
+
+//******************************************
+// Math Functions
+//******************************************
+#if (defined(ENABLE_NES) || defined(ENABLE_MSX) || defined(ENABLE_GBX) || defined(ENABLE_TRS80) || defined(ENABLE_JAGUAR))
+int int_pow(int base, int exp) {  // Power for int
+  int result = 1;
+  while (exp) {
+    if (exp & 1)
+      result *= base;
+    exp /= 2;
+    base *= base;
+  }
+  return result;
+}
+#endif
+
+#ifdef ENABLE_COMPARE
+/******************************************
+  Compare mode
+ *****************************************/
+COMPARE_STATE compareState = COMPARE_OFF;
+boolean compareStopEarly;
+// Reference file picked in compareMenu()
+char comparePath[FILEPATH_LENGTH];
+// Bytes compared, mismatching bytes and the first mismatch address
+uint32_t compareBytes;
+uint32_t compareDiffBytes;
+uint32_t compareFirstDiff;
+// Cart data written past the end of the reference
+uint32_t compareOverrun;
+// Mismatching 512 byte blocks, the first ones as ranges of block numbers
+uint32_t compareDiffBlocks;
+uint32_t compareRanges[COMPARE_MAX_RANGES][2];
+uint8_t compareRangeCount;
+
+// Main menu entry, the next ROM read of any core is compared against the selected file
+void compareMenu() {
+  fileBrowser(FS(FSTRING_SELECT_FILE));
+  if (filePath[1] == '\0')
+    snprintf(comparePath, sizeof(comparePath), "/%s", fileName);
+  else
+    snprintf(comparePath, sizeof(comparePath), "%s/%s", filePath, fileName);
+
+  strcpy_P(menuOptions[0], PSTR("Full report"));
+  strcpy_P(menuOptions[1], PSTR("Stop at mismatch"));
+  compareStopEarly = (question_box(F("Compare mode"), menuOptions, 2, 0) == 1);
+  compareState = COMPARE_ARMED;
+
+  display_Clear();
+  println_Msg(F("Compare to"));
+  println_Msg(comparePath);
+  println_Msg(FS(FSTRING_EMPTY));
+  println_Msg(F("Now read the ROM,"));
+  println_Msg(F("nothing is written"));
+  println_Msg(F("to the SD card."));
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+}
+
+bool DumpFile::open(const char* path, oflag_t oflag) {
+  // A new file means the compared dump has been dealt with
+  if ((compareState == COMPARE_DONE) && (oflag & O_CREAT))
+    compareState = COMPARE_OFF;
+  if ((compareState != COMPARE_ARMED) || !(oflag & O_CREAT))
+    return FsFile::open(path, oflag);
+
+  // The core is about to create its dump, open the reference instead
+  if (!FsFile::open(comparePath, O_RDONLY)) {
+    compareState = COMPARE_OFF;
+    print_FatalError(FS(FSTRING_FILE_DOESNT_EXIST));
+  }
+  compareBytes = 0;
+  compareDiffBytes = 0;
+  compareOverrun = 0;
+  compareDiffBlocks = 0;
+  compareRangeCount = 0;
+  compareState = COMPARE_ACTIVE;
+  return true;
+}
+
+// Records one mismatching byte and the block it is in
+void compareMismatch(uint32_t address) {
+  uint32_t block = address >> 9;
+
+  if (compareDiffBytes++ == 0)
+    compareFirstDiff = address;
+
+  if ((compareRangeCount > 0) && (block >= compareRanges[compareRangeCount - 1][0]) && (block <= compareRanges[compareRangeCount - 1][1]))
+    return;
+  compareDiffBlocks++;
+  if ((compareRangeCount > 0) && (block == compareRanges[compareRangeCount - 1][1] + 1)) {
+    compareRanges[compareRangeCount - 1][1] = block;
+  } else if (compareRangeCount < COMPARE_MAX_RANGES) {
+    compareRanges[compareRangeCount][0] = block;
+    compareRanges[compareRangeCount][1] = block;
+    compareRangeCount++;
+  }
+
+  if (compareStopEarly) {
+    myFile.close();
+    print_FatalError(F("Stopped at mismatch"));
+  }
+}
+
+size_t DumpFile::write(const uint8_t* buffer, size_t size) {
+  if (compareState != COMPARE_ACTIVE)
+    return FsFile::write(buffer, size);
+
+  // Compare in small pieces, the cores pass sdBuffer and friends so they can't be reused here
+  byte chunk[32];
+  size_t remaining = size;
+  while (remaining > 0) {
+    uint8_t length = (remaining < sizeof(chunk)) ? remaining : sizeof(chunk);
+    uint32_t address = curPosition() + compareOverrun;
+    int count = read(chunk, length);
+    if (count < 0)
+      count = 0;
+    if ((count != length) || (memcmp(chunk, buffer, length) != 0)) {
+      for (uint8_t i = 0; i < length; i++) {
+        if ((i >= count) || (chunk[i] != buffer[i]))
+          compareMismatch(address + i);
+      }
+      compareOverrun += length - count;
+    }
+    compareBytes += length;
+    buffer += length;
+    remaining -= length;
+  }
+  return size;
+}
+
+bool DumpFile::close() {
+  if (compareState != COMPARE_ACTIVE)
+    return FsFile::close();
+
+  uint32_t referenceSize = fileSize();
+  compareState = COMPARE_DONE;
+  FsFile::close();
+  compareReport(referenceSize);
+  return true;
+}
+
+void compareReport(uint32_t referenceSize) {
+  char str[24];
+  // Bytes never read from the cart count as mismatches too
+  uint32_t total = (compareBytes > referenceSize) ? compareBytes : referenceSize;
+  uint32_t matching = compareBytes - compareDiffBytes;
+  uint16_t hundredths = (total == 0) ? 0 : ((uint64_t)matching * 10000) / total;
+
+  display_Clear();
+  println_Msg(F("Compare result"));
+  sprintf(str, "Match %u.%02u%%", hundredths / 100, hundredths % 100);
+  println_Msg(str);
 
-          // Rename file to database name
-          sd.chdir(folder);
-          delay(100);
-          if (myFile.open(fileName, O_READ)) {
-            myFile.rename(gamename);
-            // Close the file:
-            myFile.close();
-          }
-        } else {
-          println_Msg(FS(FSTRING_OK));
-        }
-        return 1;
-        break;
+  if ((compareDiffBytes == 0) && (compareBytes == referenceSize)) {
+    println_Msg(F("Identical"));
+  } else {
+    if (compareDiffBytes > 0) {
+      sprintf(str, "First diff 0x%08lX", compareFirstDiff);
+      println_Msg(str);
+      sprintf(str, "%lu bad blocks:", compareDiffBlocks);
+      println_Msg(str);
+      for (uint8_t i = 0; i < compareRangeCount; i++) {
+        if (compareRanges[i][0] == compareRanges[i][1])
+          sprintf(str, " %lu", compareRanges[i][0]);
+        else
+          sprintf(str, " %lu-%lu", compareRanges[i][0], compareRanges[i][1]);
+        print_Msg(str);
       }
+      if (compareRangeCount == COMPARE_MAX_RANGES)
+        print_Msg(F(" ..."));
+      println_Msg(FS(FSTRING_EMPTY));
     }
-    if (strcmp(crc_search, crcStr) != 0) {
-      print_Error(F(" -> Not found"));
-      return 0;
+    if (compareBytes < referenceSize) {
+      sprintf(str, "%lu bytes not read", referenceSize - compareBytes);
+      println_Msg(str);
     }
-  } else {
-    println_Msg(F(" -> Error"));
-    print_Error(F("Database missing"));
-    return 0;
   }
-  return 0;
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
 }
+#endif
 
-//******************************************
-// Math Functions
-//******************************************
-#if (defined(ENABLE_NES) || defined(ENABLE_MSX) || defined(ENABLE_GBX) || defined(ENABLE_TRS80) || defined(ENABLE_JAGUAR))
-int int_pow(int base, int exp) {  // Power for int
-  int result = 1;
-  while (exp) {
-    if (exp & 1)
-      result *= base;
-    exp /= 2;
-    base *= base;
-  }
-  return result;
-}
+// False after a compare pass, the core's dump was never written to the SD card
+boolean dumpSaved() {
+#ifdef ENABLE_COMPARE
+  return (compareState != COMPARE_DONE);
+#else
+  return 1;
 #endif
+}
 
 void createFolder(const char* system, const char* subfolder, const char* gameName, const char* fileSuffix) {
   snprintf(fileName, FILENAME_LENGTH, "%s.%s", gameName, fileSuffix);
 
+#ifdef ENABLE_COMPARE
+  // Comparing leaves the SD card alone, a finished compare the core didn't check ends here
+  if (compareState == COMPARE_ARMED)
+    return;
+  if (compareState == COMPARE_DONE)
+    compareState = COMPARE_OFF;
+#endif
+#ifdef OPTION_DEDUPE_STORE
+  dumpDeduped = false;
+#endif
+
   // create a new folder for the rom file
   EEPROM_readAnything(0, foldern);
   if (subfolder == NULL) {
@@ -685,6 +1812,14 @@ void printAndIncrementFolder(bool displayClear = false) {
   if (displayClear) {
     display_Clear();
   }
+#ifdef ENABLE_COMPARE
+  if (compareState == COMPARE_ARMED) {
+    print_Msg(F("Comparing to "));
+    println_Msg(comparePath);
+    display_Update();
+    return;
+  }
+#endif
   print_STR(saving_to_STR, 0);
   print_Msg(folder);
   println_Msg(F("/..."));
@@ -773,12 +1908,97 @@ void readDataLineMapperSize(FsFile& database, void* entry) {
 }
 #endif
 
+// Positions database at the start of the entry whose data line has crc, the CRC32 of the first bytes of the cart, in the given field.
+// Lets a core identify the cart before dumping instead of making the user select it. Uses the compiled database if there is one
+// returns true if the cart was found, the database is closed otherwise
+boolean findFingerprint(FsFile& database, const char* databaseName, uint8_t field, uint32_t crc) {
+  FsFile compiled;
+  DbInfo info;
+
+  if (dbOpen(compiled, databaseName, &info)) {
+    byte record[DB_MAX_RECORD];
+    boolean found = dbFind(compiled, info, field, &crc, record);
+    compiled.close();
+    if (!found || !database.open(databaseName, O_READ))
+      return false;
+    // Go to start of entry
+    database.seekSet(dbTxtOffset(record));
+    return true;
+  }
+
+  if (!database.open(databaseName, O_READ))
+    return false;
+
+  char crcStr[9];
+  char dataLine[64];
+  sprintf(crcStr, "%08lX", crc);
+#ifdef ENABLE_GLOBAL_LOG
+  // Disable log to prevent unnecessary logging
+  dont_log = true;
+#endif
+  while (database.available()) {
+    uint32_t entryStart = database.curPosition();
+    // Skip name, read data line and skip empty line
+    skip_line(&database);
+    get_line(dataLine, &database, sizeof(dataLine));
+    skip_line(&database);
+
+    char* value = dataLine;
+    for (uint8_t i = 0; (i < field) && value; i++) {
+      value = strchr(value, ',');
+      if (value)
+        value++;
+    }
+    if (value && (strncmp(value, crcStr, 8) == 0)) {
+      database.seekSet(entryStart);
+#ifdef ENABLE_GLOBAL_LOG
+      dont_log = false;
+#endif
+      return true;
+    }
+  }
+#ifdef ENABLE_GLOBAL_LOG
+  // Enable log again
+  dont_log = false;
+#endif
+  database.close();
+  return false;
+}
+
+// Reads the entry found by findFingerprint and shows it instead of the cart selection
+// Same callbacks as checkCartSelection, closes the database
+void autoCartSelection(FsFile& database, void (*readData)(FsFile&, void*), void* data, void (*printDataLine)(void*) = NULL, void (*setRomName)(const char* input) = NULL) {
+  ScratchBuffer nameBuffer(128);
+  char* gamename = (char*)(uint8_t*)nameBuffer;
+
+  get_line(gamename, &database, 128);
+  readData(database, data);
+  database.close();
+
+  display_Clear();
+  println_Msg(F("Cartridge detected"));
+  println_Msg(FS(FSTRING_EMPTY));
+  println_Msg(gamename);
+  if (printDataLine) {
+    printDataLine(data);
+  }
+  if (setRomName) {
+    setRomName(gamename);
+  }
+  println_Msg(FS(FSTRING_EMPTY));
+  // Prints string out of the common strings array either with or without newline
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+}
+
 // navigate through the database file using OSSC input buttons. Requires function pointer readData for reading device specific data line from database
 // printDataLine - optional callback for printing device specific data informations about the currently browsed game
 // setRomName - callback function to set rom name if game is selected
 // returns true if a game was selected, false otherwise
 boolean checkCartSelection(FsFile& database, void (*readData)(FsFile&, void*), void* data, void (*printDataLine)(void*) = NULL, void (*setRomName)(const char* input) = NULL) {
-  char gamename[128];
+  ScratchBuffer nameBuffer(128);
+  char* gamename = (char*)(uint8_t*)nameBuffer;
   uint8_t fastScrolling = 1;
 
   // Display database
@@ -789,7 +2009,7 @@ boolean checkCartSelection(FsFile& database, void (*readData)(FsFile&, void*), v
 #endif
     display_Clear();
 
-    get_line(gamename, &database, sizeof(gamename));
+    get_line(gamename, &database, 128);
 
     readData(database, data);
 
@@ -1119,6 +2339,8 @@ constexpr char modeItem41[] PROGMEM = "Flashrom Programmer";
 constexpr char modeItem42[] PROGMEM = "CP System III";
 constexpr char modeItem43[] PROGMEM = "Self Test (3V)";
 constexpr char modeItem44[] PROGMEM = "About";
+constexpr char modeItem45[] PROGMEM = "Compare to File";
+constexpr char modeItem46[] PROGMEM = "SD Benchmark";
 
 static const char* const modeOptions[] PROGMEM = {
 #ifdef ENABLE_GBX
@@ -1247,6 +2469,12 @@ static const char* const modeOptions[] PROGMEM = {
 #ifdef ENABLE_CPS3
   modeItem42,
 #endif
+#ifdef ENABLE_COMPARE
+  modeItem45,
+#endif
+#ifdef ENABLE_SD_BENCHMARK
+  modeItem46,
+#endif
 #ifdef ENABLE_SELFTEST
   modeItem43,
 #endif
@@ -1573,6 +2801,16 @@ void mainMenu() {
       return cpsMenu();
 #endif
 
+#ifdef ENABLE_COMPARE
+    case SYSTEM_MENU_COMPARE:
+      return compareMenu();
+#endif
+
+#ifdef ENABLE_SD_BENCHMARK
+    case SYSTEM_MENU_SD_BENCHMARK:
+      return sdBenchmark();
+#endif
+
 #ifdef ENABLE_SELFTEST
     case SYSTEM_MENU_SELFTEST:
       return selfTest();
@@ -1584,7 +2822,7 @@ void mainMenu() {
       break;
 
     case SYSTEM_MENU_RESET:
-      return resetArduino();
+      return rebootArduino();
       break;
 
     default:
@@ -1610,7 +2848,8 @@ void selfTest() {
 
   display_Clear();
   println_Msg(F("Self Test"));
-  println_Msg(FS(FSTRING_EMPTY));
+  print_Msg(F("Free RAM: "));
+  println_Msg((long unsigned int)freeRam());
   println_Msg(F("Remove all Cartridges"));
   println_Msg(F("before continuing!"));
 #if (defined(HW3) || defined(HW2))
@@ -1752,6 +2991,98 @@ void selfTest() {
 }
 #endif
 
+#ifdef ENABLE_SD_BENCHMARK
+/******************************************
+  SD Benchmark
+*****************************************/
+#define SD_BENCHMARK_FILE "/SDBENCH.BIN"
+#define SD_BENCHMARK_SECTORS 4096
+
+// Prints KB per second for a number of sectors and the time they took
+void printThroughput(const __FlashStringHelper* label, uint32_t sectors, uint32_t micro) {
+  char str[22];
+  uint32_t kbPerSecond = (micro == 0) ? 0 : ((uint64_t)sectors * 512 * 1000000 / 1024) / micro;
+
+  sprintf(str, "%lu KB/s", kbPerSecond);
+  print_Msg(label);
+  println_Msg(str);
+}
+
+// Sequential write and read throughput with 512 byte sectors like a dump writes them, and the slowest
+// single write, which is what stalls cores that can't pause the cart
+void sdBenchmark() {
+  uint32_t writeTime = 0;
+  uint32_t readTime = 0;
+  uint32_t maxLatency = 0;
+  uint16_t errors = 0;
+  char str[22];
+
+  display_Clear();
+  println_Msg(F("SD Benchmark"));
+#ifdef OPTION_SD_DEDICATED_SPI
+  println_Msg(F("Dedicated SPI"));
+#else
+  println_Msg(F("Shared SPI"));
+#endif
+  sprintf(str, "%u KB test file", SD_BENCHMARK_SECTORS / 2);
+  println_Msg(str);
+  display_Update();
+
+  sd.chdir();
+  if (!myFile.open(SD_BENCHMARK_FILE, O_RDWR | O_CREAT | O_TRUNC)) {
+    print_FatalError(create_file_STR);
+  }
+
+  // Untimed progress bar updates every 64 sectors
+  draw_progressbar(0, SD_BENCHMARK_SECTORS * 2);
+  for (uint16_t sector = 0; sector < SD_BENCHMARK_SECTORS; sector++) {
+    // Different data in every sector so the read back can be checked
+    memset(sdBuffer, sector & 0xFF, 512);
+    sdBuffer[0] = sector >> 8;
+
+    uint32_t start = micros();
+    myFile.write(sdBuffer, 512);
+    uint32_t latency = micros() - start;
+
+    writeTime += latency;
+    if (latency > maxLatency)
+      maxLatency = latency;
+    if ((sector & 63) == 63)
+      draw_progressbar(sector + 1, SD_BENCHMARK_SECTORS * 2);
+  }
+  uint32_t start = micros();
+  myFile.sync();
+  writeTime += micros() - start;
+
+  myFile.rewind();
+  for (uint16_t sector = 0; sector < SD_BENCHMARK_SECTORS; sector++) {
+    start = micros();
+    myFile.read(sdBuffer, 512);
+    readTime += micros() - start;
+
+    if ((sdBuffer[0] != (sector >> 8)) || (sdBuffer[511] != (sector & 0xFF)))
+      errors++;
+    if ((sector & 63) == 63)
+      draw_progressbar(SD_BENCHMARK_SECTORS + sector + 1, SD_BENCHMARK_SECTORS * 2);
+  }
+  myFile.remove();
+
+  printThroughput(F("Write: "), SD_BENCHMARK_SECTORS, writeTime);
+  printThroughput(F("Read:  "), SD_BENCHMARK_SECTORS, readTime);
+  sprintf(str, "Max write: %lu us", maxLatency);
+  println_Msg(str);
+  if (errors > 0) {
+    sprintf(str, "%u bad sectors", errors);
+    println_Msg(str);
+    print_Error(F("Read back failed"));
+  }
+  println_Msg(FS(FSTRING_EMPTY));
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+}
+#endif
+
 /******************************************
   About Screen
 *****************************************/
@@ -1813,12 +3144,22 @@ void draw_progressbar(uint32_t processed, uint32_t total) {
 
   //Find progressbar length and draw if processed size is not 0
   if (processed == 0) {
+    // Only presses from now on cancel the operation
+    inputClear();
     previous = 0;
+#ifdef OPTION_REMOTE
+    remoteProgress(processed, total);
+#endif
     print_Msg(F("["));
     display_Update();
     return;
   }
 
+  // Any button press cancels
+  if (inputPending()) {
+    cancelOperation();
+  }
+
   // Progress bar
   current = (processed >= total) ? steps : processed / (total / steps);
 
@@ -1835,6 +3176,9 @@ void draw_progressbar(uint32_t processed, uint32_t total) {
     }
     //update previous "*" status
     previous = current;
+#ifdef OPTION_REMOTE
+    remoteProgress(processed, total);
+#endif
     //Update display
     display_Update();
   }
@@ -1850,8 +3194,13 @@ RTC_DS3231 rtc;
 RTC_DS1307 rtc;
 #endif
 
-// Start Time
+bool rtcStarted = false;
+
+// Start Time, done on first use instead of at boot
 void RTCStart() {
+  if (rtcStarted) return;
+  rtcStarted = true;
+
   // Start RTC
   if (!rtc.begin()) {
     abort();
@@ -1870,6 +3219,7 @@ void RTCStart() {
 // Set Date/Time Callback Funtion
 // Callback for file timestamps
 void dateTime(uint16_t* date, uint16_t* time) {
+  RTCStart();
   DateTime now = rtc.now();
 
   // Return date using FAT_DATE macro to format fields
@@ -1886,6 +3236,8 @@ void dateTime(uint16_t* date, uint16_t* time) {
 *****************************************/
 // Format a Date/Time stamp
 char* RTCStamp(char time[21]) {
+  RTCStart();
+
   // Set a format
   memcpy(time, "DDMMMYYYY hh:mm:ssAP", 21);
 
@@ -1897,6 +3249,12 @@ char* RTCStamp(char time[21]) {
 /******************************************
    Clockgen Calibration
  *****************************************/
+#if defined(OPTION_CLOCKGEN_CALIBRATION) || defined(OPTION_CLOCKGEN_USE_CALIBRATION)
+// Offset from /snes_clk.txt, only read from the SD card once per boot
+int32_t clockOffsetCache = INT32_MIN;
+bool clockOffsetCached = false;
+#endif
+
 #ifdef OPTION_CLOCKGEN_CALIBRATION
 int32_t cal_factor = 0;
 int32_t old_cal = 0;
@@ -2080,6 +3438,7 @@ void savetofile() {
 
   // Close the file:
   myFile.close();
+  clockOffsetCache = cal_factor;
   print_STR(done_STR, 1);
   display_Update();
   delay(1000);
@@ -2090,6 +3449,14 @@ void savetofile() {
 #if defined(OPTION_CLOCKGEN_CALIBRATION) || defined(OPTION_CLOCKGEN_USE_CALIBRATION)
 
 int32_t readClockOffset() {
+  if (!clockOffsetCached) {
+    clockOffsetCache = readClockOffsetFile();
+    clockOffsetCached = true;
+  }
+  return clockOffsetCache;
+}
+
+int32_t readClockOffsetFile() {
   FsFile clock_file;
   if (!clock_file.open("/snes_clk.txt", O_READ)) {
     return INT32_MIN;
@@ -2128,6 +3495,7 @@ int32_t initializeClockOffset() {
     if (clock_file.open("/snes_clk.txt", O_WRITE | O_CREAT | O_TRUNC)) {
       clock_file.write("0", 1);
       clock_file.close();
+      clockOffsetCache = 0;
     }
   }
   return clock_offset;
@@ -2138,6 +3506,125 @@ int32_t initializeClockOffset() {
 #endif
 }
 
+/******************************************
+   Warm Restart
+ *****************************************/
+#ifdef OPTION_WARM_RESTART
+// Returns to the main menu without rebooting. Falls back to a reboot until loop() has armed it.
+// Cart info the cores fill in, back to the values it has after power on
+void resetCartInfo() {
+  choice = 0;
+  ignoreError = 0;
+  root = 0;
+  filebrowse = 0;
+  romName[0] = '\0';
+  sramSize = 0;
+  romType = 0;
+  saveType = 0;
+  romSize = 0;
+  numBanks = 128;
+  checksumStr[0] = '\0';
+  errorLvl = 0;
+  romVersion = 0;
+  cartID[0] = '\0';
+  cartSize = 0;
+  flashid = 0;
+  flashid_str[0] = '\0';
+  vendorID[0] = '\0';
+  fileSize = 0;
+  sramBase = 0;
+  flashBanks = 0;
+  flashX16Mode = false;
+  flashSwitchLastBits = false;
+  writeErrors = 0;
+}
+
+void resetArduino() {
+  if (!warmRestartArmed) rebootArduino();
+
+  // Drop an open dump without the compare report
+#ifdef ENABLE_COMPARE
+  compareState = COMPARE_OFF;
+  static_cast<FsFile&>(myFile).close();
+#else
+  myFile.close();
+#endif /* ENABLE_COMPARE */
+
+  // Release the cartridge ports like after power on
+  DDRA = 0;
+  PORTA = 0;
+  DDRC = 0;
+  PORTC = 0;
+  DDRF = 0;
+  PORTF = 0;
+  DDRH = 0;
+  PORTH = 0;
+  DDRK = 0;
+  PORTK = 0;
+  DDRL = 0;
+  PORTL = 0;
+  // PE0/PE1 are the serial port and the HW4 TX LED
+  DDRE &= (1 << 0) | (1 << 1);
+  PORTE &= (1 << 0) | (1 << 1);
+  // PG2 is the button
+  DDRG &= ~((1 << 0) | (1 << 1) | (1 << 5));
+  PORTG &= ~((1 << 0) | (1 << 1) | (1 << 5));
+  DDRJ = 0;
+  PORTJ = 0;
+  interrupts();
+
+  setVoltage(VOLTS_SET_3V3);
+#if defined(ENABLE_3V3FIX)
+  setClockScale(CLKSCALE_8MHZ);
+#endif /* ENABLE_3V3FIX */
+
+  sd.chdir();
+  filePath[0] = '\0';
+  mode = CORE_MAX;
+  resetCartInfo();
+  scratchReset();
+  inputClear();
+#ifdef ENABLE_GLOBAL_LOG
+  dont_log = false;
+  myLog.flush();
+#endif /* ENABLE_GLOBAL_LOG */
+  statusLED(true);
+  display_Clear();
+
+  longjmp(warmRestartPoint, 1);
+}
+#endif /* OPTION_WARM_RESTART */
+
+/******************************************
+   Boot Timing
+ *****************************************/
+#ifdef OPTION_BOOT_TIMING
+// Records the time since the previous step, use BOOT_STEP("name")
+void bootStep(const __FlashStringHelper* name) {
+  static unsigned long lastStep = 0;
+  unsigned long now = millis();
+  if (bootSteps < BOOT_STEPS) {
+    bootStepName[bootSteps] = name;
+    bootStepTime[bootSteps] = now - lastStep;
+    bootSteps++;
+  }
+  lastStep = now;
+}
+
+#ifdef ENABLE_GLOBAL_LOG
+// Appends the recorded startup steps to the log
+void log_BootTiming() {
+  if (!loggingEnabled) return;
+  for (uint8_t i = 0; i < bootSteps; i++) {
+    myLog.print(bootStepName[i]);
+    myLog.print(F(": "));
+    myLog.print(bootStepTime[i]);
+    myLog.println(F("ms"));
+  }
+}
+#endif /* ENABLE_GLOBAL_LOG */
+#endif /* OPTION_BOOT_TIMING */
+
 /******************************************
    Setup
  *****************************************/
@@ -2165,6 +3652,9 @@ void setup() {
   DDRD &= ~(1 << 7);
 #endif /* HW5 &| ENABLE_VSELECT */
 
+  // Queue button presses so long operations can be canceled
+  inputInit();
+
   // Set power to low to protect carts
   setVoltage(VOLTS_SET_3V3);
 
@@ -2173,6 +3663,7 @@ void setup() {
   setClockScale(CLKSCALE_16MHZ);
   delay(10);
 #endif /* ENABLE_3V3FIX */
+  BOOT_STEP("Ports");
 
 #if !defined(ENABLE_SERIAL) && defined(ENABLE_UPDATER)
   ClockedSerial.begin(UPD_BAUD);
@@ -2214,10 +3705,7 @@ void setup() {
 #endif /* ENABLE_NEOPIXEL */
 
 #ifdef ENABLE_RTC
-  // Start RTC
-  RTCStart();
-
-  // Set Date/Time Callback Funtion
+  // Set Date/Time Callback Funtion, the RTC is started by the first time stamp
   SdFile::dateTimeCallback(dateTime);
 #endif /* ENABLE_RTC */
 
@@ -2236,9 +3724,10 @@ void setup() {
   // LED Error
   rgbLed(blue_color);
 #endif /* ENABLE_SERIAL */
+  BOOT_STEP("Display");
 
   // Init SD card
-  if (!sd.begin(SS)) {
+  if (!sd.begin(SD_CONFIG)) {
     display_Clear();
 #ifdef ENABLE_VSELECT
     print_STR(sd_error_STR, 1);
@@ -2255,23 +3744,26 @@ void setup() {
     println_Msg(F("Press button to cancel/restart."));
     display_Update();
     wait();
-    resetArduino();
+    rebootArduino();
 #else  /* !ENABLE_VSELECT */
     print_FatalError(sd_error_STR);
 #endif /* ENABLE_VSELECT */
   }
+  BOOT_STEP("SD card");
 
 #if defined(ENABLE_CONFIG)
   configInit();
 #if defined(ENABLE_GLOBAL_LOG)
   loggingEnabled = !!configGetLong(F("oscr.logging"), 1);
 #endif /*ENABLE_CONFIG*/
+  busCheckEnabled = !!configGetLong(F("oscr.busCheck"));
 
   // Change LCD background if config specified
 #ifdef ENABLE_NEOPIXEL
   setColor_RGB(0, 0, 100);
 #endif /* ENABLE_NEOPIXEL */
 #endif /* ENABLE_CONFIG */
+  BOOT_STEP("Config");
 
 #ifdef ENABLE_GLOBAL_LOG
   if (!myLog.open("OSCR_LOG.txt", O_RDWR | O_CREAT | O_APPEND)) {
@@ -2308,6 +3800,10 @@ void setup() {
 #endif /* HWn */
   print_Msg(FS(FSTRING_SPACE));
   println_Msg(FS(FSTRING_VERSION));
+  BOOT_STEP("Log");
+#ifdef OPTION_BOOT_TIMING
+  log_BootTiming();
+#endif /* OPTION_BOOT_TIMING */
 #endif /* ENABLE_GLOBAL_LOG */
 
   // Turn status LED on
@@ -2317,8 +3813,10 @@ void setup() {
   setClockScale(CLKSCALE_8MHZ);  // Set clock back to low after setup
 #endif                           /* ENABLE_3V3FIX */
 
+#ifndef OPTION_WARM_RESTART
   // Start menu system
   mainMenu();
+#endif /* !OPTION_WARM_RESTART */
 }
 
 /******************************************
@@ -2435,6 +3933,20 @@ void print_Error(int errorMessage) {
   _print_Error();
 }
 
+// Stops an operation the user canceled, a partially written file is deleted
+void cancelOperation() {
+  if (myFile.isOpen()) {
+    if (myFile.isWritable())
+      myFile.remove();
+    else
+      myFile.close();
+  }
+  inputWaitRelease();
+  inputClear();
+  println_Msg(FS(FSTRING_EMPTY));
+  print_FatalError(F("Canceled"));
+}
+
 void _print_FatalError(void) {
   println_Msg(FS(FSTRING_EMPTY));
   print_STR(press_button_STR, 1);
@@ -2456,6 +3968,9 @@ void print_FatalError(byte errorMessage) {
 void wait() {
   // Switch status LED off
   statusLED(false);
+#ifdef OPTION_REMOTE
+  ClockedSerial.println(F("EVT WAIT"));
+#endif
 #if defined(ENABLE_LCD)
   wait_btn();
 #elif defined(ENABLE_OLED)
@@ -2466,11 +3981,39 @@ void wait() {
 }
 
 #ifdef ENABLE_GLOBAL_LOG
+// Appends RAM usage of the current run to the log
+void log_RamUsage() {
+  if (dont_log || !loggingEnabled) return;
+  myLog.print(F("Free RAM: "));
+  myLog.println(freeRam());
+  myLog.print(F("Unused stack: "));
+  myLog.println(stackUnused());
+  myLog.print(F("Scratch peak: "));
+  myLog.print(scratchPeak);
+  myLog.print(F("/"));
+  myLog.println(OPTION_SCRATCH_SIZE);
+  // Next log reports the peak of its own dump
+  scratchResetPeak();
+}
+
 // Copies the last part of the current log file to the dump folder
 void save_log() {
+  // Nothing was saved, so there is no dump folder to copy the log to
+  if (!dumpSaved())
+    return;
+#ifdef OPTION_DEDUPE_STORE
+  // The duplicate's folder is gone, the log stays in the main log file only
+  if (dumpDeduped) {
+    dumpDeduped = false;
+    return;
+  }
+#endif
+
   // Last found position
   uint64_t lastPosition = 0;
 
+  log_RamUsage();
+
   // Go to first line of log
   myLog.rewind();
 
@@ -2645,7 +4188,7 @@ void print_Msg(long unsigned int message, int outputFormat) {
 #endif
 }
 
-void print_Msg(String string) {
+void print_Msg(const String& string) {
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
   display.print(string);
 #endif
@@ -2673,7 +4216,7 @@ void print_Msg_PaddedHex32(unsigned long message) {
   print_Msg_PaddedHexByte((message >> 8) & 0xFF);
   print_Msg_PaddedHexByte((message >> 0) & 0xFF);
 }
-void println_Msg(String string) {
+void println_Msg(const String& string) {
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
   display.print(string);
   display.setCursor(0, display.ty + 8);
@@ -2748,9 +4291,71 @@ void println_Msg(long unsigned int message) {
 #endif
 }
 
+#if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
+// CRC-16 of every tile row of the frame buffer as it was last sent to the display
+#define DISPLAY_TILE_ROWS 8
+uint16_t displayRowSums[DISPLAY_TILE_ROWS];
+boolean displayRowSumsValid = false;
+// Row sent again by the next flush even if its CRC did not change
+uint8_t displayRefreshRow = 0;
+
+// Sends only the tile rows of the frame buffer that changed since the last flush,
+// falls back to a full update when most of the screen changed. A row that changed
+// to content with the same CRC is caught by sending one more row every flush in turn.
+void display_Flush() {
+  uint8_t tileWidth = display.getBufferTileWidth();
+  uint8_t* buffer = display.getBufferPtr();
+  uint16_t sums[DISPLAY_TILE_ROWS];
+  uint8_t changed = 0;
+
+  for (uint8_t row = 0; row < DISPLAY_TILE_ROWS; row++) {
+    // CCITT CRC, catches every change of up to 16 adjacent bits or two single bits in a row
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < tileWidth * 8; i++) {
+      crc = _crc_ccitt_update(crc, *buffer++);
+    }
+    sums[row] = crc;
+    if (!displayRowSumsValid || (sums[row] != displayRowSums[row]))
+      changed++;
+  }
+  // Marks the refresh row as changed for the loop below
+  if (displayRowSumsValid && (sums[displayRefreshRow] == displayRowSums[displayRefreshRow])) {
+    displayRowSums[displayRefreshRow] = ~sums[displayRefreshRow];
+    changed++;
+  }
+  displayRefreshRow = (displayRefreshRow + 1) % DISPLAY_TILE_ROWS;
+
+  if (changed > DISPLAY_TILE_ROWS - 3) {
+    display.updateDisplay();
+  } else if (changed > 0) {
+    // Send runs of changed rows
+    uint8_t start = 0;
+    while (start < DISPLAY_TILE_ROWS) {
+      if (sums[start] == displayRowSums[start]) {
+        start++;
+        continue;
+      }
+      uint8_t end = start + 1;
+      while ((end < DISPLAY_TILE_ROWS) && (sums[end] != displayRowSums[end]))
+        end++;
+      display.updateDisplayArea(0, start, tileWidth, end - start);
+      start = end;
+    }
+  }
+  memcpy(displayRowSums, sums, sizeof(sums));
+  displayRowSumsValid = true;
+}
+
+// Clears the screen, sending only the rows that were not blank already
+void display_Blank() {
+  display.clearBuffer();
+  display_Flush();
+}
+#endif
+
 void display_Update() {
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
-  display.updateDisplay();
+  display_Flush();
 #endif
 #ifdef ENABLE_SERIAL
   delay(100);
@@ -2762,7 +4367,7 @@ void display_Update() {
 
 void display_Clear() {
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
-  display.clearDisplay();
+  display_Blank();
   display.setCursor(0, 8);
 #endif
 #ifdef ENABLE_GLOBAL_LOG
@@ -2913,9 +4518,12 @@ byte questionBox_Serial(const __FlashStringHelper* question __attribute__((unuse
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
 // Display a question box with selectable answers. Make sure default choice is in (0, num_answers]
 unsigned char questionBox_Display(const __FlashStringHelper* question, char answers[7][20], uint8_t num_answers, uint8_t default_choice) {
+#ifdef OPTION_REMOTE
+  remoteMenu(question, answers, num_answers);
+#endif
+
   //clear the screen
-  display.clearDisplay();
-  display.updateDisplay();
+  display_Blank();
   display.setCursor(0, 8);
   display.setDrawColor(1);
 
@@ -2932,14 +4540,14 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
     display.println(answers[i]);
     display.setCursor(0, display.ty + 8);
   }
-  display.updateDisplay();
+  display_Flush();
 
   // start with the default choice
   choice = default_choice;
 
   // draw selection box
   display.drawBox(1, 8 * choice + 11, 3, 3);
-  display.updateDisplay();
+  display_Flush();
 
   unsigned long idleTime = millis();
   byte currentColor = 0;
@@ -2976,7 +4584,7 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
       display.setDrawColor(0);
       display.drawBox(1, 8 * choice + 11, 3, 3);
       display.setDrawColor(1);
-      display.updateDisplay();
+      display_Flush();
 
       // If cursor on top list entry
       if (choice == 0) {
@@ -3003,7 +4611,7 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
 
       // draw selection box
       display.drawBox(1, 8 * choice + 11, 3, 3);
-      display.updateDisplay();
+      display_Flush();
 
       // change RGB led to the color of the current menu option
       rgbLed(choice);
@@ -3017,7 +4625,7 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
       display.setDrawColor(0);
       display.drawBox(1, 8 * choice + 11, 3, 3);
       display.setDrawColor(1);
-      display.updateDisplay();
+      display_Flush();
 
       if ((choice == num_answers - 1) && (numPages > currPage)) {
         lastPage = currPage;
@@ -3028,7 +4636,7 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
 
       // draw selection box
       display.drawBox(1, 8 * choice + 11, 3, 3);
-      display.updateDisplay();
+      display_Flush();
 
       // change RGB led to the color of the current menu option
       rgbLed(choice);
@@ -3045,8 +4653,22 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
     }
 
     checkUpdater();
+#ifdef OPTION_REMOTE
+    // Entry picked with MENU, DUMP or SAVE
+    if (remoteInput < num_answers) {
+      choice = remoteInput;
+      remoteInput = REMOTE_NONE;
+      numPages = 0;
+      break;
+    }
+#endif
   }
 
+#ifdef OPTION_REMOTE
+  remoteMenuAnswers = NULL;
+  remoteMenuCount = 0;
+#endif
+
   // pass on user choice
   rgbLed(black_color);
 
@@ -3060,11 +4682,211 @@ unsigned char questionBox_Display(const __FlashStringHelper* question, char answ
 }
 #endif
 
+#ifdef OPTION_REMOTE
+/******************************************
+  Remote control
+*****************************************/
+// Every command gets one "OK <command> ..." or "ERR <command> <reason>" line, lines starting
+// with "EVT " can come at any time. See tools/oscr_remote for a client.
+
+// EVT MENU <title>, one EVT ITEM <n> <text> per entry and EVT READY once the menu waits for input
+void remoteMenu(const __FlashStringHelper* title, char answers[7][20], uint8_t count) {
+  remoteMenuTitle = title;
+  remoteMenuAnswers = answers;
+  remoteMenuCount = count;
+  ClockedSerial.print(F("EVT MENU "));
+  ClockedSerial.println(title);
+  for (uint8_t i = 0; i < count; i++) {
+    ClockedSerial.print(F("EVT ITEM "));
+    ClockedSerial.print(i);
+    ClockedSerial.print(' ');
+    ClockedSerial.println(answers[i]);
+  }
+  ClockedSerial.println(F("EVT READY"));
+}
+
+// EVT PROGRESS <done> <total>, sent with every step of the progress bar
+void remoteProgress(uint32_t processed, uint32_t total) {
+  ClockedSerial.print(F("EVT PROGRESS "));
+  ClockedSerial.print(processed);
+  ClockedSerial.print(' ');
+  ClockedSerial.println(total);
+}
+
+// EVT CRC <crc32> OK <name> or EVT CRC <crc32> UNKNOWN after the database lookup of a dump
+void remoteCrc(uint32_t crc, const char* name) {
+  char crcStr[9];
+  sprintf(crcStr, "%08lX", crc);
+  ClockedSerial.print(F("EVT CRC "));
+  ClockedSerial.print(crcStr);
+  if (name) {
+    ClockedSerial.print(F(" OK "));
+    ClockedSerial.println(name);
+  } else {
+    ClockedSerial.println(F(" UNKNOWN"));
+  }
+}
+
+void remoteError(const String& cmd, const __FlashStringHelper* reason) {
+  ClockedSerial.print(F("ERR "));
+  ClockedSerial.print(cmd);
+  ClockedSerial.print(' ');
+  ClockedSerial.println(reason);
+}
+
+// Picks the entry of the current menu that starts with "Read" and mentions what, optionally only in the menu of core
+void remotePick(const String& cmd, const String& core, const char* what) {
+  if (!remoteMenuAnswers)
+    return remoteError(cmd, F("busy"));
+
+  if (core.length() > 0) {
+    char title[20];
+    strlcpy_P(title, reinterpret_cast<const char*>(remoteMenuTitle), sizeof(title));
+    if (strncasecmp(title, core.c_str(), core.length()) != 0)
+      return remoteError(cmd, F("wrong core"));
+  }
+
+  for (uint8_t i = 0; i < remoteMenuCount; i++) {
+    if ((strncasecmp_P(remoteMenuAnswers[i], PSTR("Read"), 4) == 0) && strcasestr(remoteMenuAnswers[i], what)) {
+      remoteInput = i;
+      ClockedSerial.print(F("OK "));
+      ClockedSerial.print(cmd);
+      ClockedSerial.print(' ');
+      ClockedSerial.println(i);
+      return;
+    }
+  }
+  remoteError(cmd, F("not in menu"));
+}
+
+// FILE <size> <name> and DIR <name> lines of a folder
+void remoteList(const String& cmd, const String& path) {
+  FsFile dir;
+  FsFile entry;
+  char name[FILENAME_LENGTH];
+  uint16_t count = 0;
+
+  if (!dir.open(path.length() ? path.c_str() : "/", O_RDONLY) || !dir.isDir())
+    return remoteError(cmd, F("no folder"));
+  while (entry.openNext(&dir, O_RDONLY)) {
+    entry.getName(name, sizeof(name));
+    if (entry.isDir()) {
+      ClockedSerial.print(F("DIR "));
+    } else {
+      ClockedSerial.print(F("FILE "));
+      ClockedSerial.print((uint32_t)entry.fileSize());
+      ClockedSerial.print(' ');
+    }
+    ClockedSerial.println(name);
+    entry.close();
+    count++;
+  }
+  dir.close();
+  ClockedSerial.print(F("OK LIST "));
+  ClockedSerial.println(count);
+}
+
+// CRC32 of a file on the SD card, with progress events
+void remoteCrcFile(const String& cmd, const String& path) {
+  FsFile file;
+  ScratchBuffer buffer(512);
+  uint32_t crc = 0xFFFFFFFF;
+  uint32_t done = 0;
+  int length;
+
+  if (!file.open(path.c_str(), O_RDONLY) || file.isDir())
+    return remoteError(cmd, F("no file"));
+  uint32_t size = file.fileSize();
+  while ((length = file.read(buffer, 512)) > 0) {
+    crc = updateCRC(buffer, length, crc);
+    done += length;
+    if ((done % 65536) == 0)
+      remoteProgress(done, size);
+  }
+  file.close();
+
+  char crcStr[9];
+  sprintf(crcStr, "%08lX", ~crc);
+  ClockedSerial.print(F("OK CRC "));
+  ClockedSerial.print(crcStr);
+  ClockedSerial.print(' ');
+  ClockedSerial.println(size);
+}
+
+// Handles the remote commands, returns false for anything else
+bool remoteCommand(const String& line) {
+  int space = line.indexOf(' ');
+  String cmd = (space < 0) ? line : line.substring(0, space);
+  String arg = (space < 0) ? String() : line.substring(space + 1);
+  arg.trim();
+
+  if (cmd == "INFO") {  // INFO: version=<version> hw=<HWn> clock=<MHz>
+    ClockedSerial.print(F("OK INFO version="));
+    ClockedSerial.print(FS(FSTRING_VERSION));
+#if defined(HW5)
+    ClockedSerial.print(F(" hw=HW5"));
+#elif defined(HW3)
+    ClockedSerial.print(F(" hw=HW3"));
+#endif
+    ClockedSerial.print(F(" clock="));
+#if defined(ENABLE_3V3FIX)
+    ClockedSerial.println((clock == CS_16MHZ) ? 16 : 8);
+#else
+    ClockedSerial.println(16);
+#endif
+  } else if (cmd == "STATUS") {  // STATUS: mode=<core> state=<menu|wait> volts=<V> ram=<bytes> error=<0|1>
+    ClockedSerial.print(F("OK STATUS mode="));
+    ClockedSerial.print((uint8_t)mode);
+    ClockedSerial.print(remoteMenuAnswers ? F(" state=menu") : F(" state=wait"));
+    ClockedSerial.print(F(" volts="));
+#if defined(ENABLE_VSELECT)
+    ClockedSerial.print((voltage == VOLTS_SET_5V) ? F("5") : F("3.3"));
+#else
+    ClockedSerial.print(F("5"));
+#endif
+    ClockedSerial.print(F(" ram="));
+    ClockedSerial.print(freeRam());
+    ClockedSerial.print(F(" error="));
+    ClockedSerial.println(errorLvl ? 1 : 0);
+  } else if (cmd == "LIST") {  // LIST [folder]
+    remoteList(cmd, arg);
+  } else if (cmd == "CRC") {  // CRC <file>
+    remoteCrcFile(cmd, arg);
+  } else if (cmd == "DUMP") {  // DUMP [core]: Read ROM in the current menu
+    remotePick(cmd, arg, "ROM");
+  } else if (cmd == "SAVE") {  // SAVE [core]: Read Save in the current menu
+    remotePick(cmd, arg, "Save");
+  } else if (cmd == "MENU") {  // MENU <n>: Select entry n of the current menu
+    uint8_t entry = arg.toInt();
+    if (!remoteMenuAnswers || (arg.length() == 0) || (entry >= remoteMenuCount)) {
+      remoteError(cmd, F("no entry"));
+    } else {
+      remoteInput = entry;
+      ClockedSerial.print(F("OK MENU "));
+      ClockedSerial.println(entry);
+    }
+  } else if (cmd == "PRESS") {  // PRESS: Continue where the reader waits for the button
+    if (remoteMenuAnswers) {
+      remoteError(cmd, F("in menu"));
+    } else {
+      remoteInput = REMOTE_PRESS;
+      ClockedSerial.println(F("OK PRESS"));
+    }
+  } else {
+    return false;
+  }
+  return true;
+}
+#endif /* OPTION_REMOTE */
+
 void checkUpdater() {
 #if !defined(ENABLE_SERIAL) && defined(ENABLE_UPDATER)
   if (ClockedSerial.available() > 0) {
     String cmd = ClockedSerial.readStringUntil('\n');
     cmd.trim();
+#ifdef OPTION_REMOTE
+    if (remoteCommand(cmd)) return;
+#endif
     if (cmd == "VERCHK") {  // VERCHK: Gets OSCR version and features
       delay(500);
       printVersionToSerial();
@@ -3096,6 +4918,7 @@ void checkUpdater() {
 #if defined(ENABLE_RTC)
       if (cmd != "GETTIME") {
         ClockedSerial.println(F("Setting Time..."));
+        RTCStart();
         rtc.adjust(DateTime(cmd.substring(8).toInt()));
       }
       ClockedSerial.print(F("Current Time: "));
@@ -3161,6 +4984,8 @@ void wait_serial() {
 #if defined(ENABLE_OLED)
 // Read button state
 uint8_t checkButton() {
+  // Presses made in menus must not cancel the next operation, every poll takes one out of the queue
+  inputRead();
 #ifdef ENABLE_BUTTON2
   byte eventButton2 = checkButton2();
   if ((eventButton2 > 0) && (eventButton2 < 2))
@@ -3316,6 +5141,13 @@ void wait_btn() {
     }
 
     checkUpdater();
+#ifdef OPTION_REMOTE
+    if (remoteInput == REMOTE_PRESS) {
+      remoteInput = REMOTE_NONE;
+      errorLvl = 0;
+      break;
+    }
+#endif
   }
 }
 #endif
@@ -3324,6 +5156,8 @@ void wait_btn() {
 #if (defined(ENABLE_LCD) && defined(ENABLE_ROTARY))
 // Read encoder state
 uint8_t checkButton() {
+  // Presses made in menus must not cancel the next operation, every poll takes one out of the queue
+  inputRead();
   // Read rotary encoder
   encoder.tick();
   int newPos = encoder.getPosition();
@@ -3396,6 +5230,13 @@ void wait_btn() {
     }
 
     checkUpdater();
+#ifdef OPTION_REMOTE
+    if (remoteInput == REMOTE_PRESS) {
+      remoteInput = REMOTE_NONE;
+      errorLvl = 0;
+      break;
+    }
+#endif
   }
 }
 
@@ -3613,6 +5454,13 @@ page:
   Main loop
 *****************************************/
 void loop() {
+#ifdef OPTION_WARM_RESTART
+  // resetArduino() lands here, the main menu then runs inside loop()
+  if (setjmp(warmRestartPoint)) {
+    return mainMenu();
+  }
+  warmRestartArmed = true;
+#endif /* OPTION_WARM_RESTART */
   switch (mode) {
 #ifdef ENABLE_N64
     case CORE_N64_CART: return n64CartMenu();
@@ -409,6 +409,16 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
     Note For Developers: See OSCR.* for info.
 
     Filename: config.txt
+
+    Enables the walking-one address line check before N64, GB, GBA
+    and NES ROM dumps, off unless set in the config. Suspect lines
+    are shown and the dump can still be started:
+      oscr.busCheck=1
+
+    Adds "Run Job" to the N64 cart menu, which runs the listed steps
+    (rom, save, verify, summary) in order on one button press and
+    copies the log of all of them next to the ROM:
+      n64.job=rom,save,verify,summary
 */
 
 //#define ENABLE_CONFIG
@@ -455,6 +465,17 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
 
 /****/
 
+/* [ Remote Control ----------------------------------------------- ]
+    Enable to drive the menus from a PC over the updater's serial
+    port with line based commands (INFO, STATUS, LIST, CRC, DUMP,
+    SAVE, MENU, PRESS) and progress events. See tools/oscr_remote.
+    Needs ENABLE_UPDATER.
+*/
+
+//#define OPTION_REMOTE
+
+/****/
+
 /* [ Self Test ---------------------------------------------------- ]
     Tests for shorts and other issues in your OSCR build.
 */
@@ -463,6 +484,29 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
 
 /****/
 
+/* [ Compare Mode ------------------------------------------------- ]
+    Adds "Compare to File" to the main menu. After picking a dump on
+    the SD card, the next ROM read is compared against that file block
+    by block instead of being saved. Nothing is written to the SD card
+    and the match percentage, first mismatch and mismatching blocks
+    are shown at the end.
+*/
+
+#define ENABLE_COMPARE
+
+/****/
+
+/* [ SD Card Benchmark -------------------------------------------- ]
+    Adds "SD Benchmark" to the main menu. It measures sequential
+    write and read speed and the slowest single sector write of the
+    inserted card with a 2MB test file and writes the results to the
+    log, to find cards that keep up with dumping.
+*/
+
+//#define ENABLE_SD_BENCHMARK
+
+/****/
+
 /* [ Logging ------------------------------------------------------ ]
     Write all info to OSCR_LOG.txt in root dir
 
@@ -555,12 +599,129 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
 
 /****/
 
+/* [ SD Card: Dedicated SPI --------------------------------------- ]
+    Enable to use the SD card as the only device on the SPI bus.
+    SdFat then keeps the card in multi-sector mode between reads and
+    writes instead of ending the transfer after every call. The SPI
+    clock is the fastest the Mega supports in both modes. Ignored on
+    HW4 and HW5, where the LCD shares the SPI bus with the SD card.
+*/
+
+//#define OPTION_SD_DEDICATED_SPI
+
+/****/
+
+/* [ Scratch Buffer Size ------------------------------------------ ]
+    Size in bytes of the shared scratch arena that cores borrow their
+    dump buffers and database name buffers from. It is reserved
+    statically, so it shows up in the "Global variables use" line when
+    compiling. The peak usage of each dump, free RAM and unused stack
+    are written to the log after every dump. The largest buffers need
+    1024 bytes, so don't go below that.
+
+    Must be a multiple of 512. Raise it to allow larger multi-sector
+    buffers if your build has RAM to spare.
+*/
+
+#define OPTION_SCRATCH_SIZE 1024
+
+/****/
+
+/* [ Dedupe Store ------------------------------------------------- ]
+    Enable to keep only one copy of identical dumps and saves. Every
+    file is listed with its CRC32 in /dedupe.txt, a new file that is
+    identical to a listed one is removed again and only recorded as
+    a reference to the existing copy. Unchanged save backups are not
+    kept at all.
+*/
+
+//#define OPTION_DEDUPE_STORE
+
+/****/
+
+/* [ Dump Hashes -------------------------------------------------- ]
+    Enable to also calculate the SHA-1 and/or MD5 of every dump in the
+    same pass as the CRC32: while dumping where the CRC32 is calculated
+    during the dump (N64 fast CRC), else in the CRC32 pass over the
+    file. The digests are saved next to the dump as <name>.sha1 and
+    <name>.md5 in sha1sum/md5sum format and written to the log,
+    together with the time a pass over the file took.
+*/
+
+//#define OPTION_HASH_SHA1
+//#define OPTION_HASH_MD5
+
+/****/
+
+/* [ Contact Check ------------------------------------------------ ]
+    Enable to check the cart's contacts before dumping N64, GB, GBA
+    and NES ROMs. A sample of addresses is read repeatedly, also with
+    each address line flipped, and every address and data line that
+    returns unstable data is listed with its error count. Takes a few
+    seconds and lets you stop and clean the cart before a long dump.
+*/
+
+//#define OPTION_CONTACT_CHECK
+
+/****/
+
+/* [ Warm Restart ------------------------------------------------- ]
+    Enable to go back to the main menu without rebooting when an
+    operation is finished or canceled. Only the cartridge ports are
+    released and the voltage is set back to 3.3V, the display, SD
+    card, config file and log stay initialized, so the next cart can
+    be started right away. "Reset" in the main menu still reboots.
+*/
+
+//#define OPTION_WARM_RESTART
+
+/****/
+
+/* [ Boot Timing -------------------------------------------------- ]
+    Enable to write the time every step of the startup took to the
+    log (display, SD card, config file, log file). Needs logging.
+*/
+
+//#define OPTION_BOOT_TIMING
+
+/****/
+
+/* [ Sampled Blank Check ------------------------------------------ ]
+    Enable to only spot check N64 and MD repros after they were
+    erased before writing. The erase already waits until the chip
+    reports it is done, the check then reads the first 512 bytes of
+    every 8KB instead of the whole chip. 8KB is the smallest sector
+    of the supported chips (boot blocks), so every sector is sampled
+    and one that did not erase at all is still caught. Blankcheck in
+    the menus always reads the whole chip.
+*/
+
+//#define OPTION_BLANKCHECK_SAMPLE
+
+/****/
+
 /*==== PROCESSING =================================================*/
 
 /*
               You probably shouldn't change this stuff!
 */
 
+#if !defined(OPTION_SCRATCH_SIZE)
+#define OPTION_SCRATCH_SIZE 1024
+#endif
+
+#if (defined(OPTION_HASH_SHA1) || defined(OPTION_HASH_MD5))
+#define OPTION_HASH
+#endif
+
+/* Blank checks after an erase read 512 bytes out of every BLANKCHECK_STEP,
+   which must not exceed the smallest erase sector (8KB boot blocks) */
+#if defined(OPTION_BLANKCHECK_SAMPLE)
+#define BLANKCHECK_STEP 8192UL
+#else
+#define BLANKCHECK_STEP 512UL
+#endif
+
 #if defined(ENABLE_CONFIG)
 #define CONFIG_FILE "config.txt"
 // Define the max length of the key=value pairs
@@ -575,6 +736,8 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
 #define ENABLE_ROTARY
 //# define rotate_counter_clockwise
 #define OPTION_WS_ADAPTER_V2
+// The LCD is on the SPI bus too
+#undef OPTION_SD_DEDICATED_SPI
 #endif
 
 #if (defined(HW2) || defined(HW3))
@@ -596,6 +759,11 @@ also needs ENABLE_FLASH8 and ENABLE_FLASH16 to be enabled
 #undef ENABLE_UPDATER
 #endif
 
+/* Remote control uses the updater's serial port */
+#if !defined(ENABLE_UPDATER) || defined(ENABLE_SERIAL)
+#undef OPTION_REMOTE
+#endif
+
 /* End of settings */
 
 #endif /* CONFIG_H_ */
@@ -879,6 +879,9 @@ void setup_FlashVoltage() {}
 #endif
 
 void setup_Flash8() {
+  // Set by setup_CPS3()
+  byteCtrl = 0;
+
   // Set Address Pins to Output
   //A0-A7
   DDRF = 0xFF;
@@ -902,6 +905,9 @@ void setup_Flash8() {
 
 #ifdef ENABLE_FLASH16
 void setup_Flash16() {
+  // Set by setup_CPS3()
+  byteCtrl = 0;
+
   // Set Address Pins to Output
   //A0-A7
   DDRF = 0xFF;
@@ -2222,18 +2228,10 @@ void blankcheck_Flash() {
 
   blank = 1;
   for (unsigned long currBuffer = 0; currBuffer < flashSize; currBuffer += 512) {
-    // Fill buffer
-    for (int c = 0; c < 512; c++) {
-      // Read byte
-      sdBuffer[c] = readByte_Flash(currBuffer + c);
-    }
     // Check if all bytes are 0xFF
-    for (uint32_t currByte = 0; currByte < 512; currByte++) {
-      if (sdBuffer[currByte] != 0xFF) {
-        currByte = 512;
-        currBuffer = flashSize;
-        blank = 0;
-      }
+    if (!blankcheckPage_Flash(currBuffer) || !blankcheckPage_Flash(currBuffer + 256)) {
+      blank = 0;
+      break;
     }
     // Update progress bar
     processedProgressBar += 512;
@@ -2251,6 +2249,58 @@ void blankcheck_Flash() {
   }
 }
 
+// Check the 256 bytes that share A8-A23 with myAddress for 0xFF. The first read drives
+// the upper address lines for the current mapping, after that only A0-A7 change.
+boolean blankcheckPage_Flash(unsigned long myAddress) {
+  byte blank = readByte_Flash(myAddress);
+
+  // Same OE lines as readByte_Flash
+  volatile uint8_t* oePort = &PORTH;
+  byte oeMask = (1 << 1) | (1 << 3);
+  if (byteCtrl) {
+    oeMask = (1 << 1);
+  } else if (mapping == 3) {
+    oePort = &PORTL;
+    oeMask = (1 << 0);
+  }
+
+  for (word c = (myAddress & 0xFF) + 1; c < 256; c++) {
+    // A0-A7
+    PORTF = c;
+
+    // Arduino running at 16Mhz -> one nop = 62.5ns
+    __asm__("nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t");
+
+    // Setting OE LOW
+    *oePort &= ~oeMask;
+
+    __asm__("nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t");
+
+    // Read
+    blank &= PINC;
+
+    // Setting OE HIGH
+    *oePort |= oeMask;
+    __asm__("nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t"
+            "nop\n\t");
+  }
+  return (blank == 0xFF);
+}
+
 void verifyFlash() {
   verifyFlash(1, 1, 0);
 }
@@ -2512,13 +2562,8 @@ void blankcheck16() {
   println_Msg(F("Please wait..."));
   display_Update();
 
-  blank = 1;
-  for (unsigned long currByte = 0; currByte < flashSize / 2; currByte++) {
-    if (readWord_Flash(currByte) != 0xFFFF) {
-      currByte = flashSize / 2;
-      blank = 0;
-    }
-  }
+  // Bus timing is set in Flash16Bus (BusAccess.h)
+  blank = busBlank16<Flash16Bus>(0, flashSize / 2);
   if (blank) {
     println_Msg(F("Flashrom is empty."));
     display_Update();
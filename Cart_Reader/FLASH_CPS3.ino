@@ -962,30 +962,12 @@ void blankcheckSIMM2x8() {
   draw_progressbar(0, totalProgressBar);
 
   blank = 1;
-  word d = 0;
-  unsigned long simmAddress = 0;
   for (unsigned long currBuffer = 0; currBuffer < flashSize / 2; currBuffer += 256) {
-    // Fill buffer
-    for (int c = 0; c < 256; c++) {
-      simmAddress = currBuffer + c;
-      word currWord = readWord_Flash(simmAddress);
-      // Read byte right
-      sdBuffer[d + 1] = ((currWord >> 8) & 0xFF);
-      // Read byte left
-      sdBuffer[d] = (currWord & 0xFF);
-      d += 2;
-    }
-    // Check if all bytes are 0xFF
-    d = 0;
-    for (unsigned long currByte = 0; currByte < 256; currByte++) {
-      if (sdBuffer[d] != 0xFF || sdBuffer[d + 1] != 0xFF) {
-        currByte = 256;
-        currBuffer = flashSize / 2;
-        blank = 0;
-      }
-      d += 2;
+    // Check if all bytes are 0xFF, bus timing is set in Flash16Bus (BusAccess.h)
+    if (!busBlank16<Flash16Bus>(currBuffer, 256)) {
+      blank = 0;
+      break;
     }
-    d = 0;
     // Update progress bar
     processedProgressBar += 512;
     draw_progressbar(processedProgressBar, totalProgressBar);
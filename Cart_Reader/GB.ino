@@ -378,9 +378,7 @@ void gbxMenu() {
                   saveFound = true;
                   sprintf(filePath, "/GB/SAVE/%s/%d", fileName, i);
                   sprintf(fileName, "%s.SAV", fileName);
-                  writeSRAM_GB();
-                  unsigned long wrErrors;
-                  wrErrors = verifySRAM_GB();
+                  unsigned long wrErrors = writeSRAM_GB();
                   if (wrErrors == 0) {
                     println_Msg(F("Verified OK"));
                     display_Update();
@@ -549,6 +547,9 @@ void gbMenu() {
           readEEPROM_MBC7_GB();
         else
           readSRAM_GB();
+#ifdef OPTION_DEDUPE_STORE
+        dedupeSave();
+#endif
       } else {
         print_Error(F("No save or unsupported type"));
       }
@@ -569,9 +570,7 @@ void gbMenu() {
         else if (romType == 34)
           writeEEPROM_MBC7_GB();
         else {
-          writeSRAM_GB();
-          unsigned long wrErrors;
-          wrErrors = verifySRAM_GB();
+          unsigned long wrErrors = writeSRAM_GB();
           if (wrErrors == 0) {
             println_Msg(F("Verified OK"));
             display_Update();
@@ -605,6 +604,9 @@ void setup_GB() {
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
+  // Set again by the flash menu after this
+  audioWE = 0;
+
   setup_GBPort();
 
   // FIXME for now setup_GBPort doesn't set these ones up
@@ -779,40 +781,16 @@ void showCartInfo_GB() {
 /******************************************
   Low level functions
 *****************************************/
+// Read one byte, bus layout and timing are set in GbBus (BusAccess.h)
 byte readByte_GB(word myAddress) {
-  // Set address
-  PORTF = myAddress & 0xFF;
-  PORTK = (myAddress >> 8) & 0xFF;
-  // Switch data pins to input
-  DDRC = 0x00;
-  // Enable pullups
-  PORTC = 0xFF;
-
-  __asm__("nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t");
-
-  // Switch RD(PH6) to LOW
-  PORTH &= ~(1 << 6);
-
-  __asm__("nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t");
-
-  // Read
-  byte tempByte = PINC;
-
-  // Switch and RD(PH6) to HIGH
-  PORTH |= (1 << 6);
-
-  __asm__("nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t");
+  return busRead8<GbBus>(myAddress);
+}
 
-  return tempByte;
+// Block reader for checkBus() and checkContacts()
+void probeBlock_GB(uint32_t address, byte* data, uint16_t length) {
+  for (uint16_t c = 0; c < length; c++) {
+    data[c] = readByte_GB(address + c);
+  }
 }
 
 void writeByte_GB(int myAddress, byte myData) {
@@ -1162,6 +1140,15 @@ void getCartInfo_GB() {
 *****************************************/
 // Read ROM
 void readROM_GB() {
+#ifdef ENABLE_CONFIG
+  // From the header at 0x100 with the logo, the first bytes are often padding
+  checkBus(&probeBlock_GB, 0x100, 0x8000, 8, true);
+#endif
+#ifdef OPTION_CONTACT_CHECK
+  // Bank 0 and whichever bank is mapped at 0x4000, A15 selects RAM
+  checkContacts(&probeBlock_GB, 0x8000, 15, 8);
+#endif
+
   // Get name, add extension and convert to char array for sd lib
   createFolderAndOpenFile("GB", "ROM", romName, "gb");
 
@@ -1272,7 +1259,7 @@ void readROM_GB() {
     // Read banks and save to SD
     while (romAddress <= endAddress) {
       for (int i = 0; i < 512; i++) {
-        sdBuffer[i] = readByte_GB(romAddress + i);
+        sdBuffer[i] = busRead8<GbBus>(romAddress + i);
       }
       myFile.write(sdBuffer, 512);
       romAddress += 512;
@@ -1318,6 +1305,9 @@ unsigned int calc_checksum_GB(char* fileName) {
 
 // Compare checksum
 void compare_checksums_GB() {
+  if (!dumpSaved())
+    return;
+
   strcpy(fileName, romName);
   strcat(fileName, ".GB");
 
@@ -1414,8 +1404,30 @@ void readSRAM_GB() {
   }
 }
 
-// Write RAM
-void writeSRAM_GB() {
+// Write one block of a save file to RAM, switching banks as needed
+void writeSramBlock_GB(uint32_t offset, const byte* data, uint16_t length) {
+  word bankSize = lastByte - 0xA000 + 1;
+  word sramAddress = 0xA000 + (offset % bankSize);
+
+  writeByte_GB(0x4000, offset / bankSize);
+  for (word c = 0; c < length; c++) {
+    writeByteSRAM_GB(sramAddress + c, data[c]);
+  }
+}
+
+// Read back one block of RAM
+void readSramBlock_GB(uint32_t offset, byte* data, uint16_t length) {
+  word bankSize = lastByte - 0xA000 + 1;
+  word sramAddress = 0xA000 + (offset % bankSize);
+
+  writeByte_GB(0x4000, offset / bankSize);
+  for (word c = 0; c < length; c++) {
+    data[c] = readByteSRAM_GB(sramAddress + c);
+  }
+}
+
+// Write RAM and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeSRAM_GB() {
   // Does cartridge have SRAM
   if (lastByte > 0) {
     // Create filepath
@@ -1434,78 +1446,24 @@ void writeSRAM_GB() {
       // Initialise MBC
       writeByte_GB(0x0000, 0x0A);
 
-      // Switch RAM banks
-      for (byte currBank = 0; currBank < sramBanks; currBank++) {
-        writeByte_GB(0x4000, currBank);
+      // Write and verify all RAM banks
+      writeErrors = writeVerifySave((uint32_t)sramBanks * (lastByte - 0xA000 + 1), writeSramBlock_GB, readSramBlock_GB);
 
-        // Write RAM
-        for (word sramAddress = 0xA000; sramAddress <= lastByte; sramAddress++) {
-          writeByteSRAM_GB(sramAddress, myFile.read());
-        }
-      }
       // Disable SRAM
       writeByte_GB(0x0000, 0x00);
 
       // Close the file:
       myFile.close();
-      display_Clear();
       println_Msg(F("SRAM writing finished"));
       display_Update();
-
+      return writeErrors;
     } else {
       print_Error(FS(FSTRING_FILE_DOESNT_EXIST));
     }
   } else {
     print_Error(F("Cart has no SRAM"));
   }
-}
-
-// Check if the SRAM was written without any error
-unsigned long verifySRAM_GB() {
-
-  //open file on sd card
-  if (myFile.open(filePath, O_READ)) {
-
-    // Variable for errors
-    writeErrors = 0;
-
-    // MBC2 Fix
-    readByte_GB(0x0134);
-
-    // Check SRAM size
-    if (lastByte > 0) {
-      if (romType <= 4) {         // MBC1
-        writeByte_GB(0x6000, 1);  // Set RAM Mode
-      }
-
-      // Initialise MBC
-      writeByte_GB(0x0000, 0x0A);
-
-      // Switch SRAM banks
-      for (byte currBank = 0; currBank < sramBanks; currBank++) {
-        writeByte_GB(0x4000, currBank);
-
-        // Read SRAM
-        for (word sramAddress = 0xA000; sramAddress <= lastByte; sramAddress += 64) {
-          //fill sdBuffer
-          myFile.read(sdBuffer, 64);
-          for (int c = 0; c < 64; c++) {
-            if (readByteSRAM_GB(sramAddress + c) != sdBuffer[c]) {
-              writeErrors++;
-            }
-          }
-        }
-      }
-      // Disable RAM
-      writeByte_GB(0x0000, 0x00);
-    }
-    // Close the file:
-    myFile.close();
-    return writeErrors;
-  } else {
-    print_FatalError(open_file_STR);
-    return 1;
-  }
+  return 1;
 }
 
 // Read SRAM + FLASH save data of MBC6
@@ -1557,7 +1515,7 @@ void readSRAMFLASH_MBC6_GB() {
     // Read banks and save to SD
     while (romAddress <= 0x5FFF) {
       for (int i = 0; i < 512; i++) {
-        sdBuffer[i] = readByte_GB(romAddress + i);
+        sdBuffer[i] = busRead8<GbBus>(romAddress + i);
       }
       myFile.write(sdBuffer, 512);
       romAddress += 512;
@@ -119,6 +119,9 @@ void gbaMenu() {
           readSRAM_GBA(1, 65536, 0);
           break;
       }
+#ifdef OPTION_DEDUPE_STORE
+      dedupeSave();
+#endif
       setROM_GBA();
       println_Msg(FS(FSTRING_EMPTY));
       // Prints string out of the common strings array either with or without newline
@@ -148,7 +151,6 @@ void gbaMenu() {
         case 3:
           // 256K SRAM/FRAM
           writeSRAM_GBA(1, 32768, 0);
-          verifySRAM_GBA(32768, 0);
           break;
 
         case 4:
@@ -231,7 +233,6 @@ void gbaMenu() {
         case 6:
           // 512K SRAM/FRAM
           writeSRAM_GBA(1, 65536, 0);
-          verifySRAM_GBA(65536, 0);
           break;
       }
       setROM_GBA();
@@ -455,47 +456,18 @@ void setROM_GBA() {
   delay(500);
 }
 
+// Read one word, bus layout and timing are set in GbaRomBus (BusAccess.h)
 word readWord_GBA(unsigned long myAddress) {
-  // Set address/data ports to output
-  DDRF = 0xFF;
-  DDRK = 0xFF;
-  DDRC = 0xFF;
-
-  // Divide address by two to get word addressing
-  myAddress = myAddress >> 1;
-
-  // Output address to address pins,
-  PORTF = myAddress;
-  PORTK = myAddress >> 8;
-  PORTC = myAddress >> 16;
-
-  // Pull CS(PH3) to LOW
-  PORTH &= ~(1 << 3);
-
-  // Set address/data ports to input
-  PORTF = 0x0;
-  PORTK = 0x0;
-  DDRF = 0x0;
-  DDRK = 0x0;
-
-  // Pull RD(PH6) to LOW
-  PORTH &= ~(1 << 6);
-
-  // Delay here or read error with repro
-  __asm__("nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t");
-
-  word myWord = (PINK << 8) | PINF;
-
-  // Switch RD(PH6) to HIGH
-  PORTH |= (1 << 6);
-
-  // Switch CS_ROM(PH3) to HIGH
-  PORTH |= (1 << 3);
+  return busRead16<GbaRomBus>(myAddress);
+}
 
-  return myWord;
+// Block reader for checkBus() and checkContacts(), words are stored big-endian
+void probeBlock_GBA(uint32_t address, byte* data, uint16_t length) {
+  for (uint16_t c = 0; c < length; c += 2) {
+    word myWord = readWord_GBA(address + c);
+    data[c] = myWord >> 8;
+    data[c + 1] = myWord & 0xFF;
+  }
 }
 
 void writeWord_GBA(unsigned long myAddress, word myWord) {
@@ -722,7 +694,8 @@ void getCartInfo_GBA() {
     //go to root
     sd.chdir();
     if (myFile.open("gba.txt", O_READ)) {
-      char gamename[100];
+      ScratchBuffer nameBuffer(100);
+      char* gamename = (char*)(uint8_t*)nameBuffer;
 
 #ifdef ENABLE_GLOBAL_LOG
       // Disable log to prevent unnecessary logging
@@ -918,6 +891,13 @@ void getCartInfo_GBA() {
 
 // Dump ROM
 void readROM_GBA() {
+#ifdef ENABLE_CONFIG
+  checkBus(&probeBlock_GBA, 0, cartSize, 16, true);
+#endif
+#ifdef OPTION_CONTACT_CHECK
+  checkContacts(&probeBlock_GBA, cartSize, 25, 16);
+#endif
+
   // Get name, add extension and convert to char array for sd lib
   createFolderAndOpenFile("GBA", "ROM", romName, "gba");
 
@@ -933,7 +913,7 @@ void readROM_GBA() {
       blinkLED();
 
     for (int currWord = 0; currWord < 512; currWord += 2) {
-      word tempWord = readWord_GBA(myAddress + currWord);
+      word tempWord = busRead16<GbaRomBus>(myAddress + currWord);
       sdBuffer[currWord] = tempWord & 0xFF;
       sdBuffer[currWord + 1] = (tempWord >> 8) & 0xFF;
     }
@@ -963,6 +943,9 @@ void readROM_GBA() {
 
 // Calculate the checksum of the dumped rom
 boolean compare_checksum_GBA() {
+  if (!dumpSaved())
+    return 0;
+
   print_Msg(FS(FSTRING_CHECKSUM));
   display_Update();
 
@@ -1040,7 +1023,22 @@ void readSRAM_GBA(boolean browseFile, uint32_t sramSize, uint32_t pos) {
   display_Update();
 }
 
-void writeSRAM_GBA(boolean browseFile, uint32_t sramSize, uint32_t pos) {
+void writeSramBlock_GBA(uint32_t offset, const byte* data, uint16_t length) {
+  for (uint16_t c = 0; c < length; c++) {
+    // Write byte
+    writeByte_GBA(offset + c, data[c]);
+  }
+}
+
+void readSramBlock_GBA(uint32_t offset, byte* data, uint16_t length) {
+  for (uint16_t c = 0; c < length; c++) {
+    // Read byte
+    data[c] = readByte_GBA(offset + c);
+  }
+}
+
+// Write SRAM/FRAM and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeSRAM_GBA(boolean browseFile, uint32_t sramSize, uint32_t pos) {
   if (browseFile) {
     filePath[0] = '\0';
     sd.chdir("/");
@@ -1057,48 +1055,11 @@ void writeSRAM_GBA(boolean browseFile, uint32_t sramSize, uint32_t pos) {
     if (pos != 0)
       myFile.seekCur(pos);
 
-    for (uint32_t currAddress = 0; currAddress < sramSize; currAddress += 512) {
-      //fill sdBuffer
-      myFile.read(sdBuffer, 512);
+    writeErrors = writeVerifySave(sramSize, writeSramBlock_GBA, readSramBlock_GBA);
 
-      for (int c = 0; c < 512; c++) {
-        // Write byte
-        writeByte_GBA(currAddress + c, sdBuffer[c]);
-      }
-    }
     // Close the file:
     myFile.close();
     println_Msg(F("SRAM writing finished"));
-    display_Update();
-
-  } else {
-    print_Error(FS(FSTRING_FILE_DOESNT_EXIST));
-  }
-}
-
-unsigned long verifySRAM_GBA(unsigned long sramSize, uint32_t pos) {
-  //open file on sd card
-  if (myFile.open(filePath, O_READ)) {
-    // Variable for errors
-    writeErrors = 0;
-
-    // Seek to a new position in the file
-    if (pos != 0)
-      myFile.seekCur(pos);
-
-    for (unsigned long currAddress = 0; currAddress < sramSize; currAddress += 512) {
-      //fill sdBuffer
-      myFile.read(sdBuffer, 512);
-
-      for (int c = 0; c < 512; c++) {
-        // Read byte
-        if (readByte_GBA(currAddress + c) != sdBuffer[c]) {
-          writeErrors++;
-        }
-      }
-    }
-    // Close the file:
-    myFile.close();
 
     if (writeErrors == 0) {
       println_Msg(F("Verified OK"));
@@ -1112,7 +1073,7 @@ unsigned long verifySRAM_GBA(unsigned long sramSize, uint32_t pos) {
 
     return writeErrors;
   } else {
-    print_Error(open_file_STR);
+    print_Error(FS(FSTRING_FILE_DOESNT_EXIST));
     return 1;
   }
 }
@@ -1466,20 +1427,12 @@ boolean blankcheckFLASH_GBA(uint32_t flashSize) {
   // Output a LOW signal on OE_FLASH(PH6)
   PORTH &= ~(1 << 6);
 
-  for (uint32_t currAddress = 0; currAddress < flashSize; currAddress += 512) {
-    // Fill buffer
-    for (int c = 0; c < 512; c++) {
-      // Read byte
-      sdBuffer[c] = readByteFlash_GBA(currAddress + c);
-    }
-    // Check buffer
-    for (uint32_t currByte = 0; currByte < 512 && (currByte + currAddress) < flashSize; currByte++) {
-      if (sdBuffer[currByte] != 0xFF) {
-        print_Error(F("Erase failed"));
-        currByte = 512;
-        currAddress = flashSize;
-        blank = 0;
-      }
+  // CE and OE stay low, only the address changes
+  for (uint32_t currAddress = 0; currAddress < flashSize; currAddress++) {
+    if (readByteFlash_GBA(currAddress) != 0xFF) {
+      print_Error(F("Erase failed"));
+      blank = 0;
+      break;
     }
   }
   // Set CS_FLASH(PH0) high
@@ -1728,8 +1681,14 @@ void writeEeprom_GBA(word eepSize) {
       // Disable interrupts for more uniform clock pulses
       noInterrupts();
       // Write 512 bytes
-      writeBlock_EEP(i, eepSize);
+      boolean written = writeBlock_EEP(i, eepSize);
       interrupts();
+      if (!written) {
+        myFile.close();
+        println_Msg(F("Error"));
+        print_Error(F("EEPROM write timeout"));
+        return;
+      }
 
       // Wait
       delayMicroseconds(200);
@@ -1774,219 +1733,28 @@ void readEeprom_GBA(word eepSize) {
   myFile.close();
 }
 
-// Send address as bits to eeprom
-void send_GBA(word currAddr, word numBits) {
-  for (word addrBit = numBits; addrBit > 0; addrBit--) {
-    // If you want the k-th bit of n, then do
-    // (n & ( 1 << k )) >> k
-    if (((currAddr & (1 << (addrBit - 1))) >> (addrBit - 1))) {
-      // Set A0(PF0) to High
-      PORTF |= (1 << 0);
-      // Set WR(PH5) to LOW
-      PORTH &= ~(1 << 5);
-      // Set WR(PH5) to High
-      PORTH |= (1 << 5);
-    } else {
-      // Set A0(PF0) to Low
-      PORTF &= ~(1 << 0);
-      // Set WR(PH5) to LOW
-      PORTH &= ~(1 << 5);
-      // Set WR(PH5) to High
-      PORTH |= (1 << 5);
-    }
-  }
-}
-
-// Write 512K eeprom block
-void writeBlock_EEP(word startAddr, word eepSize) {
-  // Setup
-  // Set CS_ROM(PH3) WR(PH5) RD(PH6) to Output
-  DDRH |= (1 << 3) | (1 << 5) | (1 << 6);
-  // Set A0(PF0) to Output
-  DDRF |= (1 << 0);
-  // Set A23/D7(PC7) to Output
-  DDRC |= (1 << 7);
-
-  // Set CS_ROM(PH3) WR(PH5) RD(PH6) to High
-  PORTH |= (1 << 3) | (1 << 5) | (1 << 6);
-  // Set A0(PF0) to High
-  PORTF |= (1 << 0);
-  // Set A23/D7(PC7) to High
-  PORTC |= (1 << 7);
-
-  __asm__("nop\n\t"
-          "nop\n\t");
+// Write 512 byte eeprom block, protocol and timing are in GbaEeprom (SerialEeprom.h)
+// Returns false if the eeprom did not finish writing a block
+boolean writeBlock_EEP(word startAddr, word eepSize) {
+  byte addressBits = (eepSize == 4) ? 6 : 14;
 
+  GbaEeprom<GbaEepPins>::setup();
   // Write 64*8=512 bytes
-  for (word currAddr = startAddr; currAddr < startAddr + 64; currAddr++) {
-    // Set CS_ROM(PH3) to LOW
-    PORTH &= ~(1 << 3);
-
-    // Send write request "10"
-    // Set A0(PF0) to High
-    PORTF |= (1 << 0);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // Set WR(PH5) to High
-    PORTH |= (1 << 5);
-    // Set A0(PF0) to LOW
-    PORTF &= ~(1 << 0);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // Set WR(PH5) to High
-    PORTH |= (1 << 5);
-
-    // Send either 6 or 14 bit address
-    if (eepSize == 4) {
-      send_GBA(currAddr, 6);
-    } else {
-      send_GBA(currAddr, 14);
-    }
-
-    __asm__("nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t");
-
-    // Send data
-    for (byte currByte = 0; currByte < 8; currByte++) {
-      send_GBA(sdBuffer[(currAddr - startAddr) * 8 + currByte], 8);
-    }
-
-    // Send stop bit
-    // Set A0(PF0) to LOW
-    PORTF &= ~(1 << 0);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // WR(PH5) to High
-    PORTH |= (1 << 5);
-
-    // Set CS_ROM(PH3) to High
-    PORTH |= (1 << 3);
-
-    // Wait until done
-    // Set A0(PF0) to Input
-    DDRF &= ~(1 << 0);
-
-    do {
-      // Set  CS_ROM(PH3) RD(PH6) to LOW
-      PORTH &= ~((1 << 3) | (1 << 6));
-      // Set  CS_ROM(PH3) RD(PH6) to High
-      PORTH |= (1 << 3) | (1 << 6);
-    } while ((PINF & 0x1) == 0);
-
-    // Set A0(PF0) to Output
-    DDRF |= (1 << 0);
+  for (word currBlock = 0; currBlock < 64; currBlock++) {
+    if (!GbaEeprom<GbaEepPins>::writeBlock(startAddr + currBlock, addressBits, sdBuffer + currBlock * 8))
+      return false;
   }
+  return true;
 }
 
 // Reads 512 bytes from eeprom
 void readBlock_EEP(word startAddress, word eepSize) {
-  // Setup
-  // Set CS_ROM(PH3) WR(PH5) RD(PH6) to Output
-  DDRH |= (1 << 3) | (1 << 5) | (1 << 6);
-  // Set A0(PF0) to Output
-  DDRF |= (1 << 0);
-  // Set A23/D7(PC7) to Output
-  DDRC |= (1 << 7);
-
-  // Set CS_ROM(PH3) WR(PH5) RD(PH6) to High
-  PORTH |= (1 << 3) | (1 << 5) | (1 << 6);
-  // Set A0(PF0) to High
-  PORTF |= (1 << 0);
-  // Set A23/D7(PC7) to High
-  PORTC |= (1 << 7);
-
-  __asm__("nop\n\t"
-          "nop\n\t");
+  byte addressBits = (eepSize == 4) ? 6 : 14;
 
+  GbaEeprom<GbaEepPins>::setup();
   // Read 64*8=512 bytes
-  for (word currAddr = startAddress; currAddr < startAddress + 64; currAddr++) {
-    // Set CS_ROM(PH3) to LOW
-    PORTH &= ~(1 << 3);
-
-    // Send read request "11"
-    // Set A0(PF0) to High
-    PORTF |= (1 << 0);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // Set WR(PH5) to High
-    PORTH |= (1 << 5);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // Set WR(PH5) to High
-    PORTH |= (1 << 5);
-
-    // Send either 6 or 14 bit address
-    if (eepSize == 4) {
-      send_GBA(currAddr, 6);
-    } else {
-      send_GBA(currAddr, 14);
-    }
-
-    // Send stop bit
-    // Set A0(PF0) to LOW
-    PORTF &= ~(1 << 0);
-    // Set WR(PH5) to LOW
-    PORTH &= ~(1 << 5);
-    // WR(PH5) to High
-    PORTH |= (1 << 5);
-
-    // Set CS_ROM(PH3) to High
-    PORTH |= (1 << 3);
-
-    __asm__("nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t"
-            "nop\n\t");
-
-    // Read data
-    // Set A0(PF0) to Input
-    DDRF &= ~(1 << 0);
-    // Set CS_ROM(PH3) to low
-    PORTH &= ~(1 << 3);
-
-    // Array that holds the bits
-    bool tempBits[65];
-
-    // Ignore the first 4 bits
-    for (byte i = 0; i < 4; i++) {
-      // Set RD(PH6) to LOW
-      PORTH &= ~(1 << 6);
-      // Set RD(PH6) to High
-      PORTH |= (1 << 6);
-    }
-
-    // Read the remaining 64bits into array
-    for (byte currBit = 0; currBit < 64; currBit++) {
-      // Set RD(PH6) to LOW
-      PORTH &= ~(1 << 6);
-      // Set RD(PH6) to High
-      PORTH |= (1 << 6);
-
-      // Read bit from A0(PF0)
-      tempBits[currBit] = (PINF & 0x1);
-    }
-
-    // Set CS_ROM(PH3) to High
-    PORTH |= (1 << 3);
-    // Set A0(PF0) to High
-    PORTF |= (1 << 0);
-    // Set A0(PF0) to Output
-    DDRF |= (1 << 0);
-
-    // OR 8 bits into one byte for a total of 8 bytes
-    for (byte j = 0; j < 64; j += 8) {
-      sdBuffer[((currAddr - startAddress) * 8) + (j / 8)] = tempBits[0 + j] << 7 | tempBits[1 + j] << 6 | tempBits[2 + j] << 5 | tempBits[3 + j] << 4 | tempBits[4 + j] << 3 | tempBits[5 + j] << 2 | tempBits[6 + j] << 1 | tempBits[7 + j];
-    }
+  for (word currBlock = 0; currBlock < 64; currBlock++) {
+    GbaEeprom<GbaEepPins>::readBlock(startAddress + currBlock, addressBits, sdBuffer + currBlock * 8);
   }
 }
 
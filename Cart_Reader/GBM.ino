@@ -14,14 +14,15 @@ static const char gbmMenuItem4[] PROGMEM = "Blankcheck";
 static const char gbmMenuItem5[] PROGMEM = "Write Flash";
 static const char gbmMenuItem6[] PROGMEM = "Read Mapping";
 static const char gbmMenuItem7[] PROGMEM = "Write Mapping";
-static const char* const menuOptionsGBM[] PROGMEM = { gbmMenuItem1, gbmMenuItem2, gbmMenuItem3, gbmMenuItem4, gbmMenuItem5, gbmMenuItem6, gbmMenuItem7 };
+static const char gbmMenuItem8[] PROGMEM = "Update Flash";
+static const char* const menuOptionsGBM[] PROGMEM = { gbmMenuItem1, gbmMenuItem2, gbmMenuItem3, gbmMenuItem4, gbmMenuItem5, gbmMenuItem6, gbmMenuItem7, gbmMenuItem8 };
 
 void gbmMenu() {
-  // create menu with title and 7 options to choose from
+  // create menu with title and 8 options to choose from
   unsigned char mainMenu;
   // Copy menuOptions out of progmem
-  convertPgm(menuOptionsGBM, 7);
-  mainMenu = question_box(F("GB Memory Menu"), menuOptions, 7, 0);
+  convertPgm(menuOptionsGBM, 8);
+  mainMenu = question_box(F("GB Memory Menu"), menuOptions, 8, 0);
 
   // wait for user choice to come back from the question box menu
   switch (mainMenu) {
@@ -175,6 +176,29 @@ void gbmMenu() {
       // Write mapping
       writeMapping_GBM();
       break;
+
+    // Update flash, only rewrites the sectors and the mapping that changed
+    case 7:
+      // Clear screen
+      display_Clear();
+
+      filePath[0] = '\0';
+      sd.chdir("/");
+      // Launch file browser
+      fileBrowser(F("Select 1MB file"));
+      display_Clear();
+      sprintf(filePath, "%s/%s", filePath, fileName);
+      updateFlash_GBM();
+
+      // Clear filepath
+      filePath[0] = '\0';
+      sd.chdir("/");
+      // Launch file browser
+      fileBrowser(F("Select MAP file"));
+      display_Clear();
+      sprintf(filePath, "%s/%s", filePath, fileName);
+      updateMapping_GBM();
+      break;
 #endif
 
     default:
@@ -919,6 +943,248 @@ void writeMapping_GBM() {
     print_Error(open_file_STR);
   }
 }
+
+/**********************
+  Differential update
+**********************/
+// Set the rom bank while ports 0x2100 and 0x120 are disabled for flash writes
+void setBank_GBM(byte currBank) {
+  // Enable access to ports 0x120 and 0x2100
+  send_GBM(0x09);
+  send_GBM(0x11);
+
+  // Set bank
+  writeByte_GBM(0x2100, currBank);
+
+  // Disable ports 0x2100 and 0x120 or else those addresses will not be writable
+  send_GBM(0x10);
+  send_GBM(0x08);
+}
+
+// Select the bank of a flash address and return where it shows up, the first 32KB are visible with bank 1
+word mapAddress_GBM(unsigned long flashAddress) {
+  if (flashAddress < 0x8000) {
+    setBank_GBM(1);
+    return flashAddress;
+  }
+  setBank_GBM(flashAddress >> 14);
+  return 0x4000 | (flashAddress & 0x3FFF);
+}
+
+// MX29F008TC sectors: 15 x 64KB, then 32KB, 8KB, 8KB and 16KB at the top
+unsigned long sectorSize_GBM(unsigned long sectorAddress) {
+  if (sectorAddress < 0xF0000)
+    return 0x10000;
+  if (sectorAddress < 0xF8000)
+    return 0x8000;
+  if (sectorAddress < 0xFC000)
+    return 0x2000;
+  return 0x4000;
+}
+
+void eraseSector_GBM(unsigned long sectorAddress) {
+  // Erase command sequence, writes to 0x5555 need odd bank number
+  setBank_GBM(1);
+  writeByte_GBM(0x5555, 0xAA);
+  writeByte_GBM(0x2AAA, 0x55);
+  writeByte_GBM(0x5555, 0x80);
+  writeByte_GBM(0x5555, 0xAA);
+  writeByte_GBM(0x2AAA, 0x55);
+
+  word currAddress = mapAddress_GBM(sectorAddress);
+  writeByte_GBM(currAddress, 0x30);
+
+  // Wait for erase to complete
+  while ((readByte_GBM(currAddress) & 0x80) != 0x80) {}
+}
+
+// Program one 128 byte page out of sdBuffer
+void writePage_GBM(unsigned long flashAddress) {
+  // Write flash buffer command
+  setBank_GBM(1);
+  writeByte_GBM(0x5555, 0xAA);
+  writeByte_GBM(0x2AAA, 0x55);
+  writeByte_GBM(0x5555, 0xA0);
+
+  // Wait until flashrom is ready again
+  while ((readByte_GBM(0) & 0x80) != 0x80) {}
+
+  // Fill flash buffer
+  word currAddress = mapAddress_GBM(flashAddress);
+  for (word currByte = 0; currByte < 128; currByte++) {
+    writeByte_GBM(currAddress + currByte, sdBuffer[currByte]);
+  }
+  // Execute write
+  writeByte_GBM(currAddress + 127, 0xFF);
+
+  // Wait for write to complete
+  while ((readByte_GBM(currAddress) & 0x80) != 0x80) {}
+}
+
+// Compare a sector with the open file, returns 0 if it matches, 1 if the file can be programmed over it and 2 if it needs an erase first
+byte compareSector_GBM(unsigned long sectorAddress, unsigned long length) {
+  byte result = 0;
+  for (unsigned long offset = 0; offset < length; offset += 512) {
+    myFile.read(sdBuffer, 512);
+    word currAddress = mapAddress_GBM(sectorAddress + offset);
+    for (word c = 0; c < 512; c++) {
+      byte flashByte = readByte_GBM(currAddress + c);
+      if (flashByte != sdBuffer[c]) {
+        // Programming can only clear bits
+        if ((flashByte & sdBuffer[c]) != sdBuffer[c])
+          return 2;
+        result = 1;
+      }
+    }
+  }
+  return result;
+}
+
+// Program the pages of a sector that differ from the open file, after an erase this skips the blank pages
+void programSector_GBM(unsigned long sectorAddress, unsigned long length) {
+  for (unsigned long offset = 0; offset < length; offset += 128) {
+    myFile.read(sdBuffer, 128);
+    word currAddress = mapAddress_GBM(sectorAddress + offset);
+    for (word c = 0; c < 128; c++) {
+      if (readByte_GBM(currAddress + c) != sdBuffer[c]) {
+        writePage_GBM(sectorAddress + offset);
+        break;
+      }
+    }
+    // Blink led
+    blinkLED();
+  }
+}
+
+// Bring the flash up to date with a 1MB file, only the sectors that changed get erased and programmed
+void updateFlash_GBM() {
+  println_Msg(F("Updating..."));
+  display_Update();
+
+  // Open file on sd card
+  if (!myFile.open(filePath, O_READ))
+    print_FatalError(open_file_STR);
+  // Get rom size from file
+  fileSize = myFile.fileSize();
+  if ((fileSize / 0x4000) > 64) {
+    print_FatalError(F("File is too big."));
+  }
+
+  // Enable access to ports 0120h
+  send_GBM(0x09);
+  // Enable write
+  send_GBM(0x0A);
+  send_GBM(0x2);
+
+  // Map entire flash rom
+  send_GBM(0x4);
+
+  // Unprotect sector 0
+  setBank_GBM(1);
+  writeByte_GBM(0x5555, 0xAA);
+  writeByte_GBM(0x2AAA, 0x55);
+  writeByte_GBM(0x5555, 0x60);
+  writeByte_GBM(0x5555, 0xAA);
+  writeByte_GBM(0x2AAA, 0x55);
+  writeByte_GBM(0x5555, 0x40);
+
+  // Check if flashrom is ready for writing or busy
+  while ((readByte_GBM(0) & 0x80) != 0x80) {}
+
+  byte changed = 0;
+  byte erased = 0;
+  draw_progressbar(0, fileSize);
+  for (unsigned long sectorAddress = 0; sectorAddress < fileSize; sectorAddress += sectorSize_GBM(sectorAddress)) {
+    unsigned long length = min(sectorSize_GBM(sectorAddress), fileSize - sectorAddress);
+
+    myFile.seekSet(sectorAddress);
+    byte state = compareSector_GBM(sectorAddress, length);
+    if (state != 0) {
+      if (state == 2) {
+        eraseSector_GBM(sectorAddress);
+        erased++;
+      }
+      myFile.seekSet(sectorAddress);
+      programSector_GBM(sectorAddress, length);
+
+      // Check the sector
+      myFile.seekSet(sectorAddress);
+      if (compareSector_GBM(sectorAddress, length) != 0) {
+        myFile.close();
+        print_FatalError(did_not_verify_STR);
+      }
+      changed++;
+    }
+    draw_progressbar(sectorAddress + length, fileSize);
+  }
+  myFile.close();
+
+  print_Msg(changed, DEC);
+  print_Msg(F(" written, "));
+  print_Msg(erased, DEC);
+  println_Msg(F(" erased"));
+  display_Update();
+}
+
+// Compare the hidden mapping area with the MAP file, returns 1 if they match
+boolean compareMapping_GBM() {
+  boolean same = 1;
+
+  if (!myFile.open(filePath, O_READ))
+    print_FatalError(open_file_STR);
+  myFile.read(sdBuffer, 128);
+  myFile.close();
+
+  // Enable ports 0x0120
+  send_GBM(0x09);
+
+  // Set WE and WP
+  send_GBM(0x0A);
+  send_GBM(0x2);
+
+  // Enable hidden mapping area
+  writeByte_GBM(0x2100, 0x01);
+  send_GBM(0x0F, 0x5555, 0xAA);
+  send_GBM(0x0F, 0x2AAA, 0x55);
+  send_GBM(0x0F, 0x5555, 0x77);
+  send_GBM(0x0F, 0x5555, 0xAA);
+  send_GBM(0x0F, 0x2AAA, 0x55);
+  send_GBM(0x0F, 0x5555, 0x77);
+
+  for (byte currByte = 0; currByte < 128; currByte++) {
+    if (readByte_GBM(currByte) != sdBuffer[currByte]) {
+      same = 0;
+      break;
+    }
+  }
+
+  // Reset flash to leave hidden mapping area
+  resetFlash_GBM();
+  return same;
+}
+
+// Rewrite the mapping only if the MAP file differs from it
+void updateMapping_GBM() {
+  print_Msg(F("Mapping..."));
+  display_Update();
+  if (compareMapping_GBM()) {
+    println_Msg(F("unchanged"));
+    display_Update();
+    return;
+  }
+  println_Msg(F("changed"));
+  display_Update();
+
+  // Erase mapping
+  eraseMapping_GBM();
+  if (!blankcheckMapping_GBM())
+    print_FatalError(F("Erasing failed"));
+  println_Msg(FS(FSTRING_OK));
+  display_Update();
+
+  // Write mapping
+  writeMapping_GBM();
+}
 #endif
 #endif
 
@@ -16,8 +16,9 @@ static const char *const menuOptionsGBSmart[] PROGMEM = { gbSmartMenuItem1, gbSm
 
 static const char gbSmartFlashMenuItem1[] PROGMEM = "Read Flash";
 static const char gbSmartFlashMenuItem2[] PROGMEM = "Write Flash";
-static const char gbSmartFlashMenuItem3[] PROGMEM = "Back";
-static const char *const menuOptionsGBSmartFlash[] PROGMEM = { gbSmartFlashMenuItem1, gbSmartFlashMenuItem2, gbSmartFlashMenuItem3 };
+static const char gbSmartFlashMenuItem3[] PROGMEM = "Update Flash";
+static const char gbSmartFlashMenuItem4[] PROGMEM = "Back";
+static const char *const menuOptionsGBSmartFlash[] PROGMEM = { gbSmartFlashMenuItem1, gbSmartFlashMenuItem2, gbSmartFlashMenuItem3, gbSmartFlashMenuItem4 };
 
 static const char gbSmartGameMenuItem1[] PROGMEM = "Read Game";
 static const char gbSmartGameMenuItem4[] PROGMEM = "Switch Game";
@@ -47,6 +48,9 @@ uint16_t gameMenuStartBank;
 
 // Compare checksum
 boolean compare_checksum_GBS() {
+  if (!dumpSaved())
+    return 0;
+
   println_Msg(F("Calculating Checksum"));
   display_Update();
 
@@ -197,8 +201,7 @@ void gbSmartGameOptions() {
       {
         display_Clear();
         sd.chdir("/");
-        writeSRAM_GB();
-        uint32_t wrErrors = verifySRAM_GB();
+        uint32_t wrErrors = writeSRAM_GB();
         if (wrErrors == 0) {
           println_Msg(F("Verified OK"));
           display_Update();
@@ -272,8 +275,8 @@ gb_smart_load_more_games:
 void gbSmartFlashMenu() {
   uint8_t flashSubMenu;
 
-  convertPgm(menuOptionsGBSmartFlash, 3);
-  flashSubMenu = question_box(F("GB Smart Flash Menu"), menuOptions, 3, 0);
+  convertPgm(menuOptionsGBSmartFlash, 4);
+  flashSubMenu = question_box(F("GB Smart Flash Menu"), menuOptions, 4, 0);
 
   switch (flashSubMenu) {
     case 0:
@@ -315,6 +318,18 @@ void gbSmartFlashMenu() {
         gbSmartWriteFlash();
         break;
       }
+    case 2:
+      {
+        // update flash, only rewrites the blocks that changed
+        display_Clear();
+        filePath[0] = '\0';
+        sd.chdir("/");
+        fileBrowser(F("Select 4MB file"));
+
+        sprintf(filePath, "%s/%s", filePath, fileName);
+        gbSmartUpdateFlash();
+        break;
+      }
     default:
       {
         mode = CORE_GB_GBSMART;
@@ -515,30 +530,34 @@ void gbSmartWriteFlash(uint32_t start_bank) {
 void gbSmartWriteFlashFromMyFile(uint32_t addr) {
   for (uint16_t i = 0; i < 16384; i += 256) {
     myFile.read(sdBuffer, 256);
+    gbSmartWriteFlashPage(addr, i);
+  }
 
-    // sequence load to page
-    dataOut();
-    gbSmartWriteFlashByte(addr, 0xe0);
-    gbSmartWriteFlashByte(addr, 0xff);
-    gbSmartWriteFlashByte(addr, 0x00);  // BCH should be 0x00
+  // blink LED
+  blinkLED();
+}
 
-    // fill page buffer
-    for (int d = 0; d < 256; d++)
-      gbSmartWriteFlashByte(d, sdBuffer[d]);
+// write the 256 bytes in sdBuffer to the page at addr + offset
+void gbSmartWriteFlashPage(uint32_t addr, uint16_t offset) {
+  // sequence load to page
+  dataOut();
+  gbSmartWriteFlashByte(addr, 0xe0);
+  gbSmartWriteFlashByte(addr, 0xff);
+  gbSmartWriteFlashByte(addr, 0x00);  // BCH should be 0x00
 
-    // start flashing page
-    gbSmartWriteFlashByte(addr, 0x0c);
-    gbSmartWriteFlashByte(addr, 0xff);
-    gbSmartWriteFlashByte(addr + i, 0x00);  // BCH should be 0x00
+  // fill page buffer
+  for (int d = 0; d < 256; d++)
+    gbSmartWriteFlashByte(d, sdBuffer[d]);
 
-    // waiting for finishing
-    dataIn();
-    while ((readByte_GBS(addr + i) & 0x80) == 0x00)
-      ;
-  }
+  // start flashing page
+  gbSmartWriteFlashByte(addr, 0x0c);
+  gbSmartWriteFlashByte(addr, 0xff);
+  gbSmartWriteFlashByte(addr + offset, 0x00);  // BCH should be 0x00
 
-  // blink LED
-  blinkLED();
+  // waiting for finishing
+  dataIn();
+  while ((readByte_GBS(addr + offset) & 0x80) == 0x00)
+    ;
 }
 
 uint32_t gbSmartVerifyFlash() {
@@ -623,34 +642,155 @@ void gbSmartEraseFlash(uint8_t flash_start_bank) {
   gbSmartRemapStartBank(flash_start_bank, gbSmartFlashSizeGB, gbSmartSramSizeGB);
 
   // handling first flash block
+  gbSmartEraseFlashBlock(0x0000);
+
+  // rest of flash block
+  for (uint32_t ba = gbSmartBanksPerFlashBlock; ba < gbSmartBanksPerFlashChip; ba += gbSmartBanksPerFlashBlock) {
+    dataOut();
+    writeByte_GB(0x2100, ba);
+
+    gbSmartEraseFlashBlock(0x4000);
+  }
+}
+
+void gbSmartEraseFlashBlock(uint16_t addr) {
   dataOut();
-  gbSmartWriteFlashByte(0x0000, 0x20);
-  gbSmartWriteFlashByte(0x0000, 0xd0);
+  gbSmartWriteFlashByte(addr, 0x20);
+  gbSmartWriteFlashByte(addr, 0xd0);
 
   dataIn();
-  while ((readByte_GBS(0x0000) & 0x80) == 0x00)
+  while ((readByte_GBS(addr) & 0x80) == 0x00)
     ;
 
   // blink LED
   blinkLED();
+}
 
-  // rest of flash block
-  for (uint32_t ba = gbSmartBanksPerFlashBlock; ba < gbSmartBanksPerFlashChip; ba += gbSmartBanksPerFlashBlock) {
-    dataOut();
-    writeByte_GB(0x2100, ba);
+// switch to a bank of the remapped flash chip, returns the address it shows up at
+uint16_t gbSmartSelectBank(uint8_t bank) {
+  if (bank == 0x00)
+    return 0x0000;
 
-    gbSmartWriteFlashByte(0x4000, 0x20);
-    gbSmartWriteFlashByte(0x4000, 0xd0);
+  dataOut();
+  writeByte_GB(0x2100, bank);
+  return 0x4000;
+}
+
+// compare a flash block with myFile, returns 0 if it matches, 1 if the file can be programmed over it and 2 if it needs an erase first
+byte gbSmartCompareFlashBlock(uint8_t block_bank) {
+  byte result = 0;
+
+  for (uint8_t bank = block_bank; bank < block_bank + gbSmartBanksPerFlashBlock; bank++) {
+    uint16_t base = gbSmartSelectBank(bank);
 
     dataIn();
-    while ((readByte_GBS(0x4000) & 0x80) == 0x00)
-      ;
+    for (uint16_t addr = 0x0000; addr < 0x4000; addr += 512) {
+      myFile.read(sdBuffer, 512);
+
+      for (uint16_t c = 0; c < 512; c++) {
+        uint8_t flashByte = readByte_GBS(base + addr + c);
+        if (flashByte != sdBuffer[c]) {
+          // programming can only clear bits
+          if ((flashByte & sdBuffer[c]) != sdBuffer[c])
+            return 2;
+          result = 1;
+        }
+      }
+    }
+  }
+
+  return result;
+}
+
+// program the pages of a flash block that differ from myFile, after an erase this skips the blank pages
+void gbSmartWriteFlashBlock(uint8_t block_bank) {
+  for (uint8_t bank = block_bank; bank < block_bank + gbSmartBanksPerFlashBlock; bank++) {
+    uint16_t base = gbSmartSelectBank(bank);
+
+    for (uint16_t i = 0; i < 16384; i += 256) {
+      myFile.read(sdBuffer, 256);
+
+      dataIn();
+      for (uint16_t c = 0; c < 256; c++) {
+        if (readByte_GBS(base + i + c) != sdBuffer[c]) {
+          gbSmartWriteFlashPage(base, i);
+
+          // back to read array
+          dataOut();
+          gbSmartWriteFlashByte(base, 0xff);
+          break;
+        }
+      }
+    }
 
     // blink LED
     blinkLED();
   }
 }
 
+// bring the flash up to date with a file, only the blocks that changed get erased and programmed
+void gbSmartUpdateFlash() {
+  if (!myFile.open(filePath, O_READ))
+    print_FatalError(open_file_STR);
+
+  fileSize = myFile.fileSize();
+  if ((fileSize > gbSmartSize) || (fileSize % gbSmartFlashBlockSize))
+    print_FatalError(F("Wrong file size"));
+
+  println_Msg(F("Updating..."));
+  display_Update();
+
+  uint8_t changed = 0;
+  uint8_t erased = 0;
+  uint16_t fileBanks = fileSize >> 14;
+  draw_progressbar(0, fileBanks);
+
+  for (uint16_t chip = 0x00; chip < fileBanks; chip += gbSmartBanksPerFlashChip) {
+    // map the chip and put it in read array state
+    gbSmartResetFlash(chip);
+
+    for (uint16_t block = 0x00; block < gbSmartBanksPerFlashChip && chip + block < fileBanks; block += gbSmartBanksPerFlashBlock) {
+      uint32_t blockPos = (uint32_t)(chip + block) << 14;
+
+      myFile.seekSet(blockPos);
+      byte state = gbSmartCompareFlashBlock(block);
+      if (state != 0) {
+        if (state == 2) {
+          uint16_t base = gbSmartSelectBank(block);
+          gbSmartEraseFlashBlock(base);
+
+          // back to read array
+          dataOut();
+          gbSmartWriteFlashByte(base, 0xff);
+          erased++;
+        }
+        myFile.seekSet(blockPos);
+        gbSmartWriteFlashBlock(block);
+
+        // check the block
+        myFile.seekSet(blockPos);
+        if (gbSmartCompareFlashBlock(block) != 0) {
+          myFile.close();
+          print_FatalError(did_not_verify_STR);
+        }
+        changed++;
+      }
+      draw_progressbar(chip + block + gbSmartBanksPerFlashBlock, fileBanks);
+    }
+  }
+  myFile.close();
+
+  // back to initial state
+  gbSmartRemapStartBank(0x00, gbSmartRomSizeGB, gbSmartSramSizeGB);
+  writeByte_GB(0x2100, 0x01);
+
+  print_Msg(changed, DEC);
+  print_Msg(F(" written, "));
+  print_Msg(erased, DEC);
+  println_Msg(F(" erased"));
+  display_Update();
+}
+
 void gbSmartWriteFlashByte(uint32_t myAddress, uint8_t myData) {
   PORTF = myAddress & 0xff;
   PORTK = (myAddress >> 8) & 0xff;
@@ -0,0 +1,268 @@
+/********************************************************************
+*                   Open Source Cartridge Reader                    */
+/*H******************************************************************
+* FILENAME :        Hash.cpp
+*
+* DESCRIPTION :
+*       SHA-1 (FIPS 180-4) and MD5 (RFC 1321), sized for the ATmega.
+*
+* PUBLIC FUNCTIONS :
+*       void    sha1Init( Context )
+*       void    sha1Update( Context, Data, Length )
+*       void    sha1Final( Context, Digest )
+*       void    md5Init( Context )
+*       void    md5Update( Context, Data, Length )
+*       void    md5Final( Context, Digest )
+*
+* NOTES :
+*       SHA-1 keeps a rolling 16 word message schedule instead of the
+*       usual 80 words, which saves 256 bytes of stack per block. The
+*       MD5 constants live in flash on AVR. Rotations are written so
+*       avr-gcc can turn them into byte moves where the count allows.
+*
+*H*/
+
+#include <string.h>
+#include "Hash.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define HASH_TABLE PROGMEM
+#define hashRead32(p) pgm_read_dword(p)
+#define hashRead8(p) pgm_read_byte(p)
+#else
+#define HASH_TABLE
+#define hashRead32(p) (*(p))
+#define hashRead8(p) (*(p))
+#endif
+
+static inline uint32_t rol32(uint32_t value, uint8_t count) {
+  return (value << count) | (value >> (32 - count));
+}
+
+/*==== SHA-1 ======================================================*/
+
+static uint32_t readBE32(const uint8_t* p) {
+  return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+/*F******************************************************************
+* NAME :            void sha1Block( Context )
+*
+* DESCRIPTION :     Compress the 64 byte block of the context
+*
+*F*/
+static void sha1Block(Sha1Context* context) {
+  uint32_t w[16];
+  uint32_t a = context->state[0];
+  uint32_t b = context->state[1];
+  uint32_t c = context->state[2];
+  uint32_t d = context->state[3];
+  uint32_t e = context->state[4];
+
+  for (uint8_t i = 0; i < 16; i++) {
+    w[i] = readBE32(context->block + i * 4);
+  }
+
+  for (uint8_t i = 0; i < 80; i++) {
+    uint32_t f, k;
+
+    if (i >= 16) {
+      // Rolling schedule, w[i & 15] still holds w[i - 16]
+      uint32_t next = w[(i + 13) & 15] ^ w[(i + 8) & 15] ^ w[(i + 2) & 15] ^ w[i & 15];
+      w[i & 15] = rol32(next, 1);
+    }
+
+    if (i < 20) {
+      f = (b & c) | (~b & d);
+      k = 0x5A827999;
+    } else if (i < 40) {
+      f = b ^ c ^ d;
+      k = 0x6ED9EBA1;
+    } else if (i < 60) {
+      f = (b & c) | (b & d) | (c & d);
+      k = 0x8F1BBCDC;
+    } else {
+      f = b ^ c ^ d;
+      k = 0xCA62C1D6;
+    }
+
+    uint32_t temp = rol32(a, 5) + f + e + k + w[i & 15];
+    e = d;
+    d = c;
+    c = rol32(b, 30);
+    b = a;
+    a = temp;
+  }
+
+  context->state[0] += a;
+  context->state[1] += b;
+  context->state[2] += c;
+  context->state[3] += d;
+  context->state[4] += e;
+}
+
+void sha1Init(Sha1Context* context) {
+  context->state[0] = 0x67452301;
+  context->state[1] = 0xEFCDAB89;
+  context->state[2] = 0x98BADCFE;
+  context->state[3] = 0x10325476;
+  context->state[4] = 0xC3D2E1F0;
+  context->length = 0;
+}
+
+void sha1Update(Sha1Context* context, const uint8_t* data, size_t length) {
+  uint8_t used = context->length & 63;
+
+  context->length += length;
+  while (length > 0) {
+    uint8_t chunk = ((size_t)(64 - used) < length) ? (64 - used) : length;
+    memcpy(context->block + used, data, chunk);
+    used += chunk;
+    data += chunk;
+    length -= chunk;
+    if (used == 64) {
+      sha1Block(context);
+      used = 0;
+    }
+  }
+}
+
+void sha1Final(Sha1Context* context, uint8_t digest[SHA1_DIGEST_SIZE]) {
+  uint64_t bits = (uint64_t)context->length << 3;
+  uint8_t used = context->length & 63;
+
+  // Padding: 0x80, zeros and the bit length as 64 bit big endian
+  context->block[used++] = 0x80;
+  if (used > 56) {
+    memset(context->block + used, 0, 64 - used);
+    sha1Block(context);
+    used = 0;
+  }
+  memset(context->block + used, 0, 56 - used);
+  for (uint8_t i = 0; i < 8; i++) {
+    context->block[63 - i] = bits >> (i * 8);
+  }
+  sha1Block(context);
+
+  for (uint8_t i = 0; i < SHA1_DIGEST_SIZE; i++) {
+    digest[i] = context->state[i / 4] >> (24 - (i % 4) * 8);
+  }
+}
+
+/*==== /SHA-1 =====================================================*/
+
+/*==== MD5 ========================================================*/
+
+// floor(abs(sin(i + 1)) * 2^32)
+static const uint32_t md5K[64] HASH_TABLE = {
+  0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+  0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+  0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+  0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+  0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+  0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+  0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+  0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+// Rotation amounts, the same four repeat within each round
+static const uint8_t md5R[16] HASH_TABLE = {
+  7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21
+};
+
+static uint32_t readLE32(const uint8_t* p) {
+  return ((uint32_t)p[3] << 24) | ((uint32_t)p[2] << 16) | ((uint32_t)p[1] << 8) | p[0];
+}
+
+/*F******************************************************************
+* NAME :            void md5Block( Context )
+*
+* DESCRIPTION :     Compress the 64 byte block of the context
+*
+*F*/
+static void md5Block(Md5Context* context) {
+  uint32_t a = context->state[0];
+  uint32_t b = context->state[1];
+  uint32_t c = context->state[2];
+  uint32_t d = context->state[3];
+
+  for (uint8_t i = 0; i < 64; i++) {
+    uint32_t f;
+    uint8_t g;
+
+    if (i < 16) {
+      f = (b & c) | (~b & d);
+      g = i;
+    } else if (i < 32) {
+      f = (d & b) | (~d & c);
+      g = (5 * i + 1) & 15;
+    } else if (i < 48) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) & 15;
+    } else {
+      f = c ^ (b | ~d);
+      g = (7 * i) & 15;
+    }
+
+    f += a + hashRead32(&md5K[i]) + readLE32(context->block + g * 4);
+    a = d;
+    d = c;
+    c = b;
+    b += rol32(f, hashRead8(&md5R[((i >> 4) << 2) | (i & 3)]));
+  }
+
+  context->state[0] += a;
+  context->state[1] += b;
+  context->state[2] += c;
+  context->state[3] += d;
+}
+
+void md5Init(Md5Context* context) {
+  context->state[0] = 0x67452301;
+  context->state[1] = 0xEFCDAB89;
+  context->state[2] = 0x98BADCFE;
+  context->state[3] = 0x10325476;
+  context->length = 0;
+}
+
+void md5Update(Md5Context* context, const uint8_t* data, size_t length) {
+  uint8_t used = context->length & 63;
+
+  context->length += length;
+  while (length > 0) {
+    uint8_t chunk = ((size_t)(64 - used) < length) ? (64 - used) : length;
+    memcpy(context->block + used, data, chunk);
+    used += chunk;
+    data += chunk;
+    length -= chunk;
+    if (used == 64) {
+      md5Block(context);
+      used = 0;
+    }
+  }
+}
+
+void md5Final(Md5Context* context, uint8_t digest[MD5_DIGEST_SIZE]) {
+  uint64_t bits = (uint64_t)context->length << 3;
+  uint8_t used = context->length & 63;
+
+  // Padding: 0x80, zeros and the bit length as 64 bit little endian
+  context->block[used++] = 0x80;
+  if (used > 56) {
+    memset(context->block + used, 0, 64 - used);
+    md5Block(context);
+    used = 0;
+  }
+  memset(context->block + used, 0, 56 - used);
+  for (uint8_t i = 0; i < 8; i++) {
+    context->block[56 + i] = bits >> (i * 8);
+  }
+  md5Block(context);
+
+  for (uint8_t i = 0; i < MD5_DIGEST_SIZE; i++) {
+    digest[i] = context->state[i / 4] >> ((i % 4) * 8);
+  }
+}
+
+/*==== /MD5 =======================================================*/
@@ -0,0 +1,62 @@
+/********************************************************************
+*                   Open Source Cartridge Reader                    *
+********************************************************************/
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*H******************************************************************
+* FILENAME :        Hash.h
+*
+* DESCRIPTION :
+*       Incremental SHA-1 and MD5 for hashing dumps block by block in
+*       the same pass as the CRC32, see OPTION_HASH_SHA1/_MD5.
+*
+* USAGE :
+*       Sha1Context sha1;
+*       sha1Init(&sha1);
+*       sha1Update(&sha1, sdBuffer, 512);
+*       sha1Final(&sha1, digest);
+*
+* NOTES :
+*       Plain C++ without Arduino dependencies so the host benchmark in
+*       tools/hash_bench builds the very same code. Each context needs
+*       about 90 bytes of RAM.
+*
+*H*/
+
+/*==== SHA-1 ======================================================*/
+
+#define SHA1_DIGEST_SIZE 20
+
+struct Sha1Context {
+  uint32_t state[5];
+  uint32_t length;
+  uint8_t block[64];
+};
+
+void sha1Init(Sha1Context* context);
+void sha1Update(Sha1Context* context, const uint8_t* data, size_t length);
+void sha1Final(Sha1Context* context, uint8_t digest[SHA1_DIGEST_SIZE]);
+
+/*==== /SHA-1 =====================================================*/
+
+/*==== MD5 ========================================================*/
+
+#define MD5_DIGEST_SIZE 16
+
+struct Md5Context {
+  uint32_t state[4];
+  uint32_t length;
+  uint8_t block[64];
+};
+
+void md5Init(Md5Context* context);
+void md5Update(Md5Context* context, const uint8_t* data, size_t length);
+void md5Final(Md5Context* context, uint8_t digest[MD5_DIGEST_SIZE]);
+
+/*==== /MD5 =======================================================*/
+
+#endif /* HASH_H_ */
@@ -667,55 +667,76 @@ void printDataLine_INTV(void* entry) {
   println_Msg(castEntry->gameMapper);
 }
 
+// Start of the first ROM segment of the mappers, see MAPPER ROM ADDRESSES
+static const uint16_t startAddress_INTV[] PROGMEM = { 0x5000, 0x6000, 0x4800 };
+
+// CRC32 of the first 512 bytes of the ROM, the fingerprint in field 1 of intv.txt
+uint32_t crc512_INTV(uint32_t startaddr) {
+  for (uint16_t w = 0; w < 256; w++) {
+    uint16_t temp = readData_INTV(startaddr + w);
+    sdBuffer[w * 2] = (temp >> 8) & 0xFF;
+    sdBuffer[(w * 2) + 1] = temp & 0xFF;
+  }
+  return calculateCRC(sdBuffer, 512);
+}
+
 void setCart_INTV() {
   //go to root
   sd.chdir();
 
   struct database_entry_INTV entry;
+  boolean selected = false;
 
-  // Select starting letter
-  byte myLetter = starting_letter();
+  // Known carts are identified by their first 512 bytes, the others are selected from the list
+  for (byte i = 0; (i < sizeof(startAddress_INTV) / sizeof(startAddress_INTV[0])) && !selected; i++) {
+    selected = findFingerprint(myFile, "intv.txt", 1, crc512_INTV(pgm_read_word(&(startAddress_INTV[i]))));
+  }
+  if (selected) {
+    autoCartSelection(myFile, &readDataLine_INTV, &entry, &printDataLine_INTV);
+  } else {
+    // Select starting letter
+    byte myLetter = starting_letter();
 
-  // Open database
-  if (myFile.open("intv.txt", O_READ)) {
+    // Open database
+    if (!myFile.open("intv.txt", O_READ))
+      print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
     seek_first_letter_in_database(myFile, myLetter);
+    selected = checkCartSelection(myFile, &readDataLine_INTV, &entry, &printDataLine_INTV);
+  }
 
-    if (checkCartSelection(myFile, &readDataLine_INTV, &entry, &printDataLine_INTV)) {
-      //byte INTV[] = {8, 12, 16, 24, 32, 48};
-      switch (entry.gameSize) {
-        case 8:
-          intvsize = 0;
-          break;
+  if (selected) {
+    //byte INTV[] = {8, 12, 16, 24, 32, 48};
+    switch (entry.gameSize) {
+      case 8:
+        intvsize = 0;
+        break;
 
-        case 12:
-          intvsize = 1;
-          break;
+      case 12:
+        intvsize = 1;
+        break;
 
-        case 16:
-          intvsize = 2;
-          break;
+      case 16:
+        intvsize = 2;
+        break;
 
-        case 24:
-          intvsize = 3;
-          break;
+      case 24:
+        intvsize = 3;
+        break;
 
-        case 32:
-          intvsize = 4;
-          break;
+      case 32:
+        intvsize = 4;
+        break;
 
-        case 48:
-          intvsize = 5;
-          break;
+      case 48:
+        intvsize = 5;
+        break;
 
-        default:
-          intvsize = 0;
-          break;
-      }
-      EEPROM_writeAnything(7, entry.gameMapper);
-      EEPROM_writeAnything(8, intvsize);
+      default:
+        intvsize = 0;
+        break;
     }
-  } else {
-    print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
+    EEPROM_writeAnything(7, entry.gameMapper);
+    EEPROM_writeAnything(8, intvsize);
   }
 }
 #endif
@@ -49,14 +49,15 @@ byte jagSaveType = 0;  // Serial EEPROM
 // 3 = 93C76 = 1024 byte = Aftermarket
 // 4 = 93C86 = 2048 byte = Aftermarket - Battlesphere Gold
 int jagEepSize;
-byte jagEepBuf[2];
-boolean jagEepBit[16];
 
 // MEMORY TRACK CART
 boolean jagMemorytrack = 0;
 char jagFlashID[5];            // AT29C010 = "1FD5"
 unsigned long jagflaSize = 0;  // AT29C010 = 128K
 
+// ADDRESS CURRENTLY LATCHED ON THE 74HC595 OUTPUTS
+unsigned long jagLatchedAddress = 0xFFFFFFFF;
+
 // JAGUAR EEPROM MAPPING
 // 08 ROM SIZE
 // 10 EEP SIZE
@@ -375,6 +376,11 @@ void jagEepMenu() {
 //  SETUP
 //******************************************
 void setup_Jag() {
+  // Start from the power on defaults, a warm restart keeps the last cart's values
+  jagMemorytrack = 0;
+  jagSaveType = 0;
+  jagLatchedAddress = 0xFFFFFFFF;
+
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
@@ -487,35 +493,53 @@ void getJagCartInfo() {
 #define LATCH_CLEAR PORTG &= ~(1 << 5);
 #define LATCH_SET PORTG |= (1 << 5);
 
+// SER IS SAMPLED ON THE RISING EDGE OF SRCLK
+// CONSTANT MASKS SO EACH BIT IS A FEW SBI/CBI, A VARIABLE (1 << i) IS A SHIFT LOOP ON AVR
+#define SHIFT_BIT(addr, mask) \
+  if ((addr) & (mask)) { \
+    SER_SET \
+  } else { \
+    SER_CLEAR \
+  } \
+  CLOCK_SET \
+  CLOCK_CLEAR
+
 // INPUT ADDRESS BYTE IN MSB
 // LATCH LO BEFORE FIRST SHIFTOUT
 // LATCH HI AFTER LAST SHIFOUT
-void shiftOutFAST(byte addr) {    //
-  for (int i = 7; i >= 0; i--) {  // MSB
-    CLOCK_CLEAR;
-    if (addr & (1 << i)) {
-      SER_SET;  // 1
-    } else {
-      SER_CLEAR;  // 0
-    }
-    CLOCK_SET;  // shift bit
-    SER_CLEAR;  // reset 1
-  }
-  CLOCK_CLEAR;
+void shiftOutFAST(byte addr) {
+  SHIFT_BIT(addr, 0x80);
+  SHIFT_BIT(addr, 0x40);
+  SHIFT_BIT(addr, 0x20);
+  SHIFT_BIT(addr, 0x10);
+  SHIFT_BIT(addr, 0x08);
+  SHIFT_BIT(addr, 0x04);
+  SHIFT_BIT(addr, 0x02);
+  SHIFT_BIT(addr, 0x01);
+  SER_CLEAR;
 }
 
-//******************************************
-// READ DATA
-//******************************************
-void readJagData(unsigned long myAddress) {
-  SRCLR_CLEAR;
+// THE THREE 74HC595 ARE ONE CHAIN, EVERY SHIFTED BYTE PASSES THROUGH ALL OF THEM,
+// SO AN ADDRESS CAN ONLY BE SET AS A WHOLE. ALL 24 BITS OVERWRITE THE CHAIN, IT
+// NEEDS NO CLEARING FIRST, AND AN ADDRESS THAT IS ALREADY LATCHED IS SKIPPED.
+void setAddress_Jag(unsigned long myAddress) {
+  if (myAddress == jagLatchedAddress)
+    return;
+  jagLatchedAddress = myAddress;
+
   SRCLR_SET;
   LATCH_CLEAR;
-
   shiftOutFAST((myAddress >> 16) & 0xFF);
   shiftOutFAST((myAddress >> 8) & 0xFF);
   shiftOutFAST(myAddress);
   LATCH_SET;
+}
+
+//******************************************
+// READ DATA
+//******************************************
+void readJagData(unsigned long myAddress) {
+  setAddress_Jag(myAddress);
 
   // Arduino running at 16Mhz -> one nop = 62.5ns
   __asm__("nop\n\t");
@@ -553,8 +577,6 @@ void readJagData(unsigned long myAddress) {
           "nop\n\t"
           "nop\n\t"
           "nop\n\t");
-
-  SRCLR_CLEAR;
 }
 // Switch data pins to write
 void dataOut_Jag() {
@@ -665,12 +687,9 @@ void readJagROM() {
 // MICROCHIP EEPROM - TIE PIN 6 (ORG) TO VCC (ORG = 1) TO ENABLE 16bit MODE
 // FOR 93C76 & 93C86, TIE PIN 7 (PE) TO VCC TO ENABLE PROGRAMMING
 //*****************************************************************************
+// Protocol and timing are in MicrowireEeprom/JagEepPins (SerialEeprom.h)
 void Eepromdisplay_Clear() {
-  DDRF |= (1 << 0);   // DATA PIN PF0 AS OUTPUT
-  DDRA &= ~(1 << 5);  // DO INPUT
-  EEP_CS_CLEAR;
-  EEP_SK_CLEAR;
-  EEP_DI_CLEAR;
+  MicrowireEeprom<JagEepPins>::setup();
 }
 
 void EepromresetArduino() {
@@ -680,223 +699,35 @@ void EepromresetArduino() {
   EEP_DI_CLEAR;
 }
 
-void Eeprom0() {
-  EEP_DI_CLEAR;
-  EEP_SK_SET;
-  _delay_us(1);  // minimum 250ns
-  EEP_DI_CLEAR;
-  EEP_SK_CLEAR;
-  _delay_us(1);  // minimum 250ns
-}
-
-void Eeprom1() {
-  EEP_DI_SET;
-  EEP_SK_SET;
-  _delay_us(1);  // minimum 250ns
-  EEP_DI_CLEAR;
-  EEP_SK_CLEAR;
-  _delay_us(1);  // minimum 250ns
-}
-
-void EepromRead(uint16_t addr) {
-  Eepromdisplay_Clear();
-  EEP_CS_SET;
-  Eeprom1();  // 1
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  if ((jagEepSize == 1) || (jagEepSize == 3))
-    Eeprom0();  // Dummy 0 for 56/76
-  jagEepromSetAddress(addr);
-  _delay_us(12);  // From Willem Timing
-  // DATA OUTPUT
-  EepromreadData();
-  EEP_CS_CLEAR;
-  // OR 16 bits into two bytes
-  for (int j = 0; j < 16; j += 8) {
-    jagEepBuf[(j / 8)] = jagEepBit[0 + j] << 7 | jagEepBit[1 + j] << 6 | jagEepBit[2 + j] << 5 | jagEepBit[3 + j] << 4 | jagEepBit[4 + j] << 3 | jagEepBit[5 + j] << 2 | jagEepBit[6 + j] << 1 | jagEepBit[7 + j];
-  }
-}
-
-// Capture 2 bytes in 16 bits into bit array jagEepBit[]
-void EepromreadData(void) {
-  for (int i = 0; i < 16; i++) {
-    EEP_SK_SET;
-    _delay_us(1);                         // minimum 250ns
-    jagEepBit[i] = ((PINA & 0x20) >> 5);  // Read DO (PA5) - PINA with Mask 0x20
-    EEP_SK_CLEAR;
-    _delay_us(1);  // minimum 250ns
-  }
-}
-
-void EepromWrite(uint16_t addr) {
-  Eepromdisplay_Clear();
-  EEP_CS_SET;
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  Eeprom1();  // 1
-  if ((jagEepSize == 1) || (jagEepSize == 3))
-    Eeprom0();  // Dummy 0 for 56/76
-  jagEepromSetAddress(addr);
-  // DATA OUTPUT
-  EepromWriteData();
-  EEP_CS_CLEAR;
-  jagEepromStatus();
-}
-
-void EepromWriteData(void) {
-  byte UPPER = jagEepBuf[1];
-  byte LOWER = jagEepBuf[0];
-  for (int i = 0; i < 8; i++) {
-    if (((UPPER >> 7) & 0x1) == 1) {  // Bit is HIGH
-      Eeprom1();
-    } else {  // Bit is LOW
-      Eeprom0();
-    }
-    // rotate to the next bit
-    UPPER <<= 1;
-  }
-  for (int j = 0; j < 8; j++) {
-    if (((LOWER >> 7) & 0x1) == 1) {  // Bit is HIGH
-      Eeprom1();
-    } else {  // Bit is LOW
-      Eeprom0();
-    }
-    // rotate to the next bit
-    LOWER <<= 1;
-  }
-}
-
-void jagEepromSetAddress(uint16_t addr) {  // 16bit
-  uint8_t shiftaddr = jagEepSize + 6;      // 93C46 = 0 + 6, 93C56 = 7, 93C66 = 8, 93C76 = 9, 93C86 = 10
-  for (int i = 0; i < shiftaddr; i++) {
-    if (((addr >> shiftaddr) & 1) == 1) {  // Bit is HIGH
-      Eeprom1();
-    } else {  // Bit is LOW
-      Eeprom0();
-    }
-    // rotate to the next bit
-    addr <<= 1;
-  }
-}
-
-// EWEN/ERAL/EWDS
-// 93C56/93C66 - 10000xxxxxx (6 PULSES)
-// 93C76/93C86 - 10000xxxxxxxx (8 PULSES)
-void EepromEWEN(void) {  // EWEN 10011xxxx
-  Eepromdisplay_Clear();
-  EEP_CS_SET;
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom1();  // 1
-  Eeprom1();  // 1
-  // 46 = 4x Trailing 0s for 16bit
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  // 56/66 = 6x Trailing 0s for 16bit
-  if (jagEepSize > 0) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  // 76/86 = 8x Trailing 0s for 16bit
-  if (jagEepSize > 2) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  EEP_CS_CLEAR;
-  _delay_us(2);
-#ifdef SERIAL_MONITOR
-  Serial.println(F("ERASE ENABLED"));
-#endif
+// 93C46 = A5..A0, 93C56/93C66 = (X)A7..A0, 93C76/93C86 = (X)A9..A0
+// 56/76 send a dummy 0 in front of the address
+byte jagEepAddressBits() {
+  return 6 + ((jagEepSize + 1) / 2) * 2;
 }
 
-void EepromERAL(void) {  // ERASE ALL 10010xxxx
-  EEP_CS_SET;
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  // 46 = 4x Trailing 0s for 16bit
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  // 56/66 = 6x Trailing 0s for 16bit
-  if (jagEepSize > 0) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  // 76/86 = 8x Trailing 0s for 16bit
-  if (jagEepSize > 2) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  EEP_CS_CLEAR;
-  jagEepromStatus();
-#ifdef SERIAL_MONITOR
-  Serial.println(F("ERASED ALL"));
-#endif
+word EepromRead(word wordAddr) {
+  return MicrowireEeprom<JagEepPins>::read(wordAddr, jagEepAddressBits());
 }
 
-void EepromEWDS(void) {  // DISABLE 10000xxxx
-  Eepromdisplay_Clear();
-  EEP_CS_SET;
-  Eeprom1();  // 1
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  // 46 = 4x Trailing 0s for 16bit
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  Eeprom0();  // 0
-  // 56/66 = 6x Trailing 0s for 16bit
-  if (jagEepSize > 0) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  // 76/86 = 8x Trailing 0s for 16bit
-  if (jagEepSize > 2) {
-    Eeprom0();  // 0
-    Eeprom0();  // 0
-  }
-  EEP_CS_CLEAR;
-  _delay_us(2);
-#ifdef SERIAL_MONITOR
-  Serial.println(F("ERASE DISABLED"));
-#endif
-}
-
-void jagEepromStatus(void) {  // CHECK READY/BUSY
-  __asm__("nop\n\t"
-          "nop\n\t");  // CS LOW for minimum 100ns
-  EEP_CS_SET;
-  boolean status = ((PINA & 0x20) >> 5);  // Check DO
-  do {
-    _delay_ms(1);
-    status = ((PINA & 0x20) >> 5);
-  } while (!status);  // status == 0 = BUSY
-  EEP_CS_CLEAR;
+boolean EepromWrite(word wordAddr, word data) {
+  return MicrowireEeprom<JagEepPins>::write(wordAddr, jagEepAddressBits(), data);
 }
 
 #ifdef SERIAL_MONITOR
 void EepromDisplay() {  // FOR SERIAL ONLY
-  word eepEnd = int_pow(2, jagEepSize) * 128;
-  for (word address = 0; address < eepEnd; address += 2) {
-    EepromRead(address);
-    if ((address % 16 == 0) && (address != 0))
+  word eepEnd = int_pow(2, jagEepSize) * 64;
+  Eepromdisplay_Clear();
+  for (word currWord = 0; currWord < eepEnd; currWord++) {
+    word data = EepromRead(currWord);
+    if ((currWord % 8 == 0) && (currWord != 0))
       Serial.println(F(""));
-    if (jagEepBuf[1] < 0x10)
+    if ((data & 0xFF) < 0x10)
       Serial.print(F("0"));
-    Serial.print(jagEepBuf[1], HEX);
+    Serial.print(data & 0xFF, HEX);
     Serial.print(F(" "));
-    if (jagEepBuf[0] < 0x10)
+    if ((data >> 8) < 0x10)
       Serial.print(F("0"));
-    Serial.print(jagEepBuf[0], HEX);
+    Serial.print(data >> 8, HEX);
     Serial.print(F(" "));
   }
   Serial.println(F(""));
@@ -940,22 +771,15 @@ void readJagEEP() {
     resetArduino();
   }
   word eepEnd = int_pow(2, jagEepSize) * 64;  // WORDS
-  if (jagEepSize > 1) {                       // 93C66/93C76/93C86 - 256/512/1024 WORDS
-    for (word currWord = 0; currWord < eepEnd; currWord += 256) {
-      for (int i = 0; i < 256; i++) {
-        EepromRead((currWord + i) * 2);
-        sdBuffer[(i * 2)] = jagEepBuf[1];
-        sdBuffer[(i * 2) + 1] = jagEepBuf[0];
-      }
-      myFile.write(sdBuffer, 512);
-    }
-  } else {  // 93C46/93C56 - 64/128 WORDS
-    for (word currWord = 0; currWord < eepEnd; currWord++) {
-      EepromRead(currWord * 2);
-      sdBuffer[(currWord * 2)] = jagEepBuf[1];
-      sdBuffer[(currWord * 2) + 1] = jagEepBuf[0];
+  Eepromdisplay_Clear();
+  for (word currWord = 0; currWord < eepEnd; currWord += 256) {
+    word words = (eepEnd - currWord < 256) ? eepEnd - currWord : 256;
+    for (word i = 0; i < words; i++) {
+      word data = EepromRead(currWord + i);
+      sdBuffer[(i * 2)] = data & 0xFF;
+      sdBuffer[(i * 2) + 1] = data >> 8;
     }
-    myFile.write(sdBuffer, eepEnd * 2);
+    myFile.write(sdBuffer, words * 2);
   }
   EepromresetArduino();
   // Close the file:
@@ -977,34 +801,37 @@ void writeJagEEP() {
 
   // Open file on sd card
   if (myFile.open(filePath, O_READ)) {
-    EepromEWEN();  // ERASE/WRITE ENABLE
-    EepromERAL();  // ERASE ALL
+    byte addressBits = jagEepAddressBits();
+    word timeouts = 0;
+    Eepromdisplay_Clear();
+    MicrowireEeprom<JagEepPins>::writeEnable(addressBits, 1);  // ERASE/WRITE ENABLE
+    if (!MicrowireEeprom<JagEepPins>::eraseAll(addressBits))   // ERASE ALL
+      timeouts++;
 #ifdef SERIAL_MONITOR
     Serial.println(F("WRITING"));
 #endif
     word eepEnd = int_pow(2, jagEepSize) * 64;  // WORDS
-    if (jagEepSize > 1) {                       // 93C66/93C76/93C86
-      for (word currWord = 0; currWord < eepEnd; currWord += 256) {
-        myFile.read(sdBuffer, 512);
-        for (int i = 0; i < 256; i++) {
-          jagEepBuf[0] = sdBuffer[(i * 2)];
-          jagEepBuf[1] = sdBuffer[(i * 2) + 1];
-          EepromWrite((currWord + i) * 2);
-        }
-      }
-    } else {  // 93C46/93C56
-      myFile.read(sdBuffer, eepEnd * 2);
-      for (word currWord = 0; currWord < eepEnd; currWord++) {
-        jagEepBuf[0] = sdBuffer[currWord * 2];
-        jagEepBuf[1] = sdBuffer[(currWord * 2) + 1];
-        EepromWrite(currWord * 2);
+    for (word currWord = 0; currWord < eepEnd; currWord += 256) {
+      word words = (eepEnd - currWord < 256) ? eepEnd - currWord : 256;
+      myFile.read(sdBuffer, words * 2);
+      for (word i = 0; i < words; i++) {
+        word data = sdBuffer[(i * 2)] | (sdBuffer[(i * 2) + 1] << 8);
+        // ERAL left every word at 0xFFFF
+        if (data == 0xFFFF)
+          continue;
+        if (!EepromWrite(currWord + i, data))
+          timeouts++;
       }
     }
-    EepromEWDS();  // ERASE/WRITE DISABLE
+    MicrowireEeprom<JagEepPins>::writeEnable(addressBits, 0);  // ERASE/WRITE DISABLE
     EepromresetArduino();
     // Close the file:
     myFile.close();
     println_Msg(F(""));
+    if (timeouts) {
+      print_Msg(timeouts);
+      println_Msg(F(" write timeouts"));
+    }
     println_Msg(F("DONE"));
     display_Update();
   } else {
@@ -1114,13 +941,7 @@ void busyCheck() {
 }
 
 byte readBYTE_FLASH(unsigned long myAddress) {
-  SRCLR_CLEAR;
-  SRCLR_SET;
-  LATCH_CLEAR;
-  shiftOutFAST((myAddress >> 16) & 0xFF);
-  shiftOutFAST((myAddress >> 8) & 0xFF);
-  shiftOutFAST(myAddress);
-  LATCH_SET;
+  setAddress_Jag(myAddress);
 
   // Arduino running at 16Mhz -> one nop = 62.5ns
   __asm__("nop\n\t"
@@ -1169,13 +990,7 @@ byte readBYTE_FLASH(unsigned long myAddress) {
 }
 
 byte readBYTE_MEMROM(unsigned long myAddress) {
-  SRCLR_CLEAR;
-  SRCLR_SET;
-  LATCH_CLEAR;
-  shiftOutFAST((myAddress >> 16) & 0xFF);
-  shiftOutFAST((myAddress >> 8) & 0xFF);
-  shiftOutFAST(myAddress);
-  LATCH_SET;
+  setAddress_Jag(myAddress);
 
   // Arduino running at 16Mhz -> one nop = 62.5ns
   __asm__("nop\n\t"
@@ -1222,13 +1037,7 @@ byte readBYTE_MEMROM(unsigned long myAddress) {
 }
 
 void writeBYTE_FLASH(unsigned long myAddress, byte myData) {
-  SRCLR_CLEAR;
-  SRCLR_SET;
-  LATCH_CLEAR;
-  shiftOutFAST((myAddress >> 16) & 0xFF);
-  shiftOutFAST((myAddress >> 8) & 0xFF);
-  shiftOutFAST(myAddress);
-  LATCH_SET;
+  setAddress_Jag(myAddress);
 
   PORTL = myData;
 
@@ -1263,13 +1072,7 @@ void writeSECTOR_FLASH(unsigned long myAddress) {
   writeBYTE_FLASH(0x15554, 0xA0);  // 0x5555
 
   for (int i = 0; i < 128; i++) {
-    SRCLR_CLEAR;
-    SRCLR_SET;
-    LATCH_CLEAR;
-    shiftOutFAST((((myAddress + i) * 4) >> 16) & 0xFF);
-    shiftOutFAST((((myAddress + i) * 4) >> 8) & 0xFF);
-    shiftOutFAST((myAddress + i) * 4);  // (myAddress + i) * 4
-    LATCH_SET;
+    setAddress_Jag((myAddress + i) * 4);
 
     PORTL = sdBuffer[i];
     __asm__("nop\n\t"
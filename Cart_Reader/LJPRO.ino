@@ -154,6 +154,9 @@ void setup_LJPRO()
   // Request 3.3V
   setVoltage(VOLTS_SET_3V3);
 
+  ljproflash1found = false;
+  ljproflash2found = false;
+
   // LITTLE JAMMER PRO uses Serial Flash
   // Set Data Pins to Input
   DDRF = 0x00; // U1 Data
@@ -9,8 +9,6 @@
  *****************************************/
 unsigned long sramEnd;
 word eepSize;
-word addrhi;
-word addrlo;
 word chksum;
 boolean is32x = 0;
 boolean isSVP = 0;
@@ -403,6 +401,10 @@ void mdCartMenu() {
       } else {
         print_Error(F("Cart has no Save"));
       }
+#ifdef OPTION_DEDUPE_STORE
+      if ((saveType >= 1) && (saveType <= 4))
+        dedupeSave();
+#endif
       break;
 
     case 2:
@@ -415,8 +417,7 @@ void mdCartMenu() {
         fileBrowser(F("Select srm file"));
         display_Clear();
         enableSram_MD(1);
-        writeSram_MD();
-        writeErrors = verifySram_MD();
+        writeErrors = writeSram_MD();
         enableSram_MD(0);
         if (writeErrors == 0) {
           println_Msg(F("Sram verified OK"));
@@ -431,7 +432,16 @@ void mdCartMenu() {
         // Launch file browser
         fileBrowser(F("Select eep file"));
         display_Clear();
-        writeEEP_MD();
+        writeErrors = writeEEP_MD();
+        if (writeErrors == 0) {
+          println_Msg(F("Eeprom verified OK"));
+          display_Update();
+        } else {
+          print_STR(error_STR, 0);
+          print_Msg(writeErrors);
+          print_STR(_bytes_STR, 1);
+          print_Error(did_not_verify_STR);
+        }
       } else {
         print_Error(F("Cart has no Save"));
       }
@@ -516,6 +526,10 @@ void setup_MD() {
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
+  // Only ever set by getCartInfo_MD()
+  realtec = 0;
+  bramSize = 0;
+
 #if defined(ENABLE_CONFIG)
   segaSram16bit = configGetLong(F("md.saveType"));
 #elif defined(use_md_conf)
@@ -610,56 +624,9 @@ void writeWord_MD(unsigned long myAddress, word myData) {
           "nop\n\t");
 }
 
+// Read one word, bus layout and timing are set in MdBus (BusAccess.h)
 word readWord_MD(unsigned long myAddress) {
-  PORTF = myAddress & 0xFF;
-  PORTK = (myAddress >> 8) & 0xFF;
-  PORTL = (myAddress >> 16) & 0xFF;
-
-  // Arduino running at 16Mhz -> one nop = 62.5ns
-  NOP;
-
-  // Setting CS(PH3) LOW
-  PORTH &= ~(1 << 3);
-  // Setting OE(PH6) LOW
-  PORTH &= ~(1 << 6);
-  // Setting AS(PJ1) LOW
-  PORTJ &= ~(1 << 1);
-  // Setting ASEL(PG5) LOW
-  PORTG &= ~(1 << 5);
-  // Pulse CLK(PH1), needed for SVP enhanced carts
-  pulse_clock(10);
-
-  // most MD ROMs are 200ns, comparable to SNES > use similar access delay of 6 x 62.5 = 375ns
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-
-  // Read
-  word tempWord = ((PINA & 0xFF) << 8) | (PINC & 0xFF);
-
-  // Setting CS(PH3) HIGH
-  PORTH |= (1 << 3);
-  // Setting OE(PH6) HIGH
-  PORTH |= (1 << 6);
-  // Setting AS(PJ1) HIGH
-  PORTJ |= (1 << 1);
-  // Setting ASEL(PG5) HIGH
-  PORTG |= (1 << 5);
-  // Pulse CLK(PH1), needed for SVP enhanced carts
-  pulse_clock(10);
-
-  // these 6x nop delays have been here before, unknown what they mean
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-  NOP;
-
-  return tempWord;
+  return busRead16<MdBus>(myAddress);
 }
 
 void writeFlash_MD(unsigned long myAddress, word myData) {
@@ -1453,7 +1420,7 @@ void readROM_MD() {
   // Get name, add extension and convert to char array for sd lib
   createFolderAndOpenFile("MD", "ROM", romName, "BIN");
 
-  byte buffer[1024] = { 0 };
+  ScratchBuffer buffer(1024);
 
   // Phantasy Star/Beyond Oasis with 74HC74 and 74HC139 switch ROM/SRAM at address 0x200000
   if (0x200000 < cartSize && cartSize < 0x400000) {
@@ -1533,47 +1500,10 @@ void readROM_MD() {
 
     for (int currWord = 0; currWord < 512; currWord++) {
       unsigned long myAddress = currBuffer + currWord - (offsetSSF2Bank * 0x80000);
-      PORTF = myAddress & 0xFF;
-      PORTK = (myAddress >> 8) & 0xFF;
-      PORTL = (myAddress >> 16) & 0xFF;
-
-      // Arduino running at 16Mhz -> one nop = 62.5ns
-      NOP;
-      // Setting CS(PH3) LOW
-      PORTH &= ~(1 << 3);
-      // Setting OE(PH6) LOW
-      PORTH &= ~(1 << 6);
-      // Setting AS(PJ1) LOW
-      PORTJ &= ~(1 << 1);
-      // Setting ASEL(PG5) LOW
-      PORTG &= ~(1 << 5);
-      // Pulse CLK(PH1)
-      if (isSVP)
-        pulse_clock(10);
-
-      // most MD ROMs are 200ns, comparable to SNES > use similar access delay of 6 x 62.5 = 375ns
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-
-      // Read
-      buffer[d] = PINA;
-      buffer[d + 1] = PINC;
-
-      // Setting CS(PH3) HIGH
-      PORTH |= (1 << 3);
-      // Setting OE(PH6) HIGH
-      PORTH |= (1 << 6);
-      // Setting AS(PJ1) HIGH
-      PORTJ |= (1 << 1);
-      // Setting ASEL(PG5) HIGH
-      PORTG |= (1 << 5);
-      // Pulse CLK(PH1)
-      if (isSVP)
-        pulse_clock(10);
+      // Bus timing is set in MdBus (BusAccess.h), CLK is only pulsed for SVP carts
+      word myWord = isSVP ? busRead16<MdSvpBus>(myAddress) : busRead16<MdFastBus>(myAddress);
+      buffer[d] = myWord >> 8;
+      buffer[d + 1] = myWord & 0xFF;
 
       // Skip first 256 words
       if (((currBuffer == 0) && (currWord >= 256)) || (currBuffer > 0)) {
@@ -1597,47 +1527,10 @@ void readROM_MD() {
 
       for (int currWord = 0; currWord < 512; currWord++) {
         unsigned long myAddress = currBuffer + currWord + cartSize / 2;
-        PORTF = myAddress & 0xFF;
-        PORTK = (myAddress >> 8) & 0xFF;
-        PORTL = (myAddress >> 16) & 0xFF;
-
-        // Arduino running at 16Mhz -> one nop = 62.5ns
-        NOP;
-        // Setting CS(PH3) LOW
-        PORTH &= ~(1 << 3);
-        // Setting OE(PH6) LOW
-        PORTH &= ~(1 << 6);
-        // Setting AS(PJ1) LOW
-        PORTJ &= ~(1 << 1);
-        // Setting ASEL(PG5) LOW
-        PORTG &= ~(1 << 5);
-        // Pulse CLK(PH1)
-        if (isSVP)
-          pulse_clock(10);
-
-        // most MD ROMs are 200ns, comparable to SNES > use similar access delay of 6 x 62.5 = 375ns
-        NOP;
-        NOP;
-        NOP;
-        NOP;
-        NOP;
-        NOP;
-
-        // Read
-        buffer[d] = PINA;
-        buffer[d + 1] = PINC;
-
-        // Setting CS(PH3) HIGH
-        PORTH |= (1 << 3);
-        // Setting OE(PH6) HIGH
-        PORTH |= (1 << 6);
-        // Setting AS(PJ1) HIGH
-        PORTJ |= (1 << 1);
-        // Setting ASEL(PG5) HIGH
-        PORTG |= (1 << 5);
-        // Pulse CLK(PH1)
-        if (isSVP)
-          pulse_clock(10);
+        // Bus timing is set in MdBus (BusAccess.h), CLK is only pulsed for SVP carts
+        word myWord = isSVP ? busRead16<MdSvpBus>(myAddress) : busRead16<MdFastBus>(myAddress);
+        buffer[d] = myWord >> 8;
+        buffer[d + 1] = myWord & 0xFF;
 
         // Skip first 256 words
         if (((currBuffer == 0) && (currWord >= 256)) || (currBuffer > 0)) {
@@ -1799,9 +1692,55 @@ void enableSram_MD(boolean enableSram) {
   dataIn_MD();
 }
 
-// Write sram to cartridge
-void writeSram_MD() {
+// Number of bytes each SRAM word takes up in the save file
+byte sramStep_MD() {
+  return ((saveType == 3) || (segaSram16bit > 0)) ? 2 : 1;
+}
+
+// Write one block of the save file, only the byte lanes used by saveType are taken from the file
+void writeSramBlock_MD(uint32_t offset, const byte* data, uint16_t length) {
+  byte step = sramStep_MD();
+
   dataOut_MD();
+  for (uint16_t c = 0; c < length; c += step) {
+    unsigned long currByte = sramBase + (offset + c) / step;
+    // Write to both bytes
+    if (saveType == 3) {
+      writeWord_MD(currByte, (data[c] << 8) | data[c + 1]);
+    }
+    // Write to the lower byte, skip high byte of 16bit saves
+    else if (saveType == 1) {
+      writeWord_MD(currByte, data[c + step - 1]);
+    }
+    // Write to the upper byte, skip low byte of 16bit saves
+    else {
+      writeWord_MD(currByte, data[c] << 8);
+    }
+  }
+  dataIn_MD();
+}
+
+// Read back one block, skipped bytes of 16bit saves are left untouched
+void readSramBlock_MD(uint32_t offset, byte* data, uint16_t length) {
+  byte step = sramStep_MD();
+
+  for (uint16_t c = 0; c < length; c += step) {
+    word myWord = readWord_MD(sramBase + (offset + c) / step);
+    if (saveType == 3) {
+      data[c] = (myWord >> 8) & 0xFF;
+      data[c + 1] = myWord & 0xFF;
+    } else if (saveType == 1) {
+      data[c + step - 1] = myWord & 0xFF;
+    } else {
+      data[c] = (myWord >> 8) & 0xFF;
+    }
+  }
+}
+
+// Write sram to cartridge and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeSram_MD() {
+  dataIn_MD();
+  writeErrors = 0;
 
   // Create filepath
   sprintf(filePath, "%s/%s", filePath, fileName);
@@ -1811,35 +1750,8 @@ void writeSram_MD() {
 
   // Open file on sd card
   if (myFile.open(filePath, O_READ)) {
-    // Write to the lower byte
-    if (saveType == 1) {
-      for (unsigned long currByte = sramBase; currByte < sramBase + sramSize; currByte++) {
-        if (segaSram16bit > 0) {
-          // skip high byte
-          myFile.read();
-        }
-        word data = myFile.read() & 0xFF;
-        writeWord_MD(currByte, data);
-      }
-    }
-    // Write to the upper byte
-    else if (saveType == 2) {
-      for (unsigned long currByte = sramBase; currByte < sramBase + sramSize; currByte++) {
-        word data = (myFile.read() << 8) & 0xFF00;
-        writeWord_MD(currByte, data);
-        if (segaSram16bit > 0) {
-          // skip low byte
-          myFile.read();
-        }
-      }
-    }
-    // Write to both bytes
-    else if (saveType == 3) {
-      for (unsigned long currByte = sramBase; currByte < sramBase + sramSize; currByte++) {
-        word data = (myFile.read() << 8) & 0xFF00;
-        data |= (myFile.read() & 0xFF);
-        writeWord_MD(currByte, data);
-      }
+    if ((saveType == 1) || (saveType == 2) || (saveType == 3)) {
+      writeErrors = writeVerifySave(sramSize * sramStep_MD(), writeSramBlock_MD, readSramBlock_MD);
     } else
       print_Error(F("Unknown save type"));
 
@@ -1850,7 +1762,8 @@ void writeSram_MD() {
   } else {
     print_FatalError(sd_error_STR);
   }
-  dataIn_MD();
+  // Return 0 if verified ok, or number of errors
+  return writeErrors;
 }
 
 // Read sram and save to the SD card
@@ -1918,54 +1831,6 @@ void readSram_MD() {
   display_Update();
 }
 
-unsigned long verifySram_MD() {
-  dataIn_MD();
-  writeErrors = 0;
-
-  // Open file on sd card
-  if (myFile.open(filePath, O_READ)) {
-    for (unsigned long currBuffer = sramBase; currBuffer < sramBase + sramSize; currBuffer += 256) {
-      for (int currWord = 0; currWord < 256; currWord++) {
-        word myWord = readWord_MD(currBuffer + currWord);
-
-        if (saveType == 2) {
-          // Only use the upper byte
-          sdBuffer[currWord * 2] = ((myWord >> 8) & 0xFF);
-        } else if (saveType == 1) {
-          // Only use the lower byte
-          sdBuffer[currWord * 2] = (myWord & 0xFF);
-        } else if (saveType == 3) {  // BOTH
-          sdBuffer[(currWord * 2) + 0] = ((myWord >> 8) & 0xFF);
-          sdBuffer[(currWord * 2) + 1] = (myWord & 0xFF);
-        }
-      }
-      int step = saveType == 3 ? 1 : 2;
-      // Check sdBuffer content against file on sd card
-      for (int i = 0; i < 512; i += step) {
-        if (saveType == 1 && segaSram16bit > 0) {
-          // skip high byte
-          myFile.read();
-        }
-        byte b = myFile.read();
-        if (saveType == 2 && segaSram16bit > 0) {
-          // skip low byte
-          myFile.read();
-        }
-        if (b != sdBuffer[i]) {
-          writeErrors++;
-        }
-      }
-    }
-
-    // Close the file:
-    myFile.close();
-  } else {
-    print_FatalError(sd_error_STR);
-  }
-  // Return 0 if verified ok, or number of errors
-  return writeErrors;
-}
-
 #ifdef ENABLE_FLASH
 //******************************************
 // Flashrom Functions
@@ -2184,10 +2049,11 @@ void eraseFlash_MD() {
 
 void blankcheck_MD() {
   blank = 1;
-  for (unsigned long currByte = 0; currByte < flashSize / 2; currByte++) {
-    if (readFlash_MD(currByte) != 0xFFFF) {
-      currByte = flashSize / 2;
+  // Check 256 words out of every BLANKCHECK_STEP bytes, bus timing is set in MdFlashBus (BusAccess.h)
+  for (unsigned long currByte = 0; currByte < flashSize / 2; currByte += BLANKCHECK_STEP / 2) {
+    if (!busBlank16<MdFlashBus>(currByte, 256)) {
       blank = 0;
+      break;
     }
     if (currByte % 4096 == 0) {
       blinkLED();
@@ -2432,368 +2298,109 @@ void writeWord_CM(unsigned long myAddress, word myData) {  // Codemasters
           "nop\n\t");
 }
 
-// EEPROM COMMANDS
-void EepromStart() {
-  if (eepType == 2) {               // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low
-  } else if (eepType == 4) {        // EA
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-    writeWord_MD(0x100000, 0xC0);   // sda, scl high
-    writeWord_MD(0x100000, 0x40);   // sda low, scl high
-    writeWord_MD(0x100000, 0x00);   // START
-  } else if (eepType == 5) {        // Codemasters
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-    writeWord_CM(0x180000, 0x02);   // sda low, scl high
-    writeWord_CM(0x180000, 0x03);   // sda, scl high
-    writeWord_CM(0x180000, 0x02);   // sda low, scl high
-    writeWord_CM(0x180000, 0x00);   // START
-  } else {
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
-    writeWord_MD(0x100000, 0x03);  // sda, scl high
-    writeWord_MD(0x100000, 0x02);  // sda low, scl high
-    writeWord_MD(0x100000, 0x00);  // START
-  }
-}
-
-void EepromSet0() {
-  if (eepType == 2) {               // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low
-  } else if (eepType == 4) {        // EA
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-    writeWord_MD(0x100000, 0x40);   // sda low, scl high // 0
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-  } else if (eepType == 5) {        // Codemasters
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-    writeWord_CM(0x180000, 0x02);   // sda low, scl high // 0
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-  } else {
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
-    writeWord_MD(0x100000, 0x02);  // sda low, scl high // 0
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
-  }
-}
-
-void EepromSet1() {
-  if (eepType == 2) {               // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x00);  // scl low
-  } else if (eepType == 4) {        // EA
-    writeWord_MD(0x100000, 0x80);   // sda high, scl low
-    writeWord_MD(0x100000, 0xC0);   // sda high, scl high // 1
-    writeWord_MD(0x100000, 0x80);   // sda high, scl low
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-  } else if (eepType == 5) {        // Codemasters
-    writeWord_CM(0x180000, 0x01);   // sda high, scl low
-    writeWord_CM(0x180000, 0x03);   // sda high, scl high // 1
-    writeWord_CM(0x180000, 0x01);   // sda high, scl low
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
+// EEPROM LINES
+// Every mapper has SDA/SCL at different bits and addresses, the protocol itself is in I2cEeprom (SerialEeprom.h)
+byte eepLines_MD;  // bit 0 = SDA, bit 1 = SCL as last driven
+
+void setEepLine_MD(byte line, bool high) {
+  if (high)
+    eepLines_MD |= line;
+  else
+    eepLines_MD &= ~line;
+
+  if (eepType == 2) {  // Acclaim Type 2
+    if (line == 0x01)
+      writeWord_SDA(0x100000, high);
+    else
+      writeWord_SCL(0x100000, high);
+  } else if (eepType == 4) {  // EA
+    writeWord_MD(0x100000, ((eepLines_MD & 0x01) << 7) | ((eepLines_MD & 0x02) << 5));
+  } else if (eepType == 5) {  // Codemasters
+    writeWord_CM(0x180000, eepLines_MD);
   } else {
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x03);  // sda high, scl high // 1
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
+    writeWord_MD(0x100000, eepLines_MD);
   }
 }
 
-void EepromDevice() {  // 24C02+
-  EepromSet1();
-  EepromSet0();
-  EepromSet1();
-  EepromSet0();
+bool sampleEepSda_MD() {
+  word sda;
+  dataIn_MD();
+  if (eepType == 1)  // Acclaim Type 1
+    sda = (readWord_MD(0x100000) >> 1) & 0x1;
+  else if (eepType == 4)  // EA
+    sda = (readWord_MD(0x100000) >> 7) & 0x1;
+  else if (eepType == 5)  // Codemasters
+    sda = (readWord_MD(0x1C0000) >> 7) & 0x1;
+  else  // Acclaim Type 2, Capcom/Sega
+    sda = readWord_MD(0x100000) & 0x1;
+  dataOut_MD();
+  return sda;
 }
 
-void EepromSetDeviceAddress(word addrhi) {  // 24C02+
-  for (int i = 0; i < 3; i++) {
-    if ((addrhi >> 2) & 0x1)  // Bit is HIGH
-      EepromSet1();
-    else  // Bit is LOW
-      EepromSet0();
-    addrhi <<= 1;  // rotate to the next bit
+struct MdEepLines {
+  // One mapper write already takes longer than tLOW/tHIGH
+  static constexpr uint8_t lowCycles = 0;
+  static constexpr uint8_t highCycles = 0;
+  static void sda(bool high) {
+    setEepLine_MD(0x01, high);
   }
-}
-
-void EepromStatus() {  // ACK
-  byte eepStatus = 1;
-  if (eepType == 1) {              // Acclaim Type 1
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x03);  // sda high, scl high
-    do {
-      dataIn_MD();
-      eepStatus = ((readWord_MD(0x100000) >> 1) & 0x1);
-      dataOut_MD();
-      delayMicroseconds(4);
-    } while (eepStatus == 1);
-    writeWord_MD(0x100000, 0x01);   // sda high, scl low
-  } else if (eepType == 2) {        // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    do {
-      dataIn_MD();
-      eepStatus = (readWord_MD(0x100000) & 0x1);
-      dataOut_MD();
-      delayMicroseconds(4);
-    } while (eepStatus == 1);
-    writeWord_SCL(0x100000, 0x00);  // scl low
-  } else if (eepType == 3) {        // Capcom/Sega
-    writeWord_MD(0x100000, 0x01);   // sda high, scl low
-    writeWord_MD(0x100000, 0x03);   // sda high, scl high
-    do {
-      dataIn_MD();
-      eepStatus = (readWord_MD(0x100000) & 0x1);
-      dataOut_MD();
-      delayMicroseconds(4);
-    } while (eepStatus == 1);
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-  } else if (eepType == 4) {       // EA
-    writeWord_MD(0x100000, 0x80);  // sda high, scl low
-    writeWord_MD(0x100000, 0xC0);  // sda high, scl high
-    do {
-      dataIn_MD();
-      eepStatus = ((readWord_MD(0x100000) >> 7) & 0x1);
-      dataOut_MD();
-      delayMicroseconds(4);
-    } while (eepStatus == 1);
-    writeWord_MD(0x100000, 0x80);  // sda high, scl low
-  } else if (eepType == 5) {       // Codemasters
-    writeWord_CM(0x180000, 0x01);  // sda high, scl low
-    writeWord_CM(0x180000, 0x03);  // sda high, scl high
-    do {
-      dataIn_MD();
-      eepStatus = ((readWord_MD(0x1C0000) >> 7) & 0x1);
-      dataOut_MD();
-      delayMicroseconds(4);
-    } while (eepStatus == 1);
-    writeWord_CM(0x180000, 0x01);  // sda high, scl low
+  static void scl(bool high) {
+    setEepLine_MD(0x02, high);
+  }
+  static bool sample() {
+    return sampleEepSda_MD();
   }
+};
+
+I2C_ADDRESSING eepAddressing_MD() {
+  if (eepSize > 0x800)  // MODE 3 [24C65]
+    return I2C_24C32;
+  if (eepSize > 0x80)  // MODE 2 [24C02/24C08/24C16]
+    return I2C_24C02;
+  return I2C_X24C01;  // MODE 1 [24C01]
 }
 
-void EepromReadMode() {
-  EepromSet1();    // READ
-  EepromStatus();  // ACK
+void startEeprom_MD() {
+  dataOut_MD();
+  if (eepType == 2)
+    EepromInit(0);  // Enable EEPROM
+  eepLines_MD = 0;
+  setEepLine_MD(0x01, 0);  // sda low, scl low
 }
 
-void EepromWriteMode() {
-  EepromSet0();    // WRITE
-  EepromStatus();  // ACK
+void endEeprom_MD() {
+  if (eepType == 2)
+    EepromInit(1);  // Disable EEPROM
 }
 
-void EepromReadData() {
-  if (eepType == 1) {  // Acclaim Type 1
-    for (int i = 0; i < 8; i++) {
-      writeWord_MD(0x100000, 0x03);  // sda high, scl high
-      dataIn_MD();
-      eepbit[i] = ((readWord_MD(0x100000) >> 1) & 0x1);  // Read 0x100000 with Mask 0x1 (bit 1)
-      dataOut_MD();
-      writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    }
-  } else if (eepType == 2) {  // Acclaim Type 2
-    for (int i = 0; i < 8; i++) {
-      writeWord_SDA(0x100000, 0x01);  // sda high
-      writeWord_SCL(0x100000, 0x01);  // scl high
-      dataIn_MD();
-      eepbit[i] = (readWord_MD(0x100000) & 0x1);  // Read 0x100000 with Mask 0x1 (bit 0)
-      dataOut_MD();
-      writeWord_SDA(0x100000, 0x01);  // sda high
-      writeWord_SCL(0x100000, 0x00);  // scl low
-    }
-  } else if (eepType == 3) {  // Capcom/Sega
-    for (int i = 0; i < 8; i++) {
-      writeWord_MD(0x100000, 0x03);  // sda high, scl high
-      dataIn_MD();
-      eepbit[i] = (readWord_MD(0x100000) & 0x1);  // Read 0x100000 with Mask 0x1 (bit 0)
-      dataOut_MD();
-      writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    }
-  } else if (eepType == 4) {  // EA
-    for (int i = 0; i < 8; i++) {
-      writeWord_MD(0x100000, 0xC0);  // sda high, scl high
-      dataIn_MD();
-      eepbit[i] = ((readWord_MD(0x100000) >> 7) & 0x1);  // Read 0x100000 with Mask (bit 7)
-      dataOut_MD();
-      writeWord_MD(0x100000, 0x80);  // sda high, scl low
-    }
-  } else if (eepType == 5) {  // Codemasters
-    for (int i = 0; i < 8; i++) {
-      writeWord_CM(0x180000, 0x03);  // sda high, scl high
-      dataIn_MD();
-      eepbit[i] = ((readWord_MD(0x1C0000) >> 7) & 0x1);  // Read 0x1C0000 with Mask 0x1 (bit 7)
-      dataOut_MD();
-      writeWord_CM(0x180000, 0x01);  // sda high, scl low
-    }
-  }
+// Sequential read into buffer
+void readEeprom_MD(word address, byte* buffer, word length) {
+  startEeprom_MD();
+  I2cEeprom<MdEepLines>::read(address, buffer, length, eepAddressing_MD());
+  endEeprom_MD();
 }
 
-void EepromWriteData(byte data) {
-  for (int i = 0; i < 8; i++) {
-    if ((data >> 7) & 0x1)  // Bit is HIGH
-      EepromSet1();
-    else  // Bit is LOW
-      EepromSet0();
-    data <<= 1;  // rotate to the next bit
-  }
-  EepromStatus();  // ACK
-}
-
-void EepromFinish() {
-  if (eepType == 2) {               // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x00);  // scl low
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x00);  // scl low
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low
-  } else if (eepType == 4) {        // EA
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-    writeWord_MD(0x100000, 0x80);   // sda high, scl low
-    writeWord_MD(0x100000, 0xC0);   // sda high, scl high
-    writeWord_MD(0x100000, 0x80);   // sda high, scl low
-    writeWord_MD(0x100000, 0x00);   // sda low, scl low
-  } else if (eepType == 5) {        // Codemasters
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-    writeWord_CM(0x180000, 0x01);   // sda high, scl low
-    writeWord_CM(0x180000, 0x03);   // sda high, scl high
-    writeWord_CM(0x180000, 0x01);   // sda high, scl low
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-  } else {
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x03);  // sda high, scl high
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x00);  // sda low, scl low
-  }
-}
-
-void EepromStop() {
-  if (eepType == 2) {               // Acclaim Type 2
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x01);  // scl high
-    writeWord_SDA(0x100000, 0x01);  // sda high
-    writeWord_SCL(0x100000, 0x00);  // scl low
-    writeWord_SDA(0x100000, 0x00);  // sda low
-    writeWord_SCL(0x100000, 0x00);  // scl low // STOP
-  } else if (eepType == 4) {        // EA
-    writeWord_MD(0x100000, 0x00);   // sda, scl low
-    writeWord_MD(0x100000, 0x40);   // sda low, scl high
-    writeWord_MD(0x100000, 0xC0);   // sda, scl high
-    writeWord_MD(0x100000, 0x80);   // sda high, scl low
-    writeWord_MD(0x100000, 0x00);   // STOP
-  } else if (eepType == 5) {        // Codemasters
-    writeWord_CM(0x180000, 0x00);   // sda low, scl low
-    writeWord_CM(0x180000, 0x02);   // sda low, scl high
-    writeWord_CM(0x180000, 0x03);   // sda, scl high
-    writeWord_CM(0x180000, 0x01);   // sda high, scl low
-    writeWord_CM(0x180000, 0x00);   // STOP
-  } else {
-    writeWord_MD(0x100000, 0x00);  // sda, scl low
-    writeWord_MD(0x100000, 0x02);  // sda low, scl high
-    writeWord_MD(0x100000, 0x03);  // sda, scl high
-    writeWord_MD(0x100000, 0x01);  // sda high, scl low
-    writeWord_MD(0x100000, 0x00);  // STOP
-  }
-}
-
-void EepromSetAddress(word address) {
-  if (eepSize > 0x80) {  // 24C02+
-    for (int i = 0; i < 8; i++) {
-      if ((address >> 7) & 0x1)  // Bit is HIGH
-        EepromSet1();
-      else  // Bit is LOW
-        EepromSet0();
-      address <<= 1;  // rotate to the next bit
-    }
-    EepromStatus();  // ACK
-  } else {           // 24C01
-    for (int i = 0; i < 7; i++) {
-      if ((address >> 6) & 0x1)  // Bit is HIGH
-        EepromSet1();
-      else  // Bit is LOW
-        EepromSet0();
-      address <<= 1;  // rotate to the next bit
-    }
+// Page writes from buffer, a page that timed out shows up in the read back
+void writeEeprom_MD(word address, const byte* buffer, word length) {
+  I2C_ADDRESSING mode = eepAddressing_MD();
+  byte pageSize = I2cEeprom<MdEepLines>::pageSize(eepSize, mode);
+
+  startEeprom_MD();
+  for (word offset = 0; offset < length; offset += pageSize) {
+    I2cEeprom<MdEepLines>::write(address + offset, buffer + offset, pageSize, mode);
   }
+  endEeprom_MD();
 }
 
-void readEepromByte(word address) {
-  addrhi = address >> 8;
-  addrlo = address & 0xFF;
-  dataOut_MD();
-  if (eepType == 2)
-    EepromInit(0);  // Enable EEPROM
-  EepromStart();    // START
-  if (eepSize > 0x80) {
-    EepromDevice();         // DEVICE [1010]
-    if (eepSize > 0x800) {  // MODE 3 [24C65]
-      EepromSetDeviceAddress(0);
-      EepromWriteMode();
-      EepromSetAddress(addrhi);        // ADDR [A15..A8]
-    } else {                           // MODE 2 [24C02/24C08/24C16]
-      EepromSetDeviceAddress(addrhi);  // ADDR [A10..A8]
-      EepromWriteMode();
-    }
-  }
-  EepromSetAddress(addrlo);
-  if (eepSize > 0x80) {
-    EepromStart();        // START
-    EepromDevice();       // DEVICE [1010]
-    if (eepSize > 0x800)  // MODE 3 [24C65]
-      EepromSetDeviceAddress(0);
-    else                               // MODE 2 [24C02/24C08/24C16]
-      EepromSetDeviceAddress(addrhi);  // ADDR [A10..A8]
-  }
-  EepromReadMode();
-  EepromReadData();
-  EepromFinish();
-  EepromStop();  // STOP
-  if (eepType == 2)
-    EepromInit(1);  // Disable EEPROM
-  // OR 8 bits into byte
-  eeptemp = eepbit[0] << 7 | eepbit[1] << 6 | eepbit[2] << 5 | eepbit[3] << 4 | eepbit[4] << 3 | eepbit[5] << 2 | eepbit[6] << 1 | eepbit[7];
-  sdBuffer[addrlo] = eeptemp;
+// Block accessors for writeVerifySave(), 256 bytes per sequential read like readEEP_MD()
+void writeEepBlock_MD(uint32_t offset, const byte* data, uint16_t length) {
+  writeEeprom_MD(offset, data, length);
 }
 
-void writeEepromByte(word address) {
-  addrhi = address >> 8;
-  addrlo = address & 0xFF;
-  eeptemp = sdBuffer[addrlo];
-  dataOut_MD();
-  if (eepType == 2)
-    EepromInit(0);  // Enable EEPROM
-  EepromStart();    // START
-  if (eepSize > 0x80) {
-    EepromDevice();                    // DEVICE [1010]
-    if (eepSize > 0x800) {             // MODE 3 [24C65]
-      EepromSetDeviceAddress(0);       // [A2-A0] = 000
-      EepromWriteMode();               // WRITE
-      EepromSetAddress(addrhi);        // ADDR [A15-A8]
-    } else {                           // MODE 2 [24C02/24C08/24C16]
-      EepromSetDeviceAddress(addrhi);  // ADDR [A10-A8]
-      EepromWriteMode();               // WRITE
-    }
-    EepromSetAddress(addrlo);
-  } else {  // 24C01
-    EepromSetAddress(addrlo);
-    EepromWriteMode();  // WRITE
+void readEepBlock_MD(uint32_t offset, byte* data, uint16_t length) {
+  for (uint16_t done = 0; done < length; done += 256) {
+    readEeprom_MD(offset + done, data + done, (length - done < 256) ? (length - done) : 256);
   }
-  EepromWriteData(eeptemp);
-  EepromStop();  // STOP
-  if (eepType == 2)
-    EepromInit(1);  // Disable EEPROM
 }
 
 // Read EEPROM and save to the SD card
@@ -2814,25 +2421,14 @@ void readEEP_MD() {
   if (!myFile.open(fileName, O_RDWR | O_CREAT)) {
     print_FatalError(sd_error_STR);
   }
-  if (eepSize > 0x100) {  // 24C04+
-    for (word currByte = 0; currByte < eepSize; currByte += 256) {
-      print_Msg(F("*"));
-      display_Update();
-      for (int i = 0; i < 256; i++) {
-        readEepromByte(currByte + i);
-      }
-      myFile.write(sdBuffer, 256);
-    }
-  } else {  // 24C01/24C02
-    for (word currByte = 0; currByte < eepSize; currByte++) {
-      if ((currByte != 0) && ((currByte + 1) % 16 == 0)) {
-        print_Msg(F("*"));
-        display_Update();
-      }
-      readEepromByte(currByte);
-    }
-    myFile.write(sdBuffer, eepSize);
+  for (word currByte = 0; currByte < eepSize; currByte += 256) {
+    word length = (eepSize < 256) ? eepSize : 256;
+    print_Msg(F("*"));
+    display_Update();
+    readEeprom_MD(currByte, sdBuffer, length);
+    myFile.write(sdBuffer, length);
   }
+  dataIn_MD();
   // Close the file:
   myFile.close();
   println_Msg(FS(FSTRING_EMPTY));
@@ -2843,8 +2439,10 @@ void readEEP_MD() {
   display_Update();
 }
 
-void writeEEP_MD() {
+// Write the eep file to the EEPROM and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeEEP_MD() {
   dataOut_MD();
+  writeErrors = 0;
 
   // Create filepath
   sprintf(filePath, "%s/%s", filePath, fileName);
@@ -2854,36 +2452,17 @@ void writeEEP_MD() {
 
   // Open file on sd card
   if (myFile.open(filePath, O_READ)) {
-    if (eepSize > 0x100) {  // 24C04+
-      for (word currByte = 0; currByte < eepSize; currByte += 256) {
-        myFile.read(sdBuffer, 256);
-        for (int i = 0; i < 256; i++) {
-          writeEepromByte(currByte + i);
-          delay(50);  // DELAY NEEDED
-        }
-        print_Msg(F("."));
-        display_Update();
-      }
-    } else {  // 24C01/24C02
-      myFile.read(sdBuffer, eepSize);
-      for (word currByte = 0; currByte < eepSize; currByte++) {
-        writeEepromByte(currByte);
-        print_Msg(F("."));
-        if ((currByte != 0) && ((currByte + 1) % 64 == 0))
-          println_Msg(FS(FSTRING_EMPTY));
-        display_Update();  // ON SERIAL = delay(100)
-      }
-    }
+    writeErrors = writeVerifySave(eepSize, writeEepBlock_MD, readEepBlock_MD);
     // Close the file:
     myFile.close();
-    println_Msg(FS(FSTRING_EMPTY));
-    display_Clear();
     print_STR(done_STR, 1);
     display_Update();
   } else {
     print_FatalError(sd_error_STR);
   }
   dataIn_MD();
+  // Return 0 if verified ok, or number of errors
+  return writeErrors;
 }
 
 //******************************************
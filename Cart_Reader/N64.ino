@@ -13,6 +13,8 @@
 #define N64_LOW DDRH |= 0x10
 // Read the current state(0/1) of the eepDataPin
 #define N64_QUERY (PINH & 0x10)
+// Attempts to read a Controller Pak block before giving up on a timeout or CRC error
+#define N64_MPK_READ_RETRIES 4
 
 /******************************************
    Variables
@@ -68,6 +70,13 @@ static const char* const menuOptionsN64Controller[] PROGMEM = { N64ContMenuItem1
 // N64 cart menu items
 static const char N64CartMenuItem4[] PROGMEM = "Force Savetype";
 static const char* const menuOptionsN64Cart[] PROGMEM = { FSTRING_READ_ROM, FSTRING_READ_SAVE, FSTRING_WRITE_SAVE, N64CartMenuItem4, FSTRING_RESET };
+#ifdef ENABLE_CONFIG
+// Only shown if config.txt has n64.job
+static const char N64CartMenuItem6[] PROGMEM = "Run Job";
+// n64.job, read from config.txt by setup_N64_Cart() so the menu doesn't read it every time
+static JobState n64Job;
+static boolean n64JobFound = false;
+#endif
 
 // Rom menu
 static const char N64RomItem1[] PROGMEM = "4 MB";
@@ -244,9 +253,15 @@ void n64ControllerMenu() {
 void n64CartMenu() {
   // create menu with title and 4 options to choose from
   unsigned char mainMenu;
+  byte numOptions = 5;
   // Copy menuOptions out of progmem
   convertPgm(menuOptionsN64Cart, 5);
-  mainMenu = question_box(F("N64 Cart Reader"), menuOptions, 5, 0);
+#ifdef ENABLE_CONFIG
+  if (n64JobFound) {
+    strcpy_P(menuOptions[numOptions++], N64CartMenuItem6);
+  }
+#endif
+  mainMenu = question_box(F("N64 Cart Reader"), menuOptions, numOptions, 0);
 
   // wait for user choice to come back from the question box menu
   switch (mainMenu) {
@@ -276,28 +291,7 @@ void n64CartMenu() {
     case 1:
       sd.chdir("/");
       display_Clear();
-
-      if (saveType == 1) {
-        println_Msg(F("Reading SRAM..."));
-        display_Update();
-        readSram(32768, 1);
-      } else if (saveType == 2) {
-        println_Msg(F("Reading Sram 768..."));
-        display_Update();
-        readSram(98304, 1);
-      } else if (saveType == 4) {
-        getFramType();
-        println_Msg(F("Reading FLASH..."));
-        display_Update();
-        readFram(flashramType);
-      } else if ((saveType == 5) || (saveType == 6)) {
-        println_Msg(F("Reading EEPROM..."));
-        display_Update();
-        resetEeprom_N64();
-        readEeprom_N64();
-      } else {
-        print_Error(F("Savetype Error"));
-      }
+      readSave_N64();
       println_Msg(FS(FSTRING_EMPTY));
       // Prints string out of the common strings array either with or without newline
       print_STR(press_button_STR, 1);
@@ -313,8 +307,7 @@ void n64CartMenu() {
         fileBrowser(F("Select sra file"));
         display_Clear();
 
-        writeSram(32768);
-        writeErrors = verifySram(32768, 1);
+        writeErrors = writeSram(32768);
         if (writeErrors == 0) {
           println_Msg(F("SRAM verified OK"));
           display_Update();
@@ -329,8 +322,7 @@ void n64CartMenu() {
         fileBrowser(F("Select Sram 768 file"));
         display_Clear();
 
-        writeSram(98304);
-        writeErrors = verifySram(98304, 1);
+        writeErrors = writeSram(98304);
         if (writeErrors == 0) {
           println_Msg(F("Sram verified OK"));
           display_Update();
@@ -428,9 +420,107 @@ void n64CartMenu() {
     case 4:
       resetArduino();
       break;
+
+#ifdef ENABLE_CONFIG
+    case 5:
+      runJob_N64(&n64Job);
+      break;
+#endif
   }
 }
 
+// Reads the save of the current save type
+void readSave_N64() {
+  if (saveType == 1) {
+    println_Msg(F("Reading SRAM..."));
+    display_Update();
+    readSram(32768, 1);
+  } else if (saveType == 2) {
+    println_Msg(F("Reading Sram 768..."));
+    display_Update();
+    readSram(98304, 1);
+  } else if (saveType == 4) {
+    getFramType();
+    println_Msg(F("Reading FLASH..."));
+    display_Update();
+    readFram(flashramType);
+  } else if ((saveType == 5) || (saveType == 6)) {
+    println_Msg(F("Reading EEPROM..."));
+    display_Update();
+    resetEeprom_N64();
+    readEeprom_N64();
+  } else {
+    print_Error(F("Savetype Error"));
+  }
+#ifdef OPTION_DEDUPE_STORE
+  if ((saveType == 1) || (saveType == 2) || (saveType == 4) || (saveType == 5) || (saveType == 6))
+    dedupeSave();
+#endif
+}
+
+#ifdef ENABLE_CONFIG
+const __FlashStringHelper* saveTypeName_N64() {
+  switch (saveType) {
+    case 1: return F("SRAM");
+    case 2: return F("SRAM 768");
+    case 4: return F("FLASH");
+    case 5: return F("4K EEPROM");
+    case 6: return F("16K EEPROM");
+    default: return F("None");
+  }
+}
+
+// Runs the steps of n64.job one after the other, the cart info from getCartInfo_N64() is used for all of them
+void runJob_N64(JobState* job) {
+  const __FlashStringHelper* saveName = F("skipped");
+
+  jobStart(job);
+  for (uint8_t i = 0; i < job->count; i++) {
+    sd.chdir("/");
+    switch (job->step[i]) {
+      case JOB_ROM:
+        display_Clear();
+#ifndef OPTION_N64_FASTCRC
+        readRom_N64();
+        jobSaveRom(job, 0);
+#else
+        jobSaveRom(job, readRom_N64());
+#endif
+        break;
+
+      case JOB_SAVE:
+        display_Clear();
+        saveName = saveTypeName_N64();
+        if (saveType != 0)
+          readSave_N64();
+        break;
+
+      case JOB_VERIFY:
+        if (!job->romDumped) {
+          print_Error(F("No ROM to verify"));
+          break;
+        }
+        jobRestoreRom(job);
+        job->romVerified = compareCRC("n64.txt", job->romCrc, 1, 0);
+        break;
+
+      case JOB_SUMMARY:
+        jobSummary(job, saveName);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  println_Msg(FS(FSTRING_EMPTY));
+  // Prints string out of the common strings array either with or without newline
+  print_STR(press_button_STR, 1);
+  display_Update();
+  wait();
+}
+#endif
+
 /******************************************
    Setup
  *****************************************/
@@ -448,6 +538,10 @@ void setup_N64_Cart() {
   // Request 3.3V
   setVoltage(VOLTS_SET_3V3);
 
+#ifdef ENABLE_CONFIG
+  n64JobFound = jobLoad(F("n64.job"), &n64Job);
+#endif
+
   // Set Address Pins to Output and set them low
   //A0-A7
   DDRF = 0xFF;
@@ -574,25 +668,9 @@ void setAddress_N64(unsigned long myAddress) {
   adIn_N64();
 }
 
-// Read one word out of the cartridge
+// Read one word out of the cartridge, timing is set in N64Bus (BusAccess.h)
 word readWord_N64() {
-  // Pull read(PH6) low
-  PORTH &= ~(1 << 6);
-
-  // Wait ~310ns
-  __asm__("nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t"
-          "nop\n\t");
-
-  // Join bytes from PINF and PINK into a word
-  word tempWord = ((PINK & 0xFF) << 8) | (PINF & 0xFF);
-
-  // Pull read(PH6) high
-  PORTH |= (1 << 6);
-
-  return tempWord;
+  return busStrobe16<N64Bus>();
 }
 
 // Write one word to data pins of the cartridge
@@ -643,19 +721,30 @@ static word addrCRC(word address) {
   return (address & 0xFFE0) | crc;
 }
 
+// CRC-8 with polynomial 0x85 of every byte value, one lookup per data byte instead of a branch per bit
+static const uint8_t n64_data_crc_table[256] PROGMEM = {
+  0x00, 0x85, 0x8F, 0x0A, 0x9B, 0x1E, 0x14, 0x91, 0xB3, 0x36, 0x3C, 0xB9, 0x28, 0xAD, 0xA7, 0x22,
+  0xE3, 0x66, 0x6C, 0xE9, 0x78, 0xFD, 0xF7, 0x72, 0x50, 0xD5, 0xDF, 0x5A, 0xCB, 0x4E, 0x44, 0xC1,
+  0x43, 0xC6, 0xCC, 0x49, 0xD8, 0x5D, 0x57, 0xD2, 0xF0, 0x75, 0x7F, 0xFA, 0x6B, 0xEE, 0xE4, 0x61,
+  0xA0, 0x25, 0x2F, 0xAA, 0x3B, 0xBE, 0xB4, 0x31, 0x13, 0x96, 0x9C, 0x19, 0x88, 0x0D, 0x07, 0x82,
+  0x86, 0x03, 0x09, 0x8C, 0x1D, 0x98, 0x92, 0x17, 0x35, 0xB0, 0xBA, 0x3F, 0xAE, 0x2B, 0x21, 0xA4,
+  0x65, 0xE0, 0xEA, 0x6F, 0xFE, 0x7B, 0x71, 0xF4, 0xD6, 0x53, 0x59, 0xDC, 0x4D, 0xC8, 0xC2, 0x47,
+  0xC5, 0x40, 0x4A, 0xCF, 0x5E, 0xDB, 0xD1, 0x54, 0x76, 0xF3, 0xF9, 0x7C, 0xED, 0x68, 0x62, 0xE7,
+  0x26, 0xA3, 0xA9, 0x2C, 0xBD, 0x38, 0x32, 0xB7, 0x95, 0x10, 0x1A, 0x9F, 0x0E, 0x8B, 0x81, 0x04,
+  0x89, 0x0C, 0x06, 0x83, 0x12, 0x97, 0x9D, 0x18, 0x3A, 0xBF, 0xB5, 0x30, 0xA1, 0x24, 0x2E, 0xAB,
+  0x6A, 0xEF, 0xE5, 0x60, 0xF1, 0x74, 0x7E, 0xFB, 0xD9, 0x5C, 0x56, 0xD3, 0x42, 0xC7, 0xCD, 0x48,
+  0xCA, 0x4F, 0x45, 0xC0, 0x51, 0xD4, 0xDE, 0x5B, 0x79, 0xFC, 0xF6, 0x73, 0xE2, 0x67, 0x6D, 0xE8,
+  0x29, 0xAC, 0xA6, 0x23, 0xB2, 0x37, 0x3D, 0xB8, 0x9A, 0x1F, 0x15, 0x90, 0x01, 0x84, 0x8E, 0x0B,
+  0x0F, 0x8A, 0x80, 0x05, 0x94, 0x11, 0x1B, 0x9E, 0xBC, 0x39, 0x33, 0xB6, 0x27, 0xA2, 0xA8, 0x2D,
+  0xEC, 0x69, 0x63, 0xE6, 0x77, 0xF2, 0xF8, 0x7D, 0x5F, 0xDA, 0xD0, 0x55, 0xC4, 0x41, 0x4B, 0xCE,
+  0x4C, 0xC9, 0xC3, 0x46, 0xD7, 0x52, 0x58, 0xDD, 0xFF, 0x7A, 0x70, 0xF5, 0x64, 0xE1, 0xEB, 0x6E,
+  0xAF, 0x2A, 0x20, 0xA5, 0x34, 0xB1, 0xBB, 0x3E, 0x1C, 0x99, 0x93, 0x16, 0x87, 0x02, 0x08, 0x8D
+};
+
 static uint8_t dataCRC(uint8_t* data) {
   uint8_t ret = 0;
-  for (uint8_t i = 0; i <= 32; i++) {
-    for (uint8_t mask = 0x80; mask; mask >>= 1) {
-      uint8_t tmp = ret & 0x80 ? 0x85 : 0;
-      ret <<= 1;
-      if (i < 32) {
-        if (data[i] & mask) {
-          ret |= 0x1;
-        }
-      }
-      ret ^= tmp;
-    }
+  for (uint8_t i = 0; i < 32; i++) {
+    ret = pgm_read_byte(&n64_data_crc_table[ret ^ data[i]]);
   }
   return ret;
 }
@@ -1067,7 +1156,7 @@ void nextscreen() {
     // reset button
     lastbutton = "N/A";
 
-    display.clearDisplay();
+    display_Blank();
     if (startscreen != 4)
       startscreen = startscreen + 1;
     else {
@@ -1180,7 +1269,7 @@ void controllerTest_Display() {
           printSTR("(Continue with START)", 16, 55);
 
           //Update LCD
-          display.updateDisplay();
+          display_Flush();
 
           // go to next screen
           nextscreen();
@@ -1218,11 +1307,11 @@ void controllerTest_Display() {
           if (cmode == 1) {
             display.drawPixel(10 + xax + N64_status.stick_x / 4, 12 + yax - N64_status.stick_y / 4);
             //Update LCD
-            display.updateDisplay();
+            display_Flush();
           } else {
             display.drawCircle(10 + xax + N64_status.stick_x / 4, 12 + yax - N64_status.stick_y / 4, 2);
             //Update LCD
-            display.updateDisplay();
+            display_Flush();
             display_Clear_Slow();
           }
 
@@ -1230,10 +1319,10 @@ void controllerTest_Display() {
           if (button == "Press a button" && lastbutton == "Z") {
             if (cmode == 0) {
               cmode = 1;
-              display.clearDisplay();
+              display_Blank();
             } else {
               cmode = 0;
-              display.clearDisplay();
+              display_Blank();
             }
           }
           // go to next screen
@@ -1257,13 +1346,13 @@ void controllerTest_Display() {
           printSTR("Try to fill the box by", 22, 45);
           printSTR("slowly moving right", 22, 55);
           //Update LCD
-          display.updateDisplay();
+          display_Flush();
 
           if (button == "Press a button" && lastbutton == "Z") {
             // reset button
             lastbutton = "N/A";
 
-            display.clearDisplay();
+            display_Blank();
           }
           // go to next screen
           nextscreen();
@@ -1299,7 +1388,7 @@ void controllerTest_Display() {
                         // reset button
                         lastbutton = "N/A";
                         results = 1;
-                        display.clearDisplay();
+                        display_Blank();
                         break;
                       }
                       printSTR(anastick, 22 + 50, 15);
@@ -1325,7 +1414,7 @@ void controllerTest_Display() {
                       display.drawPixel(xax, yax);
 
                       //Update LCD
-                      display.updateDisplay();
+                      display_Flush();
                       break;
                     }
                   case 1:
@@ -1352,7 +1441,7 @@ void controllerTest_Display() {
                         // reset button
                         lastbutton = "N/A";
                         results = 0;
-                        display.clearDisplay();
+                        display_Blank();
                         break;
                       }
                       printSTR(anastick, 22 + 50, 15);
@@ -1378,7 +1467,7 @@ void controllerTest_Display() {
                       display.drawPixel(xax, yax);
 
                       //Update LCD
-                      display.updateDisplay();
+                      display_Flush();
                       break;
                     }
 
@@ -1398,7 +1487,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                   test = 2;
                 }
                 break;
@@ -1416,7 +1505,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1433,7 +1522,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1450,7 +1539,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1467,7 +1556,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1484,7 +1573,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1501,7 +1590,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1518,7 +1607,7 @@ void controllerTest_Display() {
                   // reset button
                   lastbutton = "N/A";
 
-                  display.clearDisplay();
+                  display_Blank();
                 }
                 break;
               }
@@ -1527,7 +1616,7 @@ void controllerTest_Display() {
             display.drawStr(38, 8, "Benchmark");
             display.drawLine(0, 9, 128, 9);
           }
-          display.updateDisplay();
+          display_Flush();
           // go to next screen
           nextscreen();
           break;
@@ -1575,9 +1664,8 @@ void checkController() {
     print_FatalError(F("Controller Pak not found"));
 }
 
-// read 32bytes from controller pak and calculate CRC
-byte readBlock(byte* output, word myAddress) {
-  byte response_crc;
+// read 32bytes from controller pak, returns 0 on success, 1 on a timeout and 2 on a CRC mismatch
+byte readBlockOnce(byte* output, word myAddress, byte* response_crc) {
   // Calculate the address CRC
   word myAddressCRC = addrCRC(myAddress);
   const byte command[] = { 0x02, (byte)(myAddressCRC >> 8), (byte)(myAddressCRC & 0xff) };
@@ -1588,27 +1676,48 @@ byte readBlock(byte* output, word myAddress) {
   sendJoyBus(command, sizeof(command));
   error = recvJoyBus(output, 32);
   if (error == 0)
-    error = recvJoyBus(&response_crc, 1);
+    error = recvJoyBus(response_crc, 1);
   // end of time sensitive code
   interrupts();
 
-  if (error) {
-    myFile.close();
-    println_Msg(F("Controller Pak was"));
-    println_Msg(F("not dumped due to a"));
-    print_FatalError(F("read timeout"));
-  }
-
+  if (error)
+    return 1;
   // Compare with computed CRC
-  if (response_crc != dataCRC(output)) {
-    display_Clear();
-    // Close the file:
-    myFile.close();
-    println_Msg(F("Controller Pak was"));
-    println_Msg(F("not dumped due to a"));
-    print_FatalError(F("protocol CRC error"));
+  if (*response_crc != dataCRC(output))
+    return 2;
+  return 0;
+}
+
+// read 32bytes from controller pak, a noisy block is read again a few times before giving up
+byte readBlockRetry(byte* output, word myAddress, byte* response_crc) {
+  byte error;
+
+  for (byte attempt = 0; attempt < N64_MPK_READ_RETRIES; attempt++) {
+    error = readBlockOnce(output, myAddress, response_crc);
+    if (error == 0)
+      return 0;
+    // Give the controller time to recover like between banks
+    delayMicroseconds(800);
   }
+  return error;
+}
 
+// read 32bytes from controller pak and calculate CRC, stops the dump if the block can't be read
+byte readBlock(byte* output, word myAddress) {
+  byte response_crc;
+  byte error = readBlockRetry(output, myAddress, &response_crc);
+
+  if (error == 0)
+    return response_crc;
+
+  display_Clear();
+  // Close the file:
+  myFile.close();
+  println_Msg(F("Controller Pak was"));
+  println_Msg(F("not dumped due to a"));
+  if (error == 1)
+    print_FatalError(F("read timeout"));
+  print_FatalError(F("protocol CRC error"));
   return response_crc;
 }
 
@@ -1823,9 +1932,14 @@ void validateMPK() {
   mpk_file.close();
 }
 
+// Only blocks that differ from the Controller Pak are written
 void writeMPK() {
   // 3 command bytes, 32 data bytes
   byte command[3 + 32];
+  byte block[32];
+  byte response_crc;
+  word changedBlocks = 0;
+  word unreadBlocks = 0;
   command[0] = 0x03;
 
   // Create filepath
@@ -1846,18 +1960,26 @@ void writeMPK() {
     for (word address = 0x0000; address < 0x8000; address += 32) {
       myFile.read(command + 3, sizeof(command) - 3);
 
-      word address_with_crc = addrCRC(address);
-      command[1] = (byte)(address_with_crc >> 8);
-      command[2] = (byte)(address_with_crc & 0xff);
+      // Read the block first and skip it if it already holds the same data, write it anyway if it can't be read
+      bool unread = (readBlockRetry(block, address, &response_crc) != 0);
+      if (unread)
+        unreadBlocks++;
+      delayMicroseconds(650);
+      if (unread || (memcmp(block, command + 3, sizeof(block)) != 0)) {
+        word address_with_crc = addrCRC(address);
+        command[1] = (byte)(address_with_crc >> 8);
+        command[2] = (byte)(address_with_crc & 0xff);
 
-      // don't want interrupts getting in the way
-      noInterrupts();
-      sendJoyBus(command, sizeof(command));
-      // Enable interrupts
-      interrupts();
+        // don't want interrupts getting in the way
+        noInterrupts();
+        sendJoyBus(command, sizeof(command));
+        // Enable interrupts
+        interrupts();
+        changedBlocks++;
 
-      // Real N64 has about 627us pause between banks, add a bit extra delay
-      delayMicroseconds(650);
+        // Real N64 has about 627us pause between banks, add a bit extra delay
+        delayMicroseconds(650);
+      }
 
       if ((address & 0x1FF) == 0) {
         // Blink led
@@ -1869,6 +1991,13 @@ void writeMPK() {
     }
     // Close the file:
     myFile.close();
+    print_Msg(changedBlocks);
+    println_Msg(F(" blocks changed"));
+    if (unreadBlocks) {
+      print_Msg(unreadBlocks);
+      println_Msg(F(" not read before write"));
+    }
+    display_Update();
   } else {
     print_FatalError(open_file_STR);
   }
@@ -1936,12 +2065,32 @@ void verifyMPK() {
 /******************************************
   N64 Cartridge functions
 *****************************************/
+// Block reader for probeRomSize(), checkBus() and checkContacts()
+void probeBlock_N64(uint32_t address, byte* data, uint16_t length) {
+  setAddress_N64(romBase + address);
+  for (word c = 0; c < length; c += 2) {
+    word myWord = readWord_N64();
+    data[c] = myWord >> 8;
+    data[c + 1] = myWord & 0xFF;
+  }
+  // Pull ale_H(PC1) high
+  PORTC |= (1 << 1);
+}
+
+// Size of the ROM in MB found by checking where it mirrors or reads as open bus
+byte probeRomSize_N64() {
+  return probeRomSize(&probeBlock_N64, 4UL * 1024 * 1024, 128UL * 1024 * 1024) >> 20;
+}
+
 void printCartInfo_N64() {
   // Check cart
   getCartInfo_N64();
 
   // Print start page
   if (cartSize != 0) {
+    // Ask before dumping more or less than the cart holds
+    cartSize = confirmRomSize((uint32_t)probeRomSize_N64() << 20, cartSize * 1024 * 1024) >> 20;
+
     display_Clear();
     print_Msg(FS(FSTRING_NAME));
     println_Msg(romName);
@@ -2006,11 +2155,17 @@ void printCartInfo_N64() {
     display_Update();
     wait();
 
-    // Set cartsize manually
+    // Set cartsize manually, preselecting the probed size
     unsigned char N64RomMenu;
+    byte defaultChoice = 0;
+    for (byte size = probeRomSize_N64() / 4; size > 1; size >>= 1)
+      defaultChoice++;
+    // Skip 12MB
+    if (defaultChoice > 1)
+      defaultChoice++;
     // Copy menuOptions out of progmem
     convertPgm(romOptionsN64, 7);
-    N64RomMenu = question_box(F("Select ROM size"), menuOptions, 7, 0);
+    N64RomMenu = question_box(F("Select ROM size"), menuOptions, 7, defaultChoice);
 
     // wait for user choice to come back from the question box menu
     switch (N64RomMenu) {
@@ -2375,8 +2530,34 @@ unsigned long verifyEeprom_N64() {
 /******************************************
   SRAM functions
 *****************************************/
-// Write sram to cartridge
-void writeSram(unsigned long sramSize) {
+// Write one block of the save file to sram
+void writeSramBlock_N64(uint32_t offset, const byte* data, uint16_t length) {
+  // Set the address for the next block
+  setAddress_N64(sramBase + offset);
+
+  for (uint16_t c = 0; c < length; c += 2) {
+    // Join bytes to word and write it
+    writeWord_N64((data[c] << 8) | data[c + 1]);
+  }
+}
+
+// Read back one block of sram
+void readSramBlock_N64(uint32_t offset, byte* data, uint16_t length) {
+  // Set the address
+  setAddress_N64(sramBase + offset);
+
+  for (uint16_t c = 0; c < length; c += 2) {
+    // split word
+    word myWord = readWord_N64();
+    data[c] = myWord >> 8;
+    data[c + 1] = myWord & 0xFF;
+  }
+  // Pull ale_H(PC1) high
+  PORTC |= (1 << 1);
+}
+
+// Write sram to cartridge and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeSram(unsigned long sramSize) {
   if (saveType == 1 || saveType == 2) {
     // Create filepath
     sprintf(filePath, "%s/%s", filePath, fileName);
@@ -2386,22 +2567,8 @@ void writeSram(unsigned long sramSize) {
 
     // Open file on sd card
     if (myFile.open(filePath, O_READ)) {
-      for (unsigned long currByte = sramBase; currByte < (sramBase + sramSize); currByte += 512) {
+      writeErrors = writeVerifySave(sramSize, writeSramBlock_N64, readSramBlock_N64);
 
-        // Read save from SD into buffer
-        myFile.read(sdBuffer, 512);
-
-        // Set the address for the next 512 bytes
-        setAddress_N64(currByte);
-
-        for (int c = 0; c < 512; c += 2) {
-          // Join bytes to word
-          word myWord = ((sdBuffer[c] & 0xFF) << 8) | (sdBuffer[c + 1] & 0xFF);
-
-          // Write word
-          writeWord_N64(myWord);
-        }
-      }
       // Close the file:
       myFile.close();
       print_STR(done_STR, 1);
@@ -2413,6 +2580,8 @@ void writeSram(unsigned long sramSize) {
   } else {
     print_FatalError(F("Savetype Error"));
   }
+  // Return 0 if verified ok, or number of errors
+  return writeErrors;
 }
 
 // Read sram and save to the SD card
@@ -2825,6 +2994,13 @@ void getFramType() {
 #ifndef OPTION_N64_FASTCRC
 // dumping rom slow
 void readRom_N64() {
+#ifdef ENABLE_CONFIG
+  checkBus(&probeBlock_N64, 0, cartSize << 20, 16, true);
+#endif
+#ifdef OPTION_CONTACT_CHECK
+  checkContacts(&probeBlock_N64, cartSize << 20, 27, 16);
+#endif
+
   // Get name, add extension and convert to char array for sd lib
   createFolder("N64", "ROM", romName, "Z64");
 
@@ -2851,7 +3027,7 @@ void readRom_N64() {
     setAddress_N64(currByte);
 
     for (word c = 0; c < 512; c += 2) {
-      word myWord = readWord_N64();
+      word myWord = busStrobe16<N64Bus>();
       sdBuffer[c] = myWord >> 8;
       sdBuffer[c + 1] = myWord & 0xFF;
     }
@@ -2867,8 +3043,87 @@ void readRom_N64() {
   myFile.close();
 }
 #else
+// One CRC32 table step for the byte in register b, 26 cycles
+#define N64_CRC_STEP(b) \
+  "eor %A[crc], %[" #b "]\n\t" \
+  "mov r30, %A[crc]\n\t" \
+  "ldi r31, 0\n\t" \
+  "lsl r30\n\t" \
+  "rol r31\n\t" \
+  "lsl r30\n\t" \
+  "rol r31\n\t" \
+  "subi r30, lo8(-(%[tab]))\n\t" \
+  "sbci r31, hi8(-(%[tab]))\n\t" \
+  "lpm %A[t], Z+\n\t" \
+  "lpm %B[t], Z+\n\t" \
+  "lpm %C[t], Z+\n\t" \
+  "lpm %D[t], Z\n\t" \
+  "eor %A[t], %B[crc]\n\t" \
+  "eor %B[t], %C[crc]\n\t" \
+  "eor %C[t], %D[crc]\n\t" \
+  "movw %A[crc], %A[t]\n\t" \
+  "movw %C[crc], %C[t]\n\t"
+
+// Read 512 bytes from the current address into buffer and add them to crc.
+// The CRC of the previous halfword is computed while waiting on the bus
+// instead of spinning in NOPs. Cycle budget per halfword at 16MHz:
+//   /RD low:  2 (sts) + 26 (CRC high byte) + 3 (sample)            = 31 cycles, 1.9us >= 310ns
+//   /RD high: 2 (sts) + 4 (store) + 1 + 26 (CRC low byte) + 3 (loop) = 36 cycles
+//   total 67 cycles, 4.2us per halfword
+// Assumes nothing else changes PORTH while the burst is running.
+uint32_t readBurst_N64(byte* buffer, uint32_t crc) {
+  // The first halfword has nothing to checksum during its wait time
+  word myWord = busStrobe16<N64Bus>();
+  uint8_t prevHi = myWord >> 8;
+  uint8_t prevLo = myWord & 0xFF;
+  buffer[0] = prevHi;
+  buffer[1] = prevLo;
+
+  byte* ptr = buffer + 2;
+  uint8_t rdLow = PORTH & ~(1 << 6);
+  uint8_t rdHigh = PORTH | (1 << 6);
+  uint8_t count = 255;
+  uint8_t curLo;
+  uint16_t z;
+  uint32_t t;
+
+  __asm__ __volatile__(
+    "1:\n\t"
+    // Pull read(PH6) low
+    "sts %[porth], %[rdLow]\n\t"
+    N64_CRC_STEP(prevHi)
+    // Sample AD8-AD15 and AD0-AD7
+    "lds %[prevHi], %[pink]\n\t"
+    "in %[curLo], %[pinf]\n\t"
+    // Pull read(PH6) high, the cart advances to the next halfword
+    "sts %[porth], %[rdHigh]\n\t"
+    "st X+, %[prevHi]\n\t"
+    "st X+, %[curLo]\n\t"
+    N64_CRC_STEP(prevLo)
+    "mov %[prevLo], %[curLo]\n\t"
+    "dec %[count]\n\t"
+    "brne 1b\n\t"
+    : [ptr] "+x"(ptr), [crc] "+r"(crc), [prevHi] "+r"(prevHi), [prevLo] "+r"(prevLo),
+      [count] "+r"(count), [curLo] "=&r"(curLo), [z] "=&z"(z), [t] "=&r"(t)
+    : [rdLow] "r"(rdLow), [rdHigh] "r"(rdHigh), [tab] "i"(crc_32_tab),
+      [porth] "n"(_SFR_MEM_ADDR(PORTH)), [pink] "n"(_SFR_MEM_ADDR(PINK)), [pinf] "I"(_SFR_IO_ADDR(PINF))
+    : "memory");
+
+  // Last halfword
+  UPDATE_CRC(crc, prevHi);
+  UPDATE_CRC(crc, prevLo);
+  return crc;
+}
+
 // dumping rom fast
 uint32_t readRom_N64() {
+#ifdef ENABLE_CONFIG
+  checkBus(&probeBlock_N64, 0, cartSize << 20, 16, true);
+#endif
+#ifdef OPTION_CONTACT_CHECK
+  checkContacts(&probeBlock_N64, cartSize << 20, 27, 16);
+#endif
+
   // Get name, add extension and convert to char array for sd lib
   createFolder("N64", "ROM", romName, "Z64");
 
@@ -2881,7 +3136,7 @@ uint32_t readRom_N64() {
     print_FatalError(create_file_STR);
   }
 
-  byte buffer[1024];
+  ScratchBuffer buffer(1024);
 
   //Initialize progress bar
   uint32_t processedProgressBar = 0;
@@ -2890,9 +3145,14 @@ uint32_t readRom_N64() {
 
   // prepare crc32
   uint32_t oldcrc32 = 0xFFFFFFFF;
+#ifdef OPTION_HASH
+  // The hashes are fed from the buffer too, compareCRC() then doesn't read the file again
+  DumpHash hash;
+  dumpHashInit(&hash);
+#endif
 
   // run combined dumper + crc32 routine for better performance, as N64 ROMs are quite large for an 8bit micro
-  // currently dumps + checksums a 32MB cart in 170 seconds (down from 347 seconds)
+  // the CRC is folded into the bus wait time by readBurst_N64(), see its cycle budget
   for (unsigned long currByte = romBase; currByte < (romBase + (cartSize * 1024 * 1024)); currByte += 1024) {
     // Blink led
     if (currByte % 16384 == 0)
@@ -2902,64 +3162,29 @@ uint32_t readRom_N64() {
     setAddress_N64(currByte);
     // Wait 62.5ns (safety)
     NOP;
-
-    for (int c = 0; c < 512; c += 2) {
-      // Pull read(PH6) low
-      PORTH &= ~(1 << 6);
-      // Wait ~310ns
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-
-      // data on PINK and PINF is valid now, read into sd card buffer
-      buffer[c] = PINK;      // hiByte
-      buffer[c + 1] = PINF;  // loByte
-
-      // Pull read(PH6) high
-      PORTH |= (1 << 6);
-
-      // crc32 update
-      UPDATE_CRC(oldcrc32, buffer[c]);
-      UPDATE_CRC(oldcrc32, buffer[c + 1]);
-    }
+    oldcrc32 = readBurst_N64(buffer, oldcrc32);
 
     // Set the address for the next 512 bytes to dump
     setAddress_N64(currByte + 512);
     // Wait 62.5ns (safety)
     NOP;
-
-    for (int c = 512; c < 1024; c += 2) {
-      // Pull read(PH6) low
-      PORTH &= ~(1 << 6);
-      // Wait ~310ns
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-      NOP;
-
-      // data on PINK and PINF is valid now, read into sd card buffer
-      buffer[c] = PINK;      // hiByte
-      buffer[c + 1] = PINF;  // loByte
-
-      // Pull read(PH6) high
-      PORTH |= (1 << 6);
-
-      // crc32 update
-      UPDATE_CRC(oldcrc32, buffer[c]);
-      UPDATE_CRC(oldcrc32, buffer[c + 1]);
-    }
+    oldcrc32 = readBurst_N64(buffer + 512, oldcrc32);
 
     processedProgressBar += 1024;
     draw_progressbar(processedProgressBar, totalProgressBar);
     // write out 1024 bytes to file
     myFile.write(buffer, 1024);
+#ifdef OPTION_HASH
+    dumpHashUpdate(&hash, buffer, 1024);
+#endif
   }
 
   // Close the file:
   myFile.close();
+#ifdef OPTION_HASH
+  dumpHashFinal(&hash);
+  dumpHashed = true;
+#endif
 
   // Return checksum
   return oldcrc32;
@@ -3035,6 +3260,15 @@ void savesummary_N64(boolean checkfound, char crcStr[9], unsigned long timeElaps
     myFile.println(" [No Match]");
   }
 
+#ifdef OPTION_HASH_SHA1
+  myFile.print(F("SHA-1\t: "));
+  myFile.println(dumpSha1);
+#endif
+#ifdef OPTION_HASH_MD5
+  myFile.print(F("MD5\t: "));
+  myFile.println(dumpMd5);
+#endif
+
   myFile.print(F("Time\t: "));
   myFile.println(timeElapsed);
 
@@ -3736,8 +3970,9 @@ void eraseSector_N64(unsigned long sectorSize) {
   }
 }
 
+// Only the part the file is written to has to be blank, 512 bytes out of every BLANKCHECK_STEP are read
 boolean blankcheckFlashrom_N64() {
-  for (unsigned long currByte = romBase; currByte < romBase + fileSize; currByte += 512) {
+  for (unsigned long currByte = romBase; currByte < romBase + fileSize; currByte += BLANKCHECK_STEP) {
     // Blink led
     if (currByte % 131072 == 0)
       blinkLED();
@@ -3745,10 +3980,13 @@ boolean blankcheckFlashrom_N64() {
     // Set the address
     setAddress_N64(currByte);
 
+    // The cart increments the address by itself, check the words together
+    word blank = 0xFFFF;
     for (int c = 0; c < 512; c += 2) {
-      if (readWord_N64() != 0xFFFF) {
-        return 0;
-      }
+      blank &= readWord_N64();
+    }
+    if (blank != 0xFFFF) {
+      return 0;
     }
   }
   return 1;
@@ -364,6 +364,9 @@ const char _file_name_with_number_fmt[] PROGMEM = "%s.%02d.%s";
   }
 #define MODE_WRITE DDRK = 0xFF
 
+// One address per possible byte value, see scanBusConflicts()
+#define BUS_CONFLICT_TABLE_SIZE (256 * sizeof(uint16_t))
+
 #define press 1
 #define doubleclick 2
 #define hold 3
@@ -393,6 +396,8 @@ uint16_t chr;
 uint8_t ram;
 bool mmc6 = false;
 bool flashfound = false;  // NESmaker 39SF040 Flash Cart
+uint32_t oldcrc32 = 0xFFFFFFFF;
+uint32_t oldcrc32MMC3 = 0xFFFFFFFF;
 
 // Cartridge Config
 uint16_t mapper;
@@ -621,6 +626,12 @@ void setup_NES() {
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
+  mmc6 = false;
+  flashfound = false;
+  // getMapping() adds to these
+  oldcrc32 = 0xFFFFFFFF;
+  oldcrc32MMC3 = 0xFFFFFFFF;
+
   // CPU R/W, IRQ, PPU /RD, PPU /A13, CIRAM /CE, PPU /WR, /ROMSEL, PHI2
   DDRF = 0b10110111;
   // CPU R/W, IRQ, PPU /RD, PPU /A13, CIRAM /CE, PPU /WR, /ROMSEL, PHI2
@@ -781,9 +792,6 @@ void printDataLine_NES(void* entry) {
   printNESSettings();
 }
 
-uint32_t oldcrc32 = 0xFFFFFFFF;
-uint32_t oldcrc32MMC3 = 0xFFFFFFFF;
-
 void getMapping() {
   FsFile database;
   char crcStr[9];
@@ -826,16 +834,37 @@ void getMapping() {
     }
     println_Msg(F("..."));
     display_Update();
-    while (database.available()) {
-      struct database_entry entry;
-
-      readDatabaseEntry(database, &entry);
-      //if checksum search was successful set mapper and end search, also filter out 0xFF checksum
-      if (
-        entry.crc512 != 0xBD7BC39F && (entry.crc512 == oldcrc32 || entry.crc512 == oldcrc32MMC3)) {
-        // Rewind to start of entry
-        rewind_line(database, 3);
-        break;
+
+    FsFile compiled;
+    DbInfo info;
+    if (dbOpen(compiled, "nes.txt", &info)) {
+      // Compare the crc512 field of the compiled database instead of parsing text
+      byte record[DB_MAX_RECORD];
+      // Stay at the end of the .txt unless a match is found
+      database.seekSet(database.fileSize());
+      while ((info.fieldCount > 1) && (info.fieldType[1] == DB_FIELD_HEX32) && dbNext(compiled, info, record)) {
+        uint32_t crc512;
+        memcpy(&crc512, record + info.fieldOffset[1], 4);
+        //if checksum search was successful set mapper and end search, also filter out 0xFF checksum
+        if (crc512 != 0xBD7BC39F && (crc512 == oldcrc32 || crc512 == oldcrc32MMC3)) {
+          // Go to start of entry
+          database.seekSet(dbTxtOffset(record));
+          break;
+        }
+      }
+      compiled.close();
+    } else {
+      while (database.available()) {
+        struct database_entry entry;
+
+        readDatabaseEntry(database, &entry);
+        //if checksum search was successful set mapper and end search, also filter out 0xFF checksum
+        if (
+          entry.crc512 != 0xBD7BC39F && (entry.crc512 == oldcrc32 || entry.crc512 == oldcrc32MMC3)) {
+          // Rewind to start of entry
+          rewind_line(database, 3);
+          break;
+        }
       }
     }
     if (database.available()) {
@@ -916,6 +945,14 @@ bool selectMapping(FsFile& database) {
 }
 
 void read_NES(const char* fileSuffix, const byte* header, const uint8_t headersize, const boolean renamerom) {
+  // The PRG window at 0x8000, a 16K PRG mirrors itself on A14
+#ifdef ENABLE_CONFIG
+  checkBus(&probeBlock_NES, 0, (prgsize > 0) ? 0x8000 : 0x4000, 8, false);
+#endif
+#ifdef OPTION_CONTACT_CHECK
+  checkContacts(&probeBlock_NES, (prgsize > 0) ? 0x8000 : 0x4000, 15, 8);
+#endif
+
   // Get name, add extension and convert to char array for sd lib
   createFolderAndOpenFile("NES", "ROM", romName, fileSuffix);
 
@@ -966,16 +1003,13 @@ void readRaw_NES() {
    Low Level Functions
  *****************************************/
 static void set_address(unsigned int address) {
-  unsigned char l = address & 0xFF;
-  unsigned char h = address >> 8;
-  PORTL = l;
-  PORTA = h;
+  busAddress16<NesBus>(address);
 
   // PPU /A13
   if ((address >> 13) & 1)
-    PORTF &= ~(1 << 4);
+    NesBus::PpuA13n::low();
   else
-    PORTF |= 1 << 4;
+    NesBus::PpuA13n::high();
 }
 
 static void set_romsel(unsigned int address) {
@@ -997,6 +1031,13 @@ static unsigned char read_prg_byte(unsigned int address) {
   return PINK;
 }
 
+// Block reader for checkBus() and checkContacts(), address is relative to the PRG window at 0x8000
+void probeBlock_NES(uint32_t address, byte* data, uint16_t length) {
+  for (uint16_t c = 0; c < length; c++) {
+    data[c] = read_prg_byte(0x8000 + address + c);
+  }
+}
+
 static unsigned char read_chr_byte(unsigned int address) {
   MODE_READ;
   PHI2_HI;
@@ -1038,6 +1079,41 @@ static void write_prg_byte(unsigned int address, uint8_t data) {
   //  _delay_us(1);
 }
 
+// Boards with bus conflicts need the value written to a bank register to match the ROM byte at
+// that address. Scans the fixed PRG area once and returns the first address of every byte value,
+// or 0 for values that do not occur, so every bank switch can reuse the same lookup.
+static uint16_t* scanBusConflicts(ScratchBuffer& buffer, unsigned int start, unsigned int length) {
+  uint16_t* table = (uint16_t*)(uint8_t*)buffer;
+  uint16_t found = 0;
+
+  memset(table, 0, BUS_CONFLICT_TABLE_SIZE);
+  for (unsigned int x = 0; (x < length) && (found < 256); x++) {
+    uint8_t value = read_prg_byte(start + x);
+    if (table[value] == 0) {
+      table[value] = start + x;
+      found++;
+    }
+  }
+  return table;
+}
+
+// Write value to a ROM address holding the same value, or to fallback if there is none
+static void writeBusConflict(const uint16_t* table, unsigned int fallback, uint8_t value) {
+  write_prg_byte(table[value] ? table[value] : fallback, value);
+}
+
+// For registers that also switch the PRG area, writes value to the first address in it holding
+// the same value, or to start + value if there is none. Stops reading at the first match.
+static void writeBusConflictSearch(unsigned int start, unsigned int length, uint8_t value) {
+  for (unsigned int x = 0; x < length; x++) {
+    if (read_prg_byte(start + x) == value) {
+      write_prg_byte(start + x, value);
+      return;
+    }
+  }
+  write_prg_byte(start + value, value);
+}
+
 #if defined(ENABLE_FLASH)
 static void write_chr_byte(unsigned int address, uint8_t data) {
   PHI2_LOW;
@@ -1268,12 +1344,14 @@ void CreateROMFolderInSD() {
   sd.chdir(folder);
 }
 
-FsFile createNewFile(const char* prefix, const char* extension) {
+// Opens myFile, through myFile.open() so compare mode sees it
+void createNewFile(const char* prefix, const char* extension) {
   char filename[FILENAME_LENGTH];
   snprintf_P(filename, sizeof(filename), _file_name_no_number_fmt, prefix, extension);
   for (uint8_t i = 0; i < 100; i++) {
     if (!sd.exists(filename)) {
-      return sd.open(fileName, O_RDWR | O_CREAT);
+      myFile.open(fileName, O_RDWR | O_CREAT);
+      return;
     }
     snprintf_P(filename, sizeof(filename), _file_name_with_number_fmt, prefix, i, extension);
   }
@@ -1292,11 +1370,11 @@ FsFile createNewFile(const char* prefix, const char* extension) {
 }
 
 void CreatePRGFileInSD() {
-  myFile = createNewFile("PRG", "bin");
+  createNewFile("PRG", "bin");
 }
 
 void CreateCHRFileInSD() {
-  myFile = createNewFile("CHR", "bin");
+  createNewFile("CHR", "bin");
 }
 
 //createNewFile fails to dump RAM if ROM isn't dumped first
@@ -1310,7 +1388,7 @@ void CreateRAMFileInSD() {
   strcat(fileName, ".sav");
   for (uint8_t i = 0; i < 100; i++) {
     if (!sd.exists(fileName)) {
-      myFile = sd.open(fileName, O_RDWR | O_CREAT);
+      myFile.open(fileName, O_RDWR | O_CREAT);
       break;
     }
     sprintf(fileCount, "%02d", i);
@@ -1402,7 +1480,7 @@ chooseMapper:
       display.setDrawColor(1);
       display.drawLine(60, 30, 70, 30);
     }
-    display.updateDisplay();
+    display_Flush();
 
     while (1) {
       /* Check Button
@@ -1482,7 +1560,7 @@ chooseMapper:
   if (!validMapper) {
     errorLvl = 1;
     display.println(F("Mapper not supported"));
-    display.updateDisplay();
+    display_Flush();
     wait();
     goto chooseMapper;
   }
@@ -2023,7 +2101,6 @@ void readPRG(bool readrom) {
   }
 
   word base = 0x8000;
-  bool busConflict = false;
   uint16_t banks;
 
   if (myFile) {
@@ -2067,20 +2144,14 @@ void readPRG(bool readrom) {
 
       case 2:   // bus conflicts - fixed last bank
       case 30:  // bus conflicts in non-flashable configuration
-        banks = int_pow(2, prgsize);
-        busConflict = true;
-        for (size_t i = 0; i < banks; i++) {
-          for (size_t x = 0; x < 0x8000; x++) {
-            if (read_prg_byte(0xC000 + x) == i) {
-              write_prg_byte(0xC000 + x, i);
-              busConflict = false;
-              break;
-            }
-          }
-          if (busConflict) {
-            write_prg_byte(0xC000 + i, i);
+        {
+          banks = int_pow(2, prgsize);
+          ScratchBuffer buffer(BUS_CONFLICT_TABLE_SIZE);
+          uint16_t* conflictTable = scanBusConflicts(buffer, 0xC000, 0x4000);
+          for (size_t i = 0; i < banks; i++) {
+            writeBusConflict(conflictTable, 0xC000 + i, i);
+            dumpBankPRG(0x0, 0x4000, base);
           }
-          dumpBankPRG(0x0, 0x4000, base);
         }
         break;
 
@@ -2797,20 +2868,14 @@ void readPRG(bool readrom) {
         break;
 
       case 94:  // bus conflicts - fixed last bank
-        banks = int_pow(2, prgsize);
-        busConflict = true;
-        for (size_t i = 0; i < banks; i++) {
-          for (size_t x = 0; x < 0x4000; x++) {
-            if (read_prg_byte(0xC000 + x) == (i << 2)) {
-              write_prg_byte(0xC000 + x, i << 2);
-              busConflict = false;
-              break;
-            }
-          }
-          if (busConflict) {
-            write_prg_byte(0x8000 + i, i << 2);
+        {
+          banks = int_pow(2, prgsize);
+          ScratchBuffer buffer(BUS_CONFLICT_TABLE_SIZE);
+          uint16_t* conflictTable = scanBusConflicts(buffer, 0xC000, 0x4000);
+          for (size_t i = 0; i < banks; i++) {
+            writeBusConflict(conflictTable, 0x8000 + i, i << 2);
+            dumpBankPRG(0x0, 0x4000, base);
           }
-          dumpBankPRG(0x0, 0x4000, base);
         }
         break;
 
@@ -3434,7 +3499,6 @@ void readCHR(bool readrom) {
   }
 
   uint16_t banks;
-  bool busConflict = false;
 
   rgbLed(green_color);
   set_address(0);
@@ -3466,24 +3530,26 @@ void readCHR(bool readrom) {
           break;
 
         case 3:  // 8K/16K/32K - bus conflicts
+          {
+            banks = int_pow(2, chrsize) / 2;
+            ScratchBuffer buffer(BUS_CONFLICT_TABLE_SIZE);
+            uint16_t* conflictTable = scanBusConflicts(buffer, 0x8000, 0x8000);
+            for (size_t i = 0; i < banks; i++) {
+              writeBusConflict(conflictTable, 0x8000 + i, i);
+              dumpBankCHR(0x0, 0x2000);
+            }
+          }
+          break;
+
         case 29:
         case 66:  // 16K/32K
         case 70:
         case 148:  // Sachen SA-008-A and Tengen 800008 - Bus conflicts
         case 152:  // 128K
+          // The register also switches PRG at 0x8000-0xFFFF, so every write searches the PRG bank the last one mapped
           banks = int_pow(2, chrsize) / 2;
-          busConflict = true;
           for (size_t i = 0; i < banks; i++) {
-            for (size_t x = 0; x < 0x8000; x++) {
-              if (read_prg_byte(0x8000 + x) == i) {
-                write_prg_byte(0x8000 + x, i);
-                busConflict = false;
-                break;
-              }
-            }
-            if (busConflict) {
-              write_prg_byte(0x8000 + i, i);
-            }
+            writeBusConflictSearch(0x8000, 0x8000, i);
             dumpBankCHR(0x0, 0x2000);
           }
           break;
@@ -4516,9 +4582,7 @@ void readRAM() {
               eepsize = 128;
             else
               eepsize = 256;
-            for (size_t address = 0; address < eepsize; address++) {
-              EepromREAD(address);
-            }
+            EepromREAD(sdBuffer, eepsize);
             myFile.write(sdBuffer, eepsize);
             //          display_Clear(); // TEST PURPOSES - DISPLAY EEPROM DATA
             break;
@@ -4644,6 +4708,7 @@ void writeRAM() {
 
     //open file on sd card
     if (myFile.open(filePath, O_READ)) {
+      writeErrors = 0;
       switch (mapper) {
         case 0:                                        // 2K/4K
           writeBankPRG(0x0, (0x800 * ramsize), base);  // 2K/4K
@@ -4716,14 +4781,22 @@ void writeRAM() {
               eepsize = 128;
             else
               eepsize = 256;
+            uint8_t pagesize = EepromPageSize(eepsize);
             myFile.read(sdBuffer, eepsize);
-            for (size_t address = 0; address < eepsize; address++) {
-              EepromWRITE(address);
+            for (size_t address = 0; address < eepsize; address += pagesize) {
+              EepromWRITE(address, pagesize);
               if ((address % 128) == 0)
                 display_Clear();
               print_Msg(F("."));
               display_Update();
             }
+            // Read back, a page the chip did not take shows up here
+            ScratchBuffer readBack(256);
+            EepromREAD(readBack, eepsize);
+            for (size_t x = 0; x < eepsize; x++) {
+              if (readBack[x] != sdBuffer[x])
+                writeErrors++;
+            }
             break;
           }
         case 19:
@@ -4807,11 +4880,17 @@ void writeRAM() {
           break;
       }
       myFile.close();
-      rgbLed(green_color);
-
       println_Msg(FS(FSTRING_EMPTY));
-      println_Msg(F("RAM FILE WRITTEN!"));
-      display_Update();
+      if (writeErrors) {
+        print_STR(error_STR, 0);
+        print_Msg(writeErrors);
+        print_STR(_bytes_STR, 1);
+        print_Error(did_not_verify_STR);
+      } else {
+        rgbLed(green_color);
+        println_Msg(F("RAM FILE WRITTEN!"));
+        display_Update();
+      }
 
     } else {
       print_FatalError(sd_error_STR);
@@ -4848,166 +4927,59 @@ void resetEEPROM() {
   EEPROM_writeAnything(11, 0);  // RAM SIZE
 }
 
-void EepromStart_NES() {
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
-  write_prg_byte(0x800D, 0x60);  // sda, scl high
-  write_prg_byte(0x800D, 0x20);  // sda low, scl high
-  write_prg_byte(0x800D, 0x00);  // START
-}
+// Bandai FCG EEPROM port: SCL = bit 5, SDA = bit 6, bit 7 enables reading SDA at $6000
+// The protocol itself is in I2cEeprom (SerialEeprom.h)
+uint8_t eepLines_NES;
 
-void EepromStop_NES() {
-  write_prg_byte(0x800D, 0x00);  // sda, scl low
-  write_prg_byte(0x800D, 0x20);  // sda low, scl high
-  write_prg_byte(0x800D, 0x60);  // sda, scl high
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x00);  // STOP
-}
-
-void EepromSet0_NES() {
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
-  write_prg_byte(0x800D, 0x20);  // sda low, scl high // 0
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
-}
-
-void EepromSet1_NES() {
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x60);  // sda high, scl high // 1
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
+void setEepLine_NES(uint8_t line, bool high) {
+  if (high)
+    eepLines_NES |= line;
+  else
+    eepLines_NES &= ~line;
+  write_prg_byte(0x800D, eepLines_NES);
 }
 
-void EepromStatus_NES() {        // ACK
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x60);  // sda high, scl high
-  write_prg_byte(0x800D, 0xE0);  // sda high, scl high, read high
-  uint8_t eepStatus = 1;
-  do {
-    eepStatus = (read_prg_byte(0x6000) & 0x10) >> 4;
-    delayMicroseconds(4);
-  } while (eepStatus == 1);
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
+bool sampleEepSda_NES() {
+  write_prg_byte(0x800D, eepLines_NES | 0x80);  // read high
+  return (read_prg_byte(0x6000) & 0x10) >> 4;   // Read 0x6000 with Mask 0x10 (bit 4)
 }
 
-void EepromReadData_NES() {
-  // read serial data into buffer
-  for (uint8_t i = 0; i < 8; i++) {
-    write_prg_byte(0x800D, 0x60);                     // sda high, scl high, read low
-    write_prg_byte(0x800D, 0xE0);                     // sda high, scl high, read high
-    eepbit[i] = (read_prg_byte(0x6000) & 0x10) >> 4;  // Read 0x6000 with Mask 0x10 (bit 4)
-    write_prg_byte(0x800D, 0x40);                     // sda high, scl low
+struct NesEepLines {
+  // One mapper write already takes longer than tLOW/tHIGH
+  static constexpr uint8_t lowCycles = 0;
+  static constexpr uint8_t highCycles = 0;
+  static void sda(bool high) {
+    setEepLine_NES(0x40, high);
   }
-}
-
-void EepromDevice_NES() {  // 24C02 ONLY
-  EepromSet1_NES();
-  EepromSet0_NES();
-  EepromSet1_NES();
-  EepromSet0_NES();
-  EepromSet0_NES();  // A2
-  EepromSet0_NES();  // A1
-  EepromSet0_NES();  // A0
-}
-
-void EepromReadMode_NES() {
-  EepromSet1_NES();    // READ
-  EepromStatus_NES();  // ACK
-}
-void EepromWriteMode_NES() {
-  EepromSet0_NES();    // WRITE
-  EepromStatus_NES();  // ACK
-}
-
-void EepromFinish_NES() {
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x60);  // sda high, scl high
-  write_prg_byte(0x800D, 0x40);  // sda high, scl low
-  write_prg_byte(0x800D, 0x00);  // sda low, scl low
-}
-
-void EepromSetAddress01(uint8_t address) {  // 24C01 [Little Endian]
-  for (uint8_t i = 0; i < 7; i++) {
-    if (address & 0x1)  // Bit is HIGH
-      EepromSet1_NES();
-    else  // Bit is LOW
-      EepromSet0_NES();
-    address >>= 1;  // rotate to the next bit
+  static void scl(bool high) {
+    setEepLine_NES(0x20, high);
   }
-}
-
-void EepromSetAddress02(uint8_t address) {  // 24C02
-  for (uint8_t i = 0; i < 8; i++) {
-    if ((address >> 7) & 0x1)  // Bit is HIGH
-      EepromSet1_NES();
-    else  // Bit is LOW
-      EepromSet0_NES();
-    address <<= 1;  // rotate to the next bit
+  static bool sample() {
+    return sampleEepSda_NES();
   }
-  EepromStatus_NES();  // ACK
-}
+};
 
-void EepromWriteData01() {  // 24C01 [Little Endian]
-  for (uint8_t i = 0; i < 8; i++) {
-    if (eeptemp & 0x1)  // Bit is HIGH
-      EepromSet1_NES();
-    else  // Bit is LOW
-      EepromSet0_NES();
-    eeptemp >>= 1;  // rotate to the next bit
-  }
-  EepromStatus_NES();  // ACK
+// 24C01 [Little Endian] on mapper 159, 24C02 on mapper 16
+I2C_ADDRESSING eepAddressing_NES() {
+  return (mapper == 159) ? I2C_X24C01_LSB : I2C_24C02;
 }
 
-void EepromWriteData02() {  // 24C02
-  for (uint8_t i = 0; i < 8; i++) {
-    if ((eeptemp >> 7) & 0x1)  // Bit is HIGH
-      EepromSet1_NES();
-    else  // Bit is LOW
-      EepromSet0_NES();
-    eeptemp <<= 1;  // rotate to the next bit
-  }
-  EepromStatus_NES();  // ACK
+uint8_t EepromPageSize(size_t eepsize) {
+  return I2cEeprom<NesEepLines>::pageSize(eepsize, eepAddressing_NES());
 }
 
-void EepromREAD(uint8_t address) {
-  EepromStart_NES();              // START
-  if (mapper == 159) {            // 24C01
-    EepromSetAddress01(address);  // 24C01 [Little Endian]
-    EepromReadMode_NES();
-    EepromReadData_NES();
-    EepromFinish_NES();
-    EepromStop_NES();  // STOP
-    // OR 8 bits into byte
-    eeptemp = eepbit[7] << 7 | eepbit[6] << 6 | eepbit[5] << 5 | eepbit[4] << 4 | eepbit[3] << 3 | eepbit[2] << 2 | eepbit[1] << 1 | eepbit[0];
-  } else {               // 24C02
-    EepromDevice_NES();  // DEVICE [1010] + ADDR [A2-A0]
-    EepromWriteMode_NES();
-    EepromSetAddress02(address);
-    EepromStart_NES();   // START
-    EepromDevice_NES();  // DEVICE [1010] + ADDR [A2-A0]
-    EepromReadMode_NES();
-    EepromReadData_NES();
-    EepromFinish_NES();
-    EepromStop_NES();  // STOP
-    // OR 8 bits into byte
-    eeptemp = eepbit[0] << 7 | eepbit[1] << 6 | eepbit[2] << 5 | eepbit[3] << 4 | eepbit[4] << 3 | eepbit[5] << 2 | eepbit[6] << 1 | eepbit[7];
-  }
-  sdBuffer[address] = eeptemp;
+// Sequential read into output
+void EepromREAD(uint8_t* output, size_t eepsize) {
+  eepLines_NES = 0;
+  setEepLine_NES(0x40, 0);  // sda low, scl low
+  I2cEeprom<NesEepLines>::read(0, output, eepsize, eepAddressing_NES());
 }
 
-void EepromWRITE(uint8_t address) {
-  eeptemp = sdBuffer[address];
-  EepromStart_NES();              // START
-  if (mapper == 159) {            // 24C01
-    EepromSetAddress01(address);  // 24C01 [Little Endian]
-    EepromWriteMode_NES();
-    EepromWriteData01();  // 24C01 [Little Endian]
-  } else {                // 24C02
-    EepromDevice_NES();   // DEVICE [1010] + ADDR [A2-A0]
-    EepromWriteMode_NES();
-    EepromSetAddress02(address);
-    EepromWriteData02();
-  }
-  EepromStop_NES();  // STOP
+// Page write from sdBuffer
+void EepromWRITE(uint8_t address, uint8_t length) {
+  eepLines_NES = 0;
+  setEepLine_NES(0x40, 0);  // sda low, scl low
+  I2cEeprom<NesEepLines>::write(address, sdBuffer + address, length, eepAddressing_NES());
 }
 
 #if defined(ENABLE_FLASH)
@@ -5121,7 +5093,7 @@ void writeFLASH() {
 
 #if (defined(ENABLE_LCD) || defined(ENABLE_OLED))
         display.print(F("*"));
-        display.updateDisplay();
+        display_Flush();
 #else
         Serial.print(F("*"));
         if ((i != 0) && ((i + 1) % 16 == 0))
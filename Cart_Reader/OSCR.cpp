@@ -11,6 +11,12 @@
 *       VOLTS   setVoltage( Voltage )
 *       long    configGetLong( Key, OnFailure )
 *       String  configGetStr( Key )
+*       int     freeRam()
+*       uint16_t stackUnused()
+*       void    inputInit()
+*       INPUT_EVENT inputRead()
+*       void    inputClear()
+*       void    inputWaitRelease()
 *
 * NOTES :
 *       This file is a WIP, I've been moving things into it on my local working
@@ -102,8 +108,234 @@ bool loggingEnabled = true;
 # endif /* ENABLE_GLOBAL_LOG */
 #endif /* ENABLE_CONFIG */
 
+// Scratch arena
+static uint8_t scratchArena[OPTION_SCRATCH_SIZE];
+static uint16_t scratchTop = 0;
+uint16_t scratchPeak = 0;
+
+// Heap/stack boundaries provided by avr-libc and the linker
+extern char __heap_start;
+extern char* __brkval;
+extern char __stack;
+
+// Value used to mark unused stack, see paintStack()
+constexpr uint8_t STACK_CANARY = 0xC5;
+
+// Input queue, filled by the timer 0 compare interrupt
+static volatile INPUT_EVENT inputQueue[INPUT_QUEUE_SIZE];
+volatile uint8_t inputHead = 0;
+volatile uint8_t inputTail = 0;
+// Last 8 samples of each button, 1 meaning pressed
+static volatile uint8_t inputHistory[2];
+
 /*==== /VARIABLES =================================================*/
 
+extern void print_FatalError(const __FlashStringHelper* errorMessage) __attribute__((noreturn));
+
+/*F******************************************************************
+* NAME :            ScratchBuffer( Size )
+*
+* DESCRIPTION :     Borrow a buffer from the scratch arena
+*
+* INPUTS :
+*       PARAMETERS:
+*           uint16_t   Size              Number of bytes needed
+*
+* PROCESS :
+*                   [1]  Remember the current top of the arena
+*                   [2]  Stop if the request does not fit
+*                   [3]  Hand out the space and update the peak
+*
+* NOTES :
+*       The destructor returns the arena to the remembered top, so
+*       buffers must be released in reverse order of allocation. This
+*       is automatic as long as they are only used as local variables.
+*
+*F*/
+ScratchBuffer::ScratchBuffer(uint16_t size)
+  : mark(scratchTop) /*[1]*/ {
+  if (size > (OPTION_SCRATCH_SIZE - scratchTop)) {
+    print_FatalError(F("Scratch arena too small")); /*[2]*/
+  }
+  data = scratchArena + scratchTop; /*[3]*/
+  scratchTop += size;
+  if (scratchTop > scratchPeak) scratchPeak = scratchTop;
+}
+
+ScratchBuffer::~ScratchBuffer() {
+  scratchTop = mark;
+}
+
+// Frees the whole arena, for a warm restart that skips the destructors
+void scratchReset() {
+  scratchTop = 0;
+}
+
+// Starts a new peak from the buffers in use right now
+void scratchResetPeak() {
+  scratchPeak = scratchTop;
+}
+
+/*F******************************************************************
+* NAME :            void paintStack()
+*
+* DESCRIPTION :     Fill all unused RAM with STACK_CANARY before main()
+*
+* NOTES :
+*       Runs from .init1, before the C runtime sets up r1 and .bss, so
+*       it has to be written in assembly. rebootArduino() jumps to 0 and
+*       therefore repaints the RAM for every run, a warm restart does
+*       not.
+*
+*F*/
+void paintStack() __attribute__((naked, used, section(".init1")));
+void paintStack() {
+  __asm__ __volatile__(
+    "    ldi r30, lo8(_end)" "\n\t"
+    "    ldi r31, hi8(_end)" "\n\t"
+    "    ldi r24, %0" "\n\t"
+    "    ldi r25, hi8(__stack)" "\n\t"
+    "    rjmp 2f" "\n\t"
+    "1:  st Z+, r24" "\n\t"
+    "2:  cpi r30, lo8(__stack)" "\n\t"
+    "    cpc r31, r25" "\n\t"
+    "    brlo 1b" "\n\t"
+    "    breq 1b"
+    : /* no outputs */
+    : "M" (STACK_CANARY)
+  );
+}
+
+/*F******************************************************************
+* NAME :            int freeRam()
+*
+* DESCRIPTION :     Bytes currently free between the heap and the stack
+*
+*F*/
+int freeRam() {
+  char top;
+  return &top - (__brkval == 0 ? &__heap_start : __brkval);
+}
+
+/*F******************************************************************
+* NAME :            uint16_t stackUnused()
+*
+* DESCRIPTION :     Bytes of RAM the stack has never reached since boot
+*
+* NOTES :
+*       Counts the painted bytes above the heap. Subtract this from
+*       freeRam() at boot to get the deepest stack use of this run.
+*
+*F*/
+uint16_t stackUnused() {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(__brkval == 0 ? &__heap_start : __brkval);
+  uint16_t count = 0;
+
+  while ((p < reinterpret_cast<const uint8_t*>(&__stack)) && (*p == STACK_CANARY)) {
+    p++;
+    count++;
+  }
+  return count;
+}
+
+/*F******************************************************************
+* NAME :            void inputInit()
+*
+* DESCRIPTION :     Start sampling the buttons into the input queue
+*
+* NOTES :
+*       Timer 0 already runs millis(), its compare match A interrupt
+*       is unused by the core and fires once per overflow (~1ms).
+*
+*F*/
+void inputInit() {
+#if (defined(ENABLE_OLED) || (defined(ENABLE_LCD) && defined(ENABLE_ROTARY)))
+  OCR0A = 0x80;
+  TIMSK0 |= (1 << OCIE0A);
+#endif
+}
+
+/*F******************************************************************
+* NAME :            INPUT_EVENT inputRead()
+*
+* DESCRIPTION :     Take the oldest event out of the input queue
+*
+* RETURNS :
+*       INPUT_EVENT   The event, INPUT_NONE if the queue is empty
+*
+*F*/
+INPUT_EVENT inputRead() {
+  INPUT_EVENT event = INPUT_NONE;
+
+  if (inputTail != inputHead) {
+    event = inputQueue[inputTail];
+    inputTail = (inputTail + 1) % INPUT_QUEUE_SIZE;
+  }
+  return event;
+}
+
+/*F******************************************************************
+* NAME :            void inputClear()
+*
+* DESCRIPTION :     Drop all queued events
+*
+*F*/
+void inputClear() {
+  inputTail = inputHead;
+}
+
+/*F******************************************************************
+* NAME :            void inputWaitRelease()
+*
+* DESCRIPTION :     Wait until no button has been down for 8ms
+*
+* NOTES :
+*       Keeps the press that canceled an operation from also being
+*       taken as the answer to the next prompt.
+*
+*F*/
+void inputWaitRelease() {
+  while ((inputHistory[0] | inputHistory[1]) != 0) {
+  }
+}
+
+/*F******************************************************************
+* NAME :            ISR( TIMER0_COMPA_vect )
+*
+* DESCRIPTION :     Sample the buttons and queue debounced presses
+*
+* PROCESS :
+*                   [1]  Shift the current state of each button into
+*                        its history, 1 meaning pressed
+*                   [2]  Released once followed by 7 pressed samples
+*                        is a press, queue it unless the queue is full
+*
+*F*/
+#if (defined(ENABLE_OLED) || (defined(ENABLE_LCD) && defined(ENABLE_ROTARY)))
+static void inputPush(INPUT_EVENT event) {
+  uint8_t next = (inputHead + 1) % INPUT_QUEUE_SIZE;
+
+  if (next != inputTail) {
+    inputQueue[inputHead] = event;
+    inputHead = next;
+  }
+}
+
+ISR(TIMER0_COMPA_vect) {
+#if defined(ENABLE_OLED)
+  // Button 1 (PD7)
+  inputHistory[0] = (inputHistory[0] << 1) | !(PIND & (1 << 7)); /*[1]*/
+  if (inputHistory[0] == 0x7F) inputPush(INPUT_BUTTON1);         /*[2]*/
+#endif /* ENABLE_OLED */
+
+#if (defined(ENABLE_BUTTON2) || defined(ENABLE_LCD))
+  // Button 2 or rotary encoder button (PG2)
+  inputHistory[1] = (inputHistory[1] << 1) | !(PING & (1 << 2)); /*[1]*/
+  if (inputHistory[1] == 0x7F) inputPush(INPUT_BUTTON2);         /*[2]*/
+#endif /* ENABLE_BUTTON2 || ENABLE_LCD */
+}
+#endif
+
 /*F******************************************************************
 * NAME :            void printVersionToSerial()
 *
@@ -432,6 +432,12 @@ enum SYSTEM_MENU: uint8_t {
 # if defined(ENABLE_CPS3)
   SYSTEM_MENU_CPS3,
 # endif
+# if defined(ENABLE_COMPARE)
+  SYSTEM_MENU_COMPARE,
+# endif
+# if defined(ENABLE_SD_BENCHMARK)
+  SYSTEM_MENU_SD_BENCHMARK,
+# endif
 # if defined(ENABLE_SELFTEST)
   SYSTEM_MENU_SELFTEST,
 # endif
@@ -489,12 +495,133 @@ extern VOLTS voltage;
 
 /*==== /VARIABLES =================================================*/
 
+/*==== SCRATCH ARENA ==============================================*/
+
+static_assert((OPTION_SCRATCH_SIZE % 512) == 0, "OPTION_SCRATCH_SIZE must be a multiple of 512");
+
+/**
+ * Scratch Buffer
+ *
+ * Borrows a buffer from the static scratch arena for the lifetime of
+ * the object. Buffers are released in reverse order when they go out
+ * of scope, so only declare them as local variables.
+ *
+ *   ScratchBuffer buffer(1024);
+ *   myFile.write(buffer, 1024);
+ **/
+class ScratchBuffer {
+  public:
+  explicit ScratchBuffer(uint16_t size);
+  ~ScratchBuffer();
+  operator uint8_t*() { return data; }
+
+  private:
+  ScratchBuffer(const ScratchBuffer&) = delete;
+  ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+  uint8_t* data;
+  uint16_t mark;
+};
+
+// Highest number of arena bytes in use at once since the last scratchResetPeak()
+extern uint16_t scratchPeak;
+
+extern void scratchReset();
+extern void scratchResetPeak();
+
+/*==== /SCRATCH ARENA =============================================*/
+
+/*==== INPUT QUEUE ================================================*/
+
+#define INPUT_QUEUE_SIZE 8
+
+/**
+ * Input Queue
+ *
+ * The timer 0 compare interrupt samples the buttons once per ms and
+ * queues a debounced event for every press, so presses are kept even
+ * while a dump or flash operation is too busy to poll the buttons.
+ **/
+enum INPUT_EVENT : uint8_t {
+  INPUT_NONE = 0,
+  INPUT_BUTTON1 = 1,
+  INPUT_BUTTON2 = 2,
+};
+
+extern volatile uint8_t inputHead;
+extern volatile uint8_t inputTail;
+
+// True if a button was pressed since the last inputClear(), cheap enough to check for every block
+inline bool inputPending() {
+  return inputHead != inputTail;
+}
+
+/*==== /INPUT QUEUE ===============================================*/
+
+/*==== COMPARE MODE ===============================================*/
+
+# if defined(ENABLE_COMPARE)
+
+#define COMPARE_MAX_RANGES 6
+
+enum COMPARE_STATE : uint8_t {
+  COMPARE_OFF = 0,
+  COMPARE_ARMED = 1,   // The next file a core creates opens the reference instead
+  COMPARE_ACTIVE = 2,  // Writes are compared against the reference
+  COMPARE_DONE = 3,    // Reported, checksum/CRC32 checks and save_log() are skipped until the next file is created
+};
+
+extern COMPARE_STATE compareState;
+extern uint32_t compareDiffBytes;
+
+/**
+ * Dump File
+ *
+ * Type of myFile. While a compare is active it holds the reference
+ * file opened read only and every write is compared against it at
+ * the current position instead of written, so the ROM readers of all
+ * cores work unchanged. Otherwise it is a plain FsFile.
+ *
+ * The overrides are not virtual: helpers that write the dump take a
+ * DumpFile, and cores open it with myFile.open() instead of assigning
+ * an FsFile to it.
+ **/
+class DumpFile : public FsFile {
+public:
+  using FsFile::open;
+  using FsFile::write;
+
+  bool open(const char* path, oflag_t oflag = O_RDONLY);
+  bool close();
+  size_t write(const uint8_t* buffer, size_t size);
+  size_t write(const void* buffer, size_t size) {
+    return write((const uint8_t*)buffer, size);
+  }
+  size_t write(uint8_t b) {
+    return write(&b, 1);
+  }
+};
+
+# else /* !ENABLE_COMPARE */
+
+// Without compare mode the dump file is a plain FsFile
+typedef FsFile DumpFile;
+
+# endif /* ENABLE_COMPARE */
+
+/*==== /COMPARE MODE ==============================================*/
+
 /*==== FUNCTIONS ==================================================*/
 
 extern void printVersionToSerial();
 extern void setClockScale(VOLTS __x);
 extern void setClockScale(CLKSCALE __x);
 extern VOLTS setVoltage(VOLTS volts);
+extern int freeRam();
+extern uint16_t stackUnused();
+extern void inputInit();
+extern INPUT_EVENT inputRead();
+extern void inputClear();
+extern void inputWaitRelease();
 
 # if defined(ENABLE_CONFIG)
 extern void configInit();
@@ -506,5 +633,20 @@ extern long configGetLong(const __FlashStringHelper* key, int onFail = 0);
 /*==== /FUNCTIONS =================================================*/
 
 #include "ClockedSerial.h"
+#include "BusAccess.h"
+#include "SerialEeprom.h"
+#include "Hash.h"
+
+# if defined(OPTION_HASH)
+// Hash contexts of one dump, see dumpHashInit()
+struct DumpHash {
+#  if defined(OPTION_HASH_SHA1)
+  Sha1Context sha1;
+#  endif
+#  if defined(OPTION_HASH_MD5)
+  Md5Context md5;
+#  endif
+};
+# endif /* OPTION_HASH */
 
 #endif /* OSCR_H_ */
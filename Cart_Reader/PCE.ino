@@ -193,6 +193,9 @@ void setup_cart_PCE(void) {
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
+  pce_force_rom_size = 0;
+  tennokoe_bank_index = 0;
+
   // Set cicrstPin(PG1) to Output
   DDRG |= (1 << 1);
   // Output a high to disable CIC
@@ -37,8 +37,9 @@ static const char sfmFlashMenuItem2[] PROGMEM = "Write Flash";
 static const char sfmFlashMenuItem3[] PROGMEM = "Print Mapping";
 static const char sfmFlashMenuItem4[] PROGMEM = "Read Mapping";
 static const char sfmFlashMenuItem5[] PROGMEM = "Write Mapping";
-static const char sfmFlashMenuItem6[] PROGMEM = "Back";
-static const char* const menuOptionsSFMFlash[] PROGMEM = { sfmFlashMenuItem1, sfmFlashMenuItem2, sfmFlashMenuItem3, sfmFlashMenuItem4, sfmFlashMenuItem5, sfmFlashMenuItem6 };
+static const char sfmFlashMenuItem6[] PROGMEM = "Update Flash";
+static const char sfmFlashMenuItem7[] PROGMEM = "Back";
+static const char* const menuOptionsSFMFlash[] PROGMEM = { sfmFlashMenuItem1, sfmFlashMenuItem2, sfmFlashMenuItem3, sfmFlashMenuItem4, sfmFlashMenuItem5, sfmFlashMenuItem6, sfmFlashMenuItem7 };
 
 // SFM game menu items
 static const char sfmGameMenuItem2[] PROGMEM = "Read Game";
@@ -169,9 +170,8 @@ void sfmGameOptions() {
       display_Clear();
       // Change working dir to root
       sd.chdir("/");
-      writeSRAM(1);
       unsigned long wrErrors;
-      wrErrors = verifySRAM();
+      wrErrors = writeSRAM(1);
       if (wrErrors == 0) {
         println_Msg(F("Verified OK"));
         display_Update();
@@ -204,11 +204,11 @@ void sfmGameOptions() {
 
 #ifdef ENABLE_FLASH
 void sfmFlashMenu() {
-  // create menu with title and 6 options to choose from
+  // create menu with title and 7 options to choose from
   unsigned char flashSubMenu;
   // Copy menuOptions out of progmem
-  convertPgm(menuOptionsSFMFlash, 6);
-  flashSubMenu = question_box(F("SFM Flash Menu"), menuOptions, 6, 0);
+  convertPgm(menuOptionsSFMFlash, 7);
+  flashSubMenu = question_box(F("SFM Flash Menu"), menuOptions, 7, 0);
 
   // wait for user choice to come back from the question box menu
   switch (flashSubMenu) {
@@ -419,12 +419,50 @@ void sfmFlashMenu() {
       writeMapping_SFM(0xE0, 256);
       break;
 
-    // Go back
+    // Update flash, only rewrites the sectors and the mapping that changed
     case 5:
+      // Clear screen
+      display_Clear();
+
+      filePath[0] = '\0';
+      sd.chdir("/");
+      // Launch file browser
+      fileBrowser(F("Select 4MB file"));
+      display_Clear();
+      sprintf(filePath, "%s/%s", filePath, fileName);
+
+      // Checked before anything is erased, the sectors are read from the file at fixed offsets
+      if (!myFile.open(filePath, O_READ))
+        print_FatalError(open_file_STR);
+      fileSize = myFile.fileSize();
+      myFile.close();
+      if (fileSize != 4194304) {
+        print_Error(F("File must be 4MB"));
+        break;
+      }
+
+      flashSize = 2097152;
+      numBanks = 32;
+      // Update both flashroms
+      update_SFM(0xC0, 0);
+      update_SFM(0xE0, 2097152);
+
+      // Clear filepath
+      filePath[0] = '\0';
+      sd.chdir("/");
+      // Launch file browser
+      fileBrowser(F("Select MAP file"));
+      display_Clear();
+      sprintf(filePath, "%s/%s", filePath, fileName);
+      updateMapping_SFM();
+      break;
+
+    // Go back
+    case 6:
       mode = CORE_SFM;
       break;
   }
-  if (flashSubMenu != 5) {
+  if (flashSubMenu != 6) {
     println_Msg(FS(FSTRING_EMPTY));
     // Prints string out of the common strings array either with or without newline
     print_STR(press_button_STR, 1);
@@ -1760,6 +1798,231 @@ void write_SFM(int startBank, uint32_t pos) {
   }
 }
 
+/******************************************
+  Differential update
+*****************************************/
+// The MX29F1601 erases in 128KB sectors, that is two HiRom banks
+#define SFM_SECTOR_BANKS 2
+
+// Program one 128 byte page out of sdBuffer
+void writePage_SFM(byte startBank, byte currBank, word currByte) {
+  // Configure control pins
+  controlOut_SFM();
+  // Set data pins to output
+  dataOut();
+
+  // Write command sequence
+  writeBank_SFM(startBank, 0x5555L * 2, 0xaa);
+  writeBank_SFM(startBank, 0x2AAAL * 2, 0x55);
+  writeBank_SFM(startBank, 0x5555L * 2, 0xa0);
+
+  for (byte c = 0; c < 128; c++) {
+    // Write one byte of data
+    writeBank_SFM(currBank, currByte + c, sdBuffer[c]);
+  }
+  // Write the last byte twice or else it won't write at all
+  writeBank_SFM(currBank, currByte + 127, sdBuffer[127]);
+
+  // Wait until write is finished
+  busyCheck_SFM(startBank);
+  resetFlash_SFM(startBank);
+}
+
+// Erase a single sector to 0xFF, sectorBank is the first HiRom bank of the sector
+void eraseSector_SFM(byte startBank, byte sectorBank) {
+  // Configure control pins
+  controlOut_SFM();
+  // Set data pins to output
+  dataOut();
+
+  // Sector erase command sequence
+  writeBank_SFM(startBank, 0x5555L * 2, 0xaa);
+  writeBank_SFM(startBank, 0x2AAAL * 2, 0x55);
+  writeBank_SFM(startBank, 0x5555L * 2, 0x80);
+  writeBank_SFM(startBank, 0x5555L * 2, 0xaa);
+  writeBank_SFM(startBank, 0x2AAAL * 2, 0x55);
+  writeBank_SFM(sectorBank, 0x0000, 0x30);
+
+  // Wait for erase to complete
+  busyCheck_SFM(startBank);
+  resetFlash_SFM(startBank);
+}
+
+// Compare a sector with the open file, returns 0 if it matches, 1 if the file can be programmed over it and 2 if it needs an erase first
+byte compareSector_SFM(byte sectorBank) {
+  byte result = 0;
+
+  // Set data pins to input
+  dataIn();
+  // Set control pins to input
+  controlIn_SFM();
+
+  for (word currBank = sectorBank; currBank < sectorBank + SFM_SECTOR_BANKS; currBank++) {
+    for (unsigned long currByte = 0; currByte < 0x10000; currByte += 512) {
+      myFile.read(sdBuffer, 512);
+      for (int c = 0; c < 512; c++) {
+        byte flashByte = readBank_SFM(currBank, currByte + c);
+        if (flashByte != sdBuffer[c]) {
+          // Programming can only clear bits
+          if ((flashByte & sdBuffer[c]) != sdBuffer[c])
+            return 2;
+          result = 1;
+        }
+      }
+    }
+  }
+  return result;
+}
+
+// Program the pages of a sector that differ from the open file, after an erase this skips the blank pages
+void programSector_SFM(byte startBank, byte sectorBank) {
+  for (word currBank = sectorBank; currBank < sectorBank + SFM_SECTOR_BANKS; currBank++) {
+    for (unsigned long currByte = 0; currByte < 0x10000; currByte += 128) {
+      myFile.read(sdBuffer, 128);
+
+      // Set data pins to input
+      dataIn();
+      // Set control pins to input
+      controlIn_SFM();
+
+      for (byte c = 0; c < 128; c++) {
+        if (readBank_SFM(currBank, currByte + c) != sdBuffer[c]) {
+          writePage_SFM(startBank, currBank, currByte);
+          break;
+        }
+      }
+    }
+  }
+}
+
+// Bring one flashrom up to date with a 4MB file, only the sectors that changed get erased and programmed
+void update_SFM(int startBank, uint32_t pos) {
+  display_Clear();
+
+  // Switch NP cart's mapping
+  if (!unlockHirom())
+    print_FatalError(F("Unlock failed"));
+
+  // Get ID
+  idFlash_SFM(startBank);
+  if (flashid != 0xc2f3)
+    print_FatalError(F("Error: Wrong Flash ID"));
+  resetFlash_SFM(startBank);
+
+  if (!myFile.open(filePath, O_READ))
+    print_FatalError(open_file_STR);
+
+  print_Msg(F("Updating Bank 0x"));
+  println_Msg(startBank, HEX);
+  display_Update();
+
+  byte changed = 0;
+  byte erased = 0;
+  draw_progressbar(0, numBanks);
+  for (word sectorBank = startBank; sectorBank < startBank + numBanks; sectorBank += SFM_SECTOR_BANKS) {
+    uint32_t sectorPos = pos + ((uint32_t)(sectorBank - startBank) << 16);
+
+    myFile.seekSet(sectorPos);
+    byte state = compareSector_SFM(sectorBank);
+    if (state != 0) {
+      if (state == 2) {
+        eraseSector_SFM(startBank, sectorBank);
+        erased++;
+      }
+      myFile.seekSet(sectorPos);
+      programSector_SFM(startBank, sectorBank);
+
+      // Check the sector
+      myFile.seekSet(sectorPos);
+      if (compareSector_SFM(sectorBank) != 0) {
+        myFile.close();
+        print_FatalError(did_not_verify_STR);
+      }
+      changed++;
+    }
+    draw_progressbar(sectorBank - startBank + SFM_SECTOR_BANKS, numBanks);
+  }
+  myFile.close();
+
+  print_Msg(changed, DEC);
+  print_Msg(F(" written, "));
+  print_Msg(erased, DEC);
+  println_Msg(F(" erased"));
+  display_Update();
+}
+
+// Compare the mapping of one flashrom with 256 bytes of the MAP file, returns 1 if they match
+boolean compareMapping_SFM(byte startBank, uint32_t pos) {
+  boolean same = 1;
+
+  if (!myFile.open(filePath, O_READ))
+    print_FatalError(open_file_STR);
+  myFile.seekSet(pos);
+  myFile.read(sdBuffer, 256);
+  myFile.close();
+
+  // Switch to write
+  dataOut();
+  controlOut_SFM();
+
+  // Reset to defaults
+  writeBank_SFM(startBank, 0x0000, 0x38);
+  writeBank_SFM(startBank, 0x0000, 0xd0);
+  // Read Extended Status Register (GSR and PSR)
+  writeBank_SFM(startBank, 0x0000, 0x71);
+  // Page Buffer Swap
+  writeBank_SFM(startBank, 0x0000, 0x72);
+  // Read Page Buffer
+  writeBank_SFM(startBank, 0x0000, 0x75);
+
+  // Switch to read
+  dataIn();
+  controlIn_SFM();
+
+  for (word c = 0; c < 256; c++) {
+    if (readBank_SFM(startBank, 0xFF00 + c) != sdBuffer[c]) {
+      same = 0;
+      break;
+    }
+  }
+
+  // Reset Flash
+  resetFlash_SFM(startBank);
+
+  // Switch to read
+  dataIn();
+  controlIn_SFM();
+
+  return same;
+}
+
+// Rewrite the mapping only if the MAP file differs from it
+void updateMapping_SFM() {
+  print_Msg(F("Mapping..."));
+  display_Update();
+  if (compareMapping_SFM(0xC0, 0) && compareMapping_SFM(0xE0, 256)) {
+    println_Msg(F("unchanged"));
+    display_Update();
+    return;
+  }
+  println_Msg(F("changed"));
+  display_Update();
+
+  // Erase mapping
+  eraseMapping(0xD0);
+  eraseMapping(0xE0);
+  print_Msg(F("Blankcheck..."));
+  display_Update();
+  if (!blankcheckMapping_SFM())
+    print_FatalError(F("Could not erase mapping"));
+  println_Msg(FS(FSTRING_OK));
+  display_Update();
+
+  // Write mapping
+  writeMapping_SFM(0xD0, 0);
+  writeMapping_SFM(0xE0, 256);
+}
+
 #endif
 
 //******************************************
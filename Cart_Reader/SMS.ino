@@ -166,6 +166,9 @@ void operationsMenu() {
 //   Setup I/O
 //********************************
 void setup_SMS() {
+  // A manual size from before a warm restart doesn't apply to this cart
+  manRomSizeSelected = false;
+
   // Request 5V
   setVoltage(VOLTS_SET_5V);
 
@@ -427,6 +427,9 @@ void snesMenu() {
         // Change working dir to root
         sd.chdir("/");
         readSRAM();
+#ifdef OPTION_DEDUPE_STORE
+        dedupeSave();
+#endif
       } else {
         display_Clear();
         print_Error(F("Does not have SRAM"));
@@ -438,9 +441,8 @@ void snesMenu() {
         display_Clear();
         // Change working dir to root
         sd.chdir("/");
-        writeSRAM(1);
         unsigned long wrErrors;
-        wrErrors = verifySRAM();
+        wrErrors = writeSRAM(1);
         if (wrErrors == 0) {
           println_Msg(F("Verified OK"));
           display_Update();
@@ -474,8 +476,7 @@ void snesMenu() {
         readSRAM();
         eraseSRAM(0x0F);
         eraseSRAM(0xF0);
-        writeSRAM(0);
-        unsigned long wrErrors = verifySRAM();
+        unsigned long wrErrors = writeSRAM(0);
         if (wrErrors == 0) {
           println_Msg(F("Restored OK"));
           display_Update();
@@ -794,8 +795,8 @@ byte readBank_SNES(byte myBank, word myAddress) {
   return tempByte;
 }
 
-void readLoRomBanks(unsigned int start, unsigned int total, FsFile* file) {
-  byte buffer[1024] = { 0 };
+void readLoRomBanks(unsigned int start, unsigned int total, DumpFile* file) {
+  ScratchBuffer buffer(1024);
 
   uint16_t c = 0;
   uint16_t currByte = 32768;
@@ -845,8 +846,8 @@ void readLoRomBanks(unsigned int start, unsigned int total, FsFile* file) {
   }
 }
 
-void readHiRomBanks(unsigned int start, unsigned int total, FsFile* file) {
-  byte buffer[1024] = { 0 };
+void readHiRomBanks(unsigned int start, unsigned int total, DumpFile* file) {
+  ScratchBuffer buffer(1024);
 
   uint16_t c = 0;
   uint16_t currByte = 0;
@@ -1444,6 +1445,9 @@ unsigned int calc_checksum(char* fileName, char* folder) {
 }
 
 boolean compare_checksum() {
+  if (!dumpSaved())
+    return 0;
+
   print_Msg(F("Checksum... "));
   display_Update();
 
@@ -1642,8 +1646,65 @@ void readROM_SNES() {
 /******************************************
   SNES SRAM Functions
 *****************************************/
-// Write file to SRAM
-void writeSRAM(boolean browseFile) {
+// HiRom and ExHiRom SRAM needs CS(PH3) to be high, SPC7110 SRAM does not
+boolean sramCsHigh_SNES() {
+  return (romType == EX) || ((romType == HI) && (romChips != 245) && (romChips != 249));
+}
+
+// Translate an offset into the save file to SRAM bank and address
+void sramAddress_SNES(uint32_t offset, byte* bank, word* address) {
+  if (romType == EX) {
+    *bank = 0xB0 + (offset / 0x2000);
+    *address = 0x6000 + (offset % 0x2000);
+  } else if (romType == HI) {
+    if ((romChips == 245) || (romChips == 249)) {  // SPC7110 SRAM
+      *bank = 0x30;
+      *address = 0x6000 + offset;
+    } else {
+      *bank = 0x30 + (offset / 0x2000);
+      *address = 0x6000 + (offset % 0x2000);
+    }
+  } else if ((romChips == 19) || (romChips == 20) || (romChips == 21) || (romChips == 26)) {  // SuperFX
+    *bank = 0x70 + (offset / 0x10000);
+    *address = offset % 0x10000;
+  } else {  // LoRom
+    *bank = 0x70 + (offset / 0x8000);
+    *address = offset % 0x8000;
+  }
+}
+
+void writeSramBlock_SNES(uint32_t offset, const byte* data, uint16_t length) {
+  byte bank;
+  word address;
+  sramAddress_SNES(offset, &bank, &address);
+
+  dataOut();
+  controlOut_SNES();
+  if (sramCsHigh_SNES())
+    PORTH |= (1 << 3);
+
+  for (uint16_t c = 0; c < length; c++) {
+    writeBank_SNES(bank, address + c, data[c]);
+  }
+}
+
+void readSramBlock_SNES(uint32_t offset, byte* data, uint16_t length) {
+  byte bank;
+  word address;
+  sramAddress_SNES(offset, &bank, &address);
+
+  dataIn();
+  controlIn_SNES();
+  if (sramCsHigh_SNES())
+    PORTH |= (1 << 3);
+
+  for (uint16_t c = 0; c < length; c++) {
+    data[c] = readBank_SNES(bank, address + c);
+  }
+}
+
+// Write file to SRAM and verify it on the fly, returns the number of bytes that did not verify
+unsigned long writeSRAM(boolean browseFile) {
   if (browseFile) {
     filePath[0] = '\0';
     sd.chdir("/");
@@ -1663,99 +1724,8 @@ void writeSRAM(boolean browseFile) {
     // Set RST RD WR to High and CS to Low
     controlOut_SNES();
 
-    int sramBanks = 0;
-    // LoRom
-    if (romType == LO) {
-      // Sram size
-      long lastByte = (long(sramSize) * 128);
-
-      if ((romChips == 19) || (romChips == 20) || (romChips == 21) || (romChips == 26)) {  // SuperFX
-        if (lastByte > 0x10000) {                                                          // Large SuperFX SRAM (no known carts)
-          sramBanks = lastByte / 0x10000;
-          for (int currBank = 0x70; currBank < sramBanks + 0x70; currBank++) {
-            for (long currByte = 0x0000; currByte < 0x10000; currByte++) {
-              writeBank_SNES(currBank, currByte, myFile.read());
-            }
-          }
-        } else {  // SuperFX SRAM
-          for (long currByte = 0; currByte < lastByte; currByte++) {
-            writeBank_SNES(0x70, currByte, myFile.read());
-          }
-        }
-      } else if (lastByte > 0x8000) {  // Large SRAM Fix
-        sramBanks = lastByte / 0x8000;
-        for (int currBank = 0x70; currBank < sramBanks + 0x70; currBank++) {
-          for (long currByte = 0x0000; currByte < 0x8000; currByte++) {
-            writeBank_SNES(currBank, currByte, myFile.read());
-          }
-        }
-      } else {
-        for (long currByte = 0; currByte < lastByte; currByte++) {
-          writeBank_SNES(0x70, currByte, myFile.read());
-        }
-      }
-    }
-    // HiRom
-    else if (romType == HI) {
-      if ((romChips == 245) || (romChips == 249)) {  // SPC7110 SRAM
-        // Configure SPC7110 SRAM Register
-        // Set 0x4830 to 0x80
-        writeBank_SNES(0, 0x4830, 0x80);
-        // Sram size
-        long lastByte = (long(sramSize) * 128) + 0x6000;
-        // Write to sram bank
-        for (long currByte = 0x6000; currByte < lastByte; currByte++) {
-          writeBank_SNES(0x30, currByte, myFile.read());
-        }
-        // Reset SPC7110 SRAM Register
-        dataOut();
-        // Reset 0x4830 to 0x0
-        writeBank_SNES(0, 0x4830, 0);
-        dataIn();
-      } else {
-        // Writing SRAM on HiRom needs CS(PH3) to be high
-        PORTH |= (1 << 3);
-        // Sram size
-        long lastByte = (long(sramSize) * 128);
-        if (lastByte > 0x2000) {  // Large SRAM Fix
-          sramBanks = lastByte / 0x2000;
-          for (int currBank = 0x30; currBank < sramBanks + 0x30; currBank++) {
-            for (long currByte = 0x6000; currByte < 0x8000; currByte++) {
-              writeBank_SNES(currBank, currByte, myFile.read());
-            }
-          }
-        } else {
-          lastByte += 0x6000;
-          // Write to sram bank
-          for (long currByte = 0x6000; currByte < lastByte; currByte++) {
-            writeBank_SNES(0x30, currByte, myFile.read());
-          }
-        }
-      }
-    }
-    // ExHiRom
-    else if (romType == EX) {
-      // Writing SRAM on HiRom needs CS(PH3) to be high
-      PORTH |= (1 << 3);
-      // Sram size
-      long lastByte = (long(sramSize) * 128);
-      if (lastByte > 0x2000) {  // Large EX SRAM Fix
-        sramBanks = lastByte / 0x2000;
-        for (int currBank = 0xB0; currBank < sramBanks + 0xB0; currBank++) {
-          for (long currByte = 0x6000; currByte < 0x8000; currByte++) {
-            writeBank_SNES(currBank, currByte, myFile.read());
-          }
-        }
-      } else {
-        lastByte += 0x6000;
-        // Write to sram bank
-        for (long currByte = 0x6000; currByte < lastByte; currByte++) {
-          writeBank_SNES(0xB0, currByte, myFile.read());
-        }
-      }
-    }
-    // SA1
-    else if (romType == SA) {
+    // SA1 BW-RAM is verified in a second pass by verifySRAM()
+    if (romType == SA) {
       long lastByte = (long(sramSize) * 128);
       if (i2c_found) {
         // Enable CPU Clock
@@ -1805,6 +1775,32 @@ void writeSRAM(boolean browseFile) {
         // Disable CPU clock
         clockgen.output_enable(SI5351_CLK1, 0);
       }
+
+      // Set pins to input
+      dataIn();
+
+      // Close the file:
+      myFile.close();
+      println_Msg(F("SRAM writing finished"));
+      display_Update();
+      return verifySRAM();
+    }
+
+    boolean spc7110 = (romType == HI) && ((romChips == 245) || (romChips == 249));
+    if (spc7110) {
+      // Configure SPC7110 SRAM Register
+      // Set 0x4830 to 0x80
+      writeBank_SNES(0, 0x4830, 0x80);
+    }
+
+    writeErrors = writeVerifySave(long(sramSize) * 128, writeSramBlock_SNES, readSramBlock_SNES);
+
+    if (spc7110) {
+      // Reset SPC7110 SRAM Register
+      dataOut();
+      controlOut_SNES();
+      // Reset 0x4830 to 0x0
+      writeBank_SNES(0, 0x4830, 0);
     }
 
     // Set pins to input
@@ -1814,9 +1810,10 @@ void writeSRAM(boolean browseFile) {
     myFile.close();
     println_Msg(F("SRAM writing finished"));
     display_Update();
-
+    return writeErrors;
   } else {
     print_Error(FS(FSTRING_FILE_DOESNT_EXIST));
+    return 1;
   }
 }
 
@@ -1947,7 +1944,7 @@ void readSRAM() {
   display_Update();
 }
 
-// Check if the SRAM was written without any error
+// Verify SA1 BW-RAM, all other carts are verified by writeSRAM() while writing
 unsigned long verifySRAM() {
   //open file on sd card
   if (myFile.open(filePath, O_READ)) {
@@ -1958,199 +1955,58 @@ unsigned long verifySRAM() {
     // Set control
     controlIn_SNES();
 
-    int sramBanks = 0;
-    if (romType == LO) {
-      // Sram size
-      long lastByte = (long(sramSize) * 128);
-      if ((romChips == 19) || (romChips == 20) || (romChips == 21) || (romChips == 26)) {  // SuperFX
-        if (lastByte > 0x10000) {                                                          // Large SuperFX SRAM (no known carts)
-          sramBanks = lastByte / 0x10000;
-          for (int currBank = 0x70; currBank < sramBanks + 0x70; currBank++) {
-            for (long currByte = 0; currByte < 0x10000; currByte += 512) {
-              //fill sdBuffer
-              myFile.read(sdBuffer, 512);
-              for (int c = 0; c < 512; c++) {
-                if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
-                  writeErrors++;
-                }
-              }
-            }
-          }
-        } else {  // SuperFX SRAM
-          for (long currByte = 0; currByte < lastByte; currByte += 512) {
-            //fill sdBuffer
-            myFile.read(sdBuffer, 512);
-            for (int c = 0; c < 512; c++) {
-              if ((readBank_SNES(0x70, currByte + c)) != sdBuffer[c]) {
-                writeErrors++;
-              }
-            }
-          }
-        }
-      } else if (lastByte > 0x8000) {  // Large SRAM Fix
-        sramBanks = lastByte / 0x8000;
-        for (int currBank = 0x70; currBank < sramBanks + 0x70; currBank++) {
-          for (long currByte = 0; currByte < 0x8000; currByte += 512) {
-            //fill sdBuffer
-            myFile.read(sdBuffer, 512);
-            for (int c = 0; c < 512; c++) {
-              if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
-                writeErrors++;
-              }
-            }
-          }
-        }
-      } else {
-        for (long currByte = 0; currByte < lastByte; currByte += 512) {
-          //fill sdBuffer
-          myFile.read(sdBuffer, 512);
-          for (int c = 0; c < 512; c++) {
-            if ((readBank_SNES(0x70, currByte + c)) != sdBuffer[c]) {
-              writeErrors++;
-            }
-          }
-        }
-      }
-    } else if (romType == HI) {
-      if ((romChips == 245) || (romChips == 249)) {  // SPC7110 SRAM
-        // Configure SPC7110 SRAM Register
-        dataOut();
-        // Set 0x4830 to 0x80
-        writeBank_SNES(0, 0x4830, 0x80);
-        dataIn();
-        // Sram size
-        long lastByte = (long(sramSize) * 128) + 0x6000;
-        for (long currByte = 0x6000; currByte < lastByte; currByte += 512) {
-          //fill sdBuffer
-          myFile.read(sdBuffer, 512);
-          for (int c = 0; c < 512; c++) {
-            if ((readBank_SNES(0x30, currByte + c)) != sdBuffer[c]) {
-              writeErrors++;
-            }
-          }
-        }
-        dataOut();
-        // Reset 0x4830 to 0x0
-        writeBank_SNES(0, 0x4830, 0);
-        dataIn();
-      } else {
-        // Dumping SRAM on HiRom needs CS(PH3) to be high
-        PORTH |= (1 << 3);
-        // Sram size
-        long lastByte = (long(sramSize) * 128);
-        if (lastByte > 0x2000) {  // Large SRAM Fix
-          sramBanks = lastByte / 0x2000;
-          for (int currBank = 0x30; currBank < sramBanks + 0x30; currBank++) {
-            for (long currByte = 0x6000; currByte < 0x8000; currByte += 512) {
-              //fill sdBuffer
-              myFile.read(sdBuffer, 512);
-              for (int c = 0; c < 512; c++) {
-                if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
-                  writeErrors++;
-                }
-              }
-            }
-          }
-        } else {
-          lastByte += 0x6000;
-          for (long currByte = 0x6000; currByte < lastByte; currByte += 512) {
-            //fill sdBuffer
-            myFile.read(sdBuffer, 512);
-            for (int c = 0; c < 512; c++) {
-              if ((readBank_SNES(0x30, currByte + c)) != sdBuffer[c]) {
-                writeErrors++;
-              }
-            }
-          }
-        }
-      }
-    } else if (romType == EX) {
-      // Dumping SRAM on HiRom needs CS(PH3) to be high
-      PORTH |= (1 << 3);
-      // Sram size
-      long lastByte = (long(sramSize) * 128);
-      if (lastByte > 0x2000) {  // Large EX SRAM Fix
-        sramBanks = lastByte / 0x2000;
-        for (int currBank = 0xB0; currBank < sramBanks + 0xB0; currBank++) {
-          for (long currByte = 0x6000; currByte < 0x8000; currByte += 512) {
-            //fill sdBuffer
-            myFile.read(sdBuffer, 512);
-            for (int c = 0; c < 512; c++) {
-              if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
-                writeErrors++;
-              }
-            }
-          }
-        }
-      } else {
-        lastByte += 0x6000;
-        for (long currByte = 0x6000; currByte < lastByte; currByte += 512) {
+    // Dumping SRAM on HiRom needs CS(PH3) to be high
+    PORTH |= (1 << 3);
+    // Sram size
+    long lastByte = (long(sramSize) * 128);
+
+    if (lastByte > 0x10000) {
+      int sramBanks = lastByte / 0x10000;
+      for (int currBank = 0x40; currBank < sramBanks + 0x40; currBank++) {
+        for (long currByte = 0x0; currByte < 0x10000; currByte += 512) {
           //fill sdBuffer
           myFile.read(sdBuffer, 512);
           for (int c = 0; c < 512; c++) {
-            if ((readBank_SNES(0xB0, currByte + c)) != sdBuffer[c]) {
+            if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
               writeErrors++;
             }
           }
         }
       }
-    } else if (romType == SA) {
-      // Dumping SRAM on HiRom needs CS(PH3) to be high
-      PORTH |= (1 << 3);
-      // Sram size
-      long lastByte = (long(sramSize) * 128);
-
-      if (lastByte > 0x10000) {
-        sramBanks = lastByte / 0x10000;
-        for (int currBank = 0x40; currBank < sramBanks + 0x40; currBank++) {
-          for (long currByte = 0x0; currByte < 0x10000; currByte += 512) {
-            //fill sdBuffer
-            myFile.read(sdBuffer, 512);
-            for (int c = 0; c < 512; c++) {
-              if ((readBank_SNES(currBank, currByte + c)) != sdBuffer[c]) {
-                writeErrors++;
-              }
-            }
-          }
-        }
-      } else {
-        for (long currByte = 0x0; currByte < lastByte; currByte += 512) {
-          //fill sdBuffer
-          myFile.read(sdBuffer, 512);
-          for (int c = 0; c < 512; c++) {
-            if ((readBank_SNES(0x40, currByte + c)) != sdBuffer[c]) {
-              writeErrors++;
-            }
+    } else {
+      for (long currByte = 0x0; currByte < lastByte; currByte += 512) {
+        //fill sdBuffer
+        myFile.read(sdBuffer, 512);
+        for (int c = 0; c < 512; c++) {
+          if ((readBank_SNES(0x40, currByte + c)) != sdBuffer[c]) {
+            writeErrors++;
           }
         }
       }
-      // Reset SA1
-      // Set pins to input
-      dataIn();
-      // Close the file:
-      myFile.close();
-      if (writeErrors == 0) {
-        println_Msg(F("Verified OK"));
-      } else {
-        print_STR(error_STR, 0);
-        print_Msg(writeErrors);
-        print_STR(_bytes_STR, 1);
-        print_Error(did_not_verify_STR);
-      }
-      display_Update();
-      wait();
-
-      stopSnesClocks_resetCic_resetCart();
-
-      display_Clear();
-      print_Msg(F("Resetting..."));
-      display_Update();
-      delay(3000);  // wait 3 secs
-      resetArduino();
     }
+    // Reset SA1
+    // Set pins to input
+    dataIn();
     // Close the file:
     myFile.close();
-    return writeErrors;
+    if (writeErrors == 0) {
+      println_Msg(F("Verified OK"));
+    } else {
+      print_STR(error_STR, 0);
+      print_Msg(writeErrors);
+      print_STR(_bytes_STR, 1);
+      print_Error(did_not_verify_STR);
+    }
+    display_Update();
+    wait();
+
+    stopSnesClocks_resetCic_resetCart();
+
+    display_Clear();
+    print_Msg(F("Resetting..."));
+    display_Update();
+    delay(3000);  // wait 3 secs
+    resetArduino();
   } else {
     print_Error(open_file_STR);
     return 1;
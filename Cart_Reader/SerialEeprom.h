@@ -0,0 +1,453 @@
+/********************************************************************
+*                   Open Source Cartridge Reader                    *
+********************************************************************/
+#ifndef SERIALEEPROM_H_
+#define SERIALEEPROM_H_
+
+#include <Arduino.h>
+#include "BusAccess.h"
+
+/*H******************************************************************
+* FILENAME :        SerialEeprom.h
+*
+* DESCRIPTION :
+*       Bit-banged serial save EEPROMs: I2C (24Cxx, X24C01), Microwire
+*       (93Cxx) and the 1-bit protocol of the GBA EEPROMs. Each engine
+*       is a template over a struct that says how the lines are wired
+*       and how long each clock phase has to be, the same way the
+*       cartridge buses are described in BusAccess.h.
+*
+* USAGE :
+*       I2cEeprom<MdEepLines>::read(0, sdBuffer, 256, I2C_24C02);
+*       I2cEeprom<MdEepLines>::write(0, sdBuffer, 8, I2C_24C02);
+*       word data = MicrowireEeprom<JagEepPins>::read(address, 6);
+*       GbaEeprom<GbaEepPins>::readBlock(block, 6, sdBuffer);
+*
+* NOTES :
+*       Clock phases are given in ns at the fastest rate the parts are
+*       specified for and rounded up to whole CPU cycles by busNs().
+*       I2C lines that are driven through a mapper register (MD, NES)
+*       already take longer per edge than a fast mode (400kHz) part
+*       needs, their wiring structs therefore set the delays to 0.
+*
+*H*/
+
+/*==== I2C ========================================================*/
+
+// How the word address is sent, see the 24Cxx/X24C01 datasheets
+enum I2C_ADDRESSING : uint8_t {
+  I2C_X24C01,      // 7 bit address + R/W instead of a device byte, MSB first
+  I2C_X24C01_LSB,  // the same shifted out LSB first (Bandai)
+  I2C_24C02,       // device byte 1010 A10-A8 R/W + 8 bit address (24C02-24C16)
+  I2C_24C32,       // device byte 1010 000 R/W + 16 bit address (24C32-24C65)
+};
+
+// Write cycle time (tWR) is 10ms max for all of them
+#define I2C_WRITE_TIMEOUT 20
+
+/**
+ * Lines needs:
+ *   static void sda(bool high), static void scl(bool high)
+ *   static bool sample()            read SDA, called with SDA released
+ *   static constexpr uint8_t lowCycles, highCycles
+ **/
+template<class Lines>
+struct I2cEeprom {
+  static void clock() {
+    Lines::scl(1);
+    busDelay<Lines::highCycles>();
+    Lines::scl(0);
+    busDelay<Lines::lowCycles>();
+  }
+
+  static void start() {
+    Lines::sda(1);
+    Lines::scl(1);
+    busDelay<Lines::highCycles>();
+    Lines::sda(0);
+    busDelay<Lines::highCycles>();
+    Lines::scl(0);
+    busDelay<Lines::lowCycles>();
+  }
+
+  // Leaves both lines low like the old per-mapper STOP sequences did
+  static void stop() {
+    Lines::sda(0);
+    Lines::scl(1);
+    busDelay<Lines::highCycles>();
+    Lines::sda(1);
+    busDelay<Lines::lowCycles>();
+    Lines::scl(0);
+    Lines::sda(0);
+  }
+
+  static void sendBits(uint8_t value, uint8_t count, bool lsbFirst) {
+    uint8_t mask = lsbFirst ? 0x01 : (1 << (count - 1));
+    for (uint8_t i = 0; i < count; i++) {
+      Lines::sda(value & mask);
+      if (lsbFirst)
+        value >>= 1;
+      else
+        value <<= 1;
+      clock();
+    }
+  }
+
+  // Slave acknowledge, true if SDA was pulled low
+  static bool ack() {
+    Lines::sda(1);
+    Lines::scl(1);
+    busDelay<Lines::highCycles>();
+    bool acknowledged = !Lines::sample();
+    Lines::scl(0);
+    busDelay<Lines::lowCycles>();
+    return acknowledged;
+  }
+
+  static uint8_t receive(bool lsbFirst) {
+    uint8_t value = 0;
+    Lines::sda(1);
+    for (uint8_t i = 0; i < 8; i++) {
+      Lines::scl(1);
+      busDelay<Lines::highCycles>();
+      if (lsbFirst)
+        value = (value >> 1) | (Lines::sample() ? 0x80 : 0);
+      else
+        value = (value << 1) | Lines::sample();
+      Lines::scl(0);
+      busDelay<Lines::lowCycles>();
+    }
+    return value;
+  }
+
+  // START and the device/address byte, true if the chip answered
+  static bool select(uint16_t address, I2C_ADDRESSING mode, bool read) {
+    start();
+    if (mode == I2C_X24C01 || mode == I2C_X24C01_LSB) {
+      sendBits(address & 0x7F, 7, mode == I2C_X24C01_LSB);
+      sendBits(read, 1, false);
+    } else if (mode == I2C_24C02) {
+      sendBits(0xA0 | ((address >> 7) & 0x0E) | read, 8, false);
+    } else {
+      sendBits(0xA0 | read, 8, false);
+    }
+    return ack();
+  }
+
+  // Word address for the 24Cxx, the X24C01 already got it in select()
+  static void setAddress(uint16_t address, I2C_ADDRESSING mode) {
+    if (mode == I2C_24C32) {
+      sendBits(address >> 8, 8, false);
+      ack();
+    }
+    if (mode == I2C_24C02 || mode == I2C_24C32) {
+      sendBits(address & 0xFF, 8, false);
+      ack();
+    }
+  }
+
+  // Sequential read, one address phase for the whole length
+  static void read(uint16_t address, uint8_t* output, uint16_t length, I2C_ADDRESSING mode) {
+    bool lsbFirst = (mode == I2C_X24C01_LSB);
+
+    if (mode == I2C_24C02 || mode == I2C_24C32) {
+      // Dummy write to load the address, then a repeated START
+      select(address, mode, 0);
+      setAddress(address, mode);
+    }
+    select(address, mode, 1);
+    for (uint16_t i = 0; i < length; i++) {
+      output[i] = receive(lsbFirst);
+      // Master ACK for all but the last byte
+      Lines::sda(i + 1 == length);
+      clock();
+    }
+    stop();
+  }
+
+  // Page write, must not cross a page boundary, returns once the write cycle is done
+  static bool write(uint16_t address, const uint8_t* input, uint8_t length, I2C_ADDRESSING mode) {
+    bool lsbFirst = (mode == I2C_X24C01_LSB);
+
+    select(address, mode, 0);
+    setAddress(address, mode);
+    for (uint8_t i = 0; i < length; i++) {
+      sendBits(input[i], 8, lsbFirst);
+      ack();
+    }
+    stop();
+    return waitReady(address, mode);
+  }
+
+  // Acknowledge polling, the chip ignores its address until the write cycle is over
+  static bool waitReady(uint16_t address, I2C_ADDRESSING mode) {
+    unsigned long startTime = millis();
+    do {
+      bool ready = select(address, mode, 0);
+      stop();
+      if (ready)
+        return true;
+    } while (millis() - startTime < I2C_WRITE_TIMEOUT);
+    return false;
+  }
+
+  // Smallest page of the vendors found in carts, a bigger one would wrap around
+  static uint8_t pageSize(uint16_t size, I2C_ADDRESSING mode) {
+    if (mode == I2C_24C32)
+      return 32;  // 24C32/24C64, the 24C65 has 64 byte pages
+    if (size > 0x100)
+      return 16;  // 24C04-24C16
+    return 4;     // X24C01, Xicor/ST 24C02 (Atmel has 8)
+  }
+};
+
+/*==== MICROWIRE ==================================================*/
+
+// Start bit + opcode
+#define MICROWIRE_READ 0x6
+#define MICROWIRE_WRITE 0x5
+#define MICROWIRE_EXTENDED 0x4  // EWEN/EWDS/ERAL/WRAL, selected by the two top address bits
+
+// Write/erase cycle time (tWC/tEC) is 10ms max, ERAL up to 15ms
+#define MICROWIRE_WRITE_TIMEOUT 30
+
+/**
+ * Pins needs:
+ *   Select (CS, active high), Clock (SK), DataIn (DI), DataOut (DO)
+ *   static constexpr uint8_t setupCycles (tDIS), highCycles (tSKH, >= tPD),
+ *   lowCycles (tSKL), deselectCycles (tCS), accessCycles (READ address to data)
+ * 16 bit organisation (ORG tied high).
+ **/
+template<class Pins>
+struct MicrowireEeprom {
+  static void setup() {
+    Pins::DataIn::output();
+    Pins::DataOut::input();
+    Pins::Select::low();
+    Pins::Clock::low();
+    Pins::DataIn::low();
+  }
+
+  static void sendBits(uint16_t value, uint8_t count) {
+    for (uint16_t mask = 1 << (count - 1); mask; mask >>= 1) {
+      if (value & mask)
+        Pins::DataIn::high();
+      else
+        Pins::DataIn::low();
+      busDelay<Pins::setupCycles>();
+      Pins::Clock::high();
+      busDelay<Pins::highCycles>();
+      Pins::Clock::low();
+      busDelay<Pins::lowCycles>();
+    }
+    Pins::DataIn::low();
+  }
+
+  static uint16_t receiveWord() {
+    uint16_t value = 0;
+    for (uint8_t i = 0; i < 16; i++) {
+      Pins::Clock::high();
+      busDelay<Pins::highCycles>();
+      value = (value << 1) | Pins::DataOut::read();
+      Pins::Clock::low();
+      busDelay<Pins::lowCycles>();
+    }
+    return value;
+  }
+
+  static void command(uint8_t opcode, uint16_t address, uint8_t addressBits) {
+    Pins::Select::high();
+    sendBits(opcode, 3);
+    sendBits(address, addressBits);
+  }
+
+  static void deselect() {
+    Pins::Select::low();
+    busDelay<Pins::deselectCycles>();
+  }
+
+  // DO goes high once the write cycle is over
+  static bool waitReady() {
+    unsigned long startTime = millis();
+    bool ready;
+    Pins::Select::high();
+    do {
+      ready = Pins::DataOut::read();
+    } while (!ready && (millis() - startTime < MICROWIRE_WRITE_TIMEOUT));
+    deselect();
+    return ready;
+  }
+
+  static uint16_t read(uint16_t address, uint8_t addressBits) {
+    command(MICROWIRE_READ, address, addressBits);
+    busDelay<Pins::accessCycles>();
+    // Dummy 0 was clocked out with the last address bit
+    uint16_t value = receiveWord();
+    deselect();
+    return value;
+  }
+
+  static bool write(uint16_t address, uint8_t addressBits, uint16_t value) {
+    command(MICROWIRE_WRITE, address, addressBits);
+    sendBits(value, 16);
+    deselect();
+    return waitReady();
+  }
+
+  // EWEN = 11xxxx, EWDS = 00xxxx
+  static void writeEnable(uint8_t addressBits, bool enable) {
+    command(MICROWIRE_EXTENDED, enable ? (3 << (addressBits - 2)) : 0, addressBits);
+    deselect();
+  }
+
+  // ERAL = 10xxxx, leaves every word at 0xFFFF
+  static bool eraseAll(uint8_t addressBits) {
+    command(MICROWIRE_EXTENDED, 2 << (addressBits - 2), addressBits);
+    deselect();
+    return waitReady();
+  }
+};
+
+/*==== GBA EEPROM =================================================*/
+
+// The write cycle takes up to 10ms. Interrupts are off while a block is
+// written, so millis() can't time it: every poll waits at least 1us.
+#define GBA_EEPROM_WRITE_POLLS 20000
+
+/**
+ * Pins needs:
+ *   Data (A0, bidirectional), Write (/WR clocks bits in), Read (/RD clocks
+ *   bits out), Select (/CS), Enable (A23 high selects the EEPROM on 32MB carts)
+ *   static constexpr uint8_t strobeCycles, turnaroundCycles
+ * 512 byte parts use 6 address bits, 8KB parts 14. One block is 8 bytes.
+ **/
+template<class Pins>
+struct GbaEeprom {
+  static void setup() {
+    Pins::Select::output();
+    Pins::Write::output();
+    Pins::Read::output();
+    Pins::Data::output();
+    Pins::Enable::output();
+    Pins::Select::high();
+    Pins::Write::high();
+    Pins::Read::high();
+    Pins::Data::high();
+    Pins::Enable::high();
+    busDelay<busNs(125)>();
+  }
+
+  static void sendBits(uint16_t value, uint8_t count) {
+    for (uint16_t mask = 1 << (count - 1); mask; mask >>= 1) {
+      if (value & mask)
+        Pins::Data::high();
+      else
+        Pins::Data::low();
+      Pins::Write::low();
+      busDelay<Pins::strobeCycles>();
+      Pins::Write::high();
+      busDelay<Pins::strobeCycles>();
+    }
+  }
+
+  static void strobeRead() {
+    Pins::Read::low();
+    busDelay<Pins::strobeCycles>();
+    Pins::Read::high();
+    busDelay<Pins::strobeCycles>();
+  }
+
+  static void readBlock(uint16_t block, uint8_t addressBits, uint8_t* output) {
+    // Read request "11", address, stop bit
+    Pins::Select::low();
+    sendBits(0x3, 2);
+    sendBits(block, addressBits);
+    sendBits(0, 1);
+    Pins::Select::high();
+    busDelay<Pins::turnaroundCycles>();
+
+    Pins::Data::input();
+    Pins::Select::low();
+    // 4 dummy bits, then 64 data bits MSB first
+    for (uint8_t i = 0; i < 4; i++)
+      strobeRead();
+    for (uint8_t i = 0; i < 8; i++) {
+      uint8_t value = 0;
+      for (uint8_t j = 0; j < 8; j++) {
+        strobeRead();
+        value = (value << 1) | Pins::Data::read();
+      }
+      output[i] = value;
+    }
+    Pins::Select::high();
+    Pins::Data::high();
+    Pins::Data::output();
+  }
+
+  // Returns false if the write cycle did not end in time
+  static bool writeBlock(uint16_t block, uint8_t addressBits, const uint8_t* input) {
+    // Write request "10", address, 64 data bits, stop bit
+    Pins::Select::low();
+    sendBits(0x2, 2);
+    sendBits(block, addressBits);
+    busDelay<Pins::turnaroundCycles>();
+    for (uint8_t i = 0; i < 8; i++)
+      sendBits(input[i], 8);
+    sendBits(0, 1);
+    Pins::Select::high();
+
+    // Data reads 0 until the write cycle is done
+    Pins::Data::input();
+    bool ready = false;
+    for (uint16_t polls = 0; !ready && (polls < GBA_EEPROM_WRITE_POLLS); polls++) {
+      Pins::Select::low();
+      Pins::Read::low();
+      Pins::Select::high();
+      Pins::Read::high();
+      busDelay<busNs(1000)>();
+      ready = Pins::Data::read();
+    }
+    Pins::Data::output();
+    return ready;
+  }
+};
+
+/*==== SAVE CHIP WIRING ===========================================*/
+
+/**
+ * Game Boy Advance EEPROM
+ * Clocked by /WR and /RD like the GBA's DMA does it, no minimum pulse width
+ * is specified beyond the ROM access time the old loop already undercut.
+ **/
+struct GbaEepPins {
+  typedef BusPin<BusPortF, 0> Data;    // A0
+  typedef BusPin<BusPortH, 5> Write;   // /WR
+  typedef BusPin<BusPortH, 6> Read;    // /RD
+  typedef BusPin<BusPortH, 3> Select;  // /CS
+  typedef BusPin<BusPortC, 7> Enable;  // A23
+  static constexpr uint8_t strobeCycles = 0;
+  static constexpr uint8_t turnaroundCycles = busNs(500);
+};
+static_assert(busPinsDistinct<GbaEepPins::Data, GbaEepPins::Write, GbaEepPins::Read, GbaEepPins::Select, GbaEepPins::Enable>(), "GBA EEPROM pin conflict");
+
+/**
+ * Atari Jaguar 93C46-93C86
+ * 4.5-5.5V limits shared by the ISSI, Microchip and Atmel parts: tPD 250ns,
+ * tDIS 100ns, CS low 250ns. tSKH/tSKL use the 500ns of the older 1MHz parts
+ * that were also fitted to carts. The wait before the data of a READ is from
+ * the Willem programmer timing.
+ **/
+struct JagEepPins {
+  typedef BusPin<BusPortA, 7> Select;   // EEPCS
+  typedef BusPin<BusPortA, 6> Clock;    // EEPSK
+  typedef BusPin<BusPortF, 0> DataIn;   // EEPDI (D0)
+  typedef BusPin<BusPortA, 5> DataOut;  // EEPDO
+  static constexpr uint8_t setupCycles = busNs(100);
+  static constexpr uint8_t highCycles = busNs(500);
+  static constexpr uint8_t lowCycles = busNs(500);
+  static constexpr uint8_t deselectCycles = busNs(250);
+  static constexpr uint8_t accessCycles = busNs(12000);
+};
+static_assert(busPinsDistinct<JagEepPins::Select, JagEepPins::Clock, JagEepPins::DataIn, JagEepPins::DataOut>(), "Jaguar EEPROM pin conflict");
+
+#endif /* SERIALEEPROM_H_ */
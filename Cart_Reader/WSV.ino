@@ -344,38 +344,54 @@ void printDataLine_WSV(void* entry) {
   println_Msg(F("KB"));
 }
 
+// CRC32 of the first 512 bytes of the ROM, the fingerprint in field 1 of wsv.txt
+uint32_t crc512_WSV(uint32_t romStart) {
+  dataIn_WSV();
+  controlIn_WSV();
+  for (uint16_t w = 0; w < 512; w++)
+    sdBuffer[w] = readByte_WSV(romStart + w);
+  return calculateCRC(sdBuffer, 512);
+}
+
 void setCart_WSV() {
   //go to root
   sd.chdir();
 
   struct database_entry_WSV entry;
+  boolean selected;
 
-  // Select starting letter
-  byte myLetter = starting_letter();
+  // Known carts are identified by their first 512 bytes, the others are selected from the list
+  // 32K carts start at 0x8000
+  if (findFingerprint(myFile, "wsv.txt", 1, crc512_WSV(0)) || findFingerprint(myFile, "wsv.txt", 1, crc512_WSV(0x8000))) {
+    autoCartSelection(myFile, &readDataLine_WSV, &entry, &printDataLine_WSV);
+    selected = true;
+  } else {
+    // Select starting letter
+    byte myLetter = starting_letter();
 
-  // Open database
-  if (myFile.open("wsv.txt", O_READ)) {
+    // Open database
+    if (!myFile.open("wsv.txt", O_READ))
+      print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
     seek_first_letter_in_database(myFile, myLetter);
+    selected = checkCartSelection(myFile, &readDataLine_WSV, &entry, &printDataLine_WSV);
+  }
+
+  if (selected) {
+    //word WSV[] = {32,64,512};
+    switch (entry.gameSize) {
+      case 32:
+        wsvsize = 0;
+        break;
+
+      case 64:
+        wsvsize = 1;
+        break;
 
-    if (checkCartSelection(myFile, &readDataLine_WSV, &entry, &printDataLine_WSV)) {
-      //word WSV[] = {32,64,512};
-      switch (entry.gameSize) {
-        case 32:
-          wsvsize = 0;
-          break;
-
-        case 64:
-          wsvsize = 1;
-          break;
-
-        case 51:
-          wsvsize = 2;
-          break;
-      }
-      EEPROM_writeAnything(8, wsvsize);
+      case 51:
+        wsvsize = 2;
+        break;
     }
-  } else {
-    print_FatalError(FS(FSTRING_DATABASE_FILE_NOT_FOUND));
+    EEPROM_writeAnything(8, wsvsize);
   }
 }
 #endif
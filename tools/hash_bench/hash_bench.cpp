@@ -0,0 +1,151 @@
+/*
+ * hash_bench - throughput of the firmware's dump hashes on the host
+ *
+ * Builds Cart_Reader/Hash.cpp unchanged, checks it against the standard
+ * test vectors and measures CRC32, SHA-1 and MD5 over 512 byte blocks,
+ * the way compareCRC() feeds them from the SD card.
+ *
+ * Build: g++ -O2 -std=c++17 -I../../Cart_Reader -o hash_bench hash_bench.cpp ../../Cart_Reader/Hash.cpp
+ * Usage: hash_bench [megabytes]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_RDTSC 1
+#endif
+
+#include "Hash.h"
+
+static uint32_t crcTable[256];
+
+static void crcInit() {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; k++)
+      c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+    crcTable[i] = c;
+  }
+}
+
+// Same byte at a time table update as UPDATE_CRC in Cart_Reader.ino
+static uint32_t crcUpdate(uint32_t crc, const uint8_t* data, size_t length) {
+  for (size_t i = 0; i < length; i++)
+    crc = crcTable[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+  return crc;
+}
+
+static std::string hex(const uint8_t* digest, size_t size) {
+  std::string out;
+  char part[3];
+  for (size_t i = 0; i < size; i++) {
+    snprintf(part, sizeof(part), "%02x", digest[i]);
+    out += part;
+  }
+  return out;
+}
+
+static bool check(const char* name, const std::string& got, const char* expected) {
+  bool ok = (got == expected);
+  printf("  %-22s %s\n", name, ok ? "ok" : "FAILED");
+  if (!ok)
+    printf("    got      %s\n    expected %s\n", got.c_str(), expected);
+  return ok;
+}
+
+static std::string sha1Of(const std::string& text) {
+  Sha1Context context;
+  uint8_t digest[SHA1_DIGEST_SIZE];
+  sha1Init(&context);
+  // Feed in odd sized pieces to exercise the block buffer
+  for (size_t i = 0; i < text.size(); i += 7)
+    sha1Update(&context, (const uint8_t*)text.data() + i, std::min<size_t>(7, text.size() - i));
+  sha1Final(&context, digest);
+  return hex(digest, sizeof(digest));
+}
+
+static std::string md5Of(const std::string& text) {
+  Md5Context context;
+  uint8_t digest[MD5_DIGEST_SIZE];
+  md5Init(&context);
+  for (size_t i = 0; i < text.size(); i += 7)
+    md5Update(&context, (const uint8_t*)text.data() + i, std::min<size_t>(7, text.size() - i));
+  md5Final(&context, digest);
+  return hex(digest, sizeof(digest));
+}
+
+// Returns the time taken, the cost relative to the CRC32 is printed as a rough guide for the
+// ATmega, where the firmware's CRC32 speed per system is known from the dump logs
+template<typename F>
+static double bench(const char* name, const std::vector<uint8_t>& data, double crcSeconds, F&& hashBlock) {
+  auto start = std::chrono::steady_clock::now();
+#ifdef HAVE_RDTSC
+  uint64_t cycles = __rdtsc();
+#endif
+  for (size_t offset = 0; offset < data.size(); offset += 512)
+    hashBlock(data.data() + offset, 512);
+#ifdef HAVE_RDTSC
+  cycles = __rdtsc() - cycles;
+#endif
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("  %-8s %8.1f MB/s %8.2f ns/byte", name, data.size() / seconds / 1e6, seconds * 1e9 / data.size());
+#ifdef HAVE_RDTSC
+  printf(" %8.2f cycles/byte", (double)cycles / data.size());
+#endif
+  if (crcSeconds > 0)
+    printf(" %6.2fx CRC32", seconds / crcSeconds);
+  printf("\n");
+  return seconds;
+}
+
+int main(int argc, char** argv) {
+  size_t megabytes = (argc > 1) ? strtoul(argv[1], nullptr, 10) : 64;
+  bool ok = true;
+
+  crcInit();
+
+  printf("Test vectors:\n");
+  ok &= check("SHA-1 \"\"", sha1Of(""), "da39a3ee5e6b4b0d3255bfef95601890afd80709");
+  ok &= check("SHA-1 \"abc\"", sha1Of("abc"), "a9993e364706816aba3e25717850c26c9cd0d89d");
+  ok &= check("SHA-1 448 bit", sha1Of("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"), "84983e441c3bd26ebaae4aa1f95129e5e54670f1");
+  ok &= check("SHA-1 1M x \"a\"", sha1Of(std::string(1000000, 'a')), "34aa973cd4c4daa4f61eeb2bdbad27316534016f");
+  ok &= check("MD5 \"\"", md5Of(""), "d41d8cd98f00b204e9800998ecf8427e");
+  ok &= check("MD5 \"abc\"", md5Of("abc"), "900150983cd24fb0d6963f7d28e17f72");
+  ok &= check("MD5 \"message digest\"", md5Of("message digest"), "f96b697d7cb7938d525a2f31aaf161d0");
+  ok &= check("MD5 80 digits", md5Of("12345678901234567890123456789012345678901234567890123456789012345678901234567890"), "57edf4a22be3c955ac49da2e2107b67a");
+  if (!ok)
+    return 1;
+
+  std::vector<uint8_t> data(megabytes << 20);
+  uint32_t seed = 1;
+  for (auto& b : data) {
+    seed = seed * 1103515245 + 12345;
+    b = seed >> 16;
+  }
+
+  printf("\nThroughput over %zu MB in 512 byte blocks:\n", megabytes);
+  uint32_t crc = 0xFFFFFFFF;
+  Sha1Context sha1;
+  Md5Context md5;
+  sha1Init(&sha1);
+  md5Init(&md5);
+  double crcSeconds = bench("CRC32", data, 0, [&](const uint8_t* block, size_t length) { crc = crcUpdate(crc, block, length); });
+  bench("SHA-1", data, crcSeconds, [&](const uint8_t* block, size_t length) { sha1Update(&sha1, block, length); });
+  bench("MD5", data, crcSeconds, [&](const uint8_t* block, size_t length) { md5Update(&md5, block, length); });
+
+  // Keep the results alive
+  uint8_t digest[SHA1_DIGEST_SIZE];
+  sha1Final(&sha1, digest);
+  md5Final(&md5, digest);
+  printf("\n(checksum %08X)\n", ~crc);
+  return 0;
+}
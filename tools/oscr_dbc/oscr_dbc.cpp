@@ -0,0 +1,365 @@
+/*
+ * oscr_dbc - OSCR database compiler
+ *
+ * Compiles the text databases from the sd folder (nes.txt, gba.txt, ...)
+ * into packed binary databases (nes.odb, gba.odb, ...) that the firmware
+ * can search with fixed size record compares instead of parsing text.
+ * Copy the .odb files next to the .txt files on the SD card, the firmware
+ * falls back to the .txt if an .odb is missing or does not match its .txt:
+ * the stored size differs or the .txt was modified after the .odb.
+ *
+ * Build: g++ -O2 -std=c++17 -o oscr_dbc oscr_dbc.cpp
+ * Usage: oscr_dbc [-o outdir] file.txt [file.txt ...]
+ *
+ * File layout (all values little endian):
+ *   header   32 bytes:
+ *              char[4]   magic "ODB1"
+ *              uint8_t   version
+ *              uint8_t   fieldCount
+ *              uint16_t  recordSize
+ *              uint32_t  recordCount
+ *              uint32_t  recordsOffset
+ *              uint32_t  poolOffset
+ *              uint32_t  poolSize
+ *              uint32_t  size of the .txt, used to detect stale databases
+ *              uint32_t  reserved
+ *   fields   fieldCount x { uint8_t type, uint8_t size }
+ *   records  recordCount x recordSize bytes:
+ *              uint32_t  offset of the name line in the .txt
+ *              uint32_t  offset of the name in the string pool
+ *              fields    in .txt order, see FieldType
+ *   pool     NUL terminated names
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Must match Cart_Reader.ino
+constexpr char kMagic[4] = { 'O', 'D', 'B', '1' };
+constexpr uint8_t kVersion = 1;
+constexpr size_t kHeaderSize = 32;
+constexpr size_t kRecordPrefix = 8;
+constexpr size_t kMaxFields = 8;
+constexpr size_t kMaxRecordSize = 64;
+// Longest name compareCRC() can hold without truncating
+constexpr size_t kMaxNameLength = 95;
+
+enum FieldType : uint8_t {
+  FIELD_HEX32 = 1,  // 8 hex digits, stored as uint32_t
+  FIELD_BYTES = 2,  // even number of hex digits, stored as raw bytes
+  FIELD_DEC16 = 3,  // decimal number up to 65535, stored as uint16_t
+  FIELD_HEX16 = 4,  // 4 hex digits, stored as uint16_t
+  FIELD_STR = 5,    // anything else, NUL padded
+};
+
+struct Field {
+  FieldType type;
+  uint8_t size;
+};
+
+struct Entry {
+  uint32_t txtOffset;
+  size_t line;
+  std::string name;
+  std::vector<std::string> values;
+};
+
+struct Report {
+  unsigned errors = 0;
+  unsigned warnings = 0;
+
+  void error(const std::string& file, size_t line, const std::string& msg) {
+    std::cout << file << ":" << line << ": error: " << msg << "\n";
+    errors++;
+  }
+  void warning(const std::string& file, size_t line, const std::string& msg) {
+    std::cout << file << ":" << line << ": warning: " << msg << "\n";
+    warnings++;
+  }
+};
+
+bool isHex(const std::string& s) {
+  if (s.empty())
+    return false;
+  for (char c : s) {
+    if (!isxdigit(static_cast<unsigned char>(c)))
+      return false;
+  }
+  return true;
+}
+
+bool isDec(const std::string& s) {
+  if (s.empty() || s.size() > 5)
+    return false;
+  for (char c : s) {
+    if (!isdigit(static_cast<unsigned char>(c)))
+      return false;
+  }
+  return strtoul(s.c_str(), nullptr, 10) <= 0xFFFF;
+}
+
+std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> out;
+  std::stringstream ss(line);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    out.push_back(item);
+  return out;
+}
+
+void put16(std::vector<uint8_t>& out, size_t pos, uint16_t v) {
+  out[pos] = v & 0xFF;
+  out[pos + 1] = v >> 8;
+}
+
+void put32(std::vector<uint8_t>& out, size_t pos, uint32_t v) {
+  for (int i = 0; i < 4; i++)
+    out[pos + i] = (v >> (8 * i)) & 0xFF;
+}
+
+// Read name/fields/blank triplets, remembering where every entry starts
+bool parse(const std::string& path, const std::string& text, std::vector<Entry>& entries, Report& report) {
+  size_t pos = 0;
+  size_t lineNo = 0;
+  bool sawLF = false;
+
+  auto nextLine = [&](std::string& line, uint32_t& start) -> bool {
+    if (pos >= text.size())
+      return false;
+    start = pos;
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos)
+      end = text.size();
+    line = text.substr(pos, end - pos);
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    else if (end < text.size())
+      sawLF = true;
+    pos = end + 1;
+    lineNo++;
+    return true;
+  };
+
+  std::string line;
+  uint32_t start;
+  while (nextLine(line, start)) {
+    if (line.empty())
+      continue;
+    Entry e;
+    e.txtOffset = start;
+    e.line = lineNo;
+    e.name = line;
+    std::string fields;
+    uint32_t unused;
+    if (!nextLine(fields, unused) || fields.empty()) {
+      report.error(path, e.line, "entry \"" + e.name + "\" has no data line");
+      return false;
+    }
+    e.values = split(fields);
+    entries.push_back(e);
+    std::string blank;
+    if (nextLine(blank, unused) && !blank.empty())
+      report.error(path, lineNo, "expected an empty line after an entry");
+  }
+
+  if (sawLF)
+    report.warning(path, 0, "file uses LF line endings, the firmware expects CRLF");
+  return true;
+}
+
+// Pick the narrowest type that fits every value of a column
+Field inferField(const std::vector<Entry>& entries, size_t column) {
+  bool hex32 = true, bytes = true, dec = true, hex16 = true;
+  size_t len = entries.front().values[column].size();
+  size_t maxLen = 0;
+
+  for (const Entry& e : entries) {
+    const std::string& v = e.values[column];
+    maxLen = std::max(maxLen, v.size());
+    hex32 = hex32 && v.size() == 8 && isHex(v);
+    bytes = bytes && v.size() == len && v.size() > 8 && (v.size() % 2) == 0 && isHex(v);
+    dec = dec && isDec(v);
+    hex16 = hex16 && v.size() == 4 && isHex(v);
+  }
+
+  if (hex32)
+    return { FIELD_HEX32, 4 };
+  if (bytes)
+    return { FIELD_BYTES, static_cast<uint8_t>(len / 2) };
+  if (dec)
+    return { FIELD_DEC16, 2 };
+  if (hex16)
+    return { FIELD_HEX16, 2 };
+  return { FIELD_STR, static_cast<uint8_t>(maxLen + 1) };
+}
+
+bool compile(const std::string& path, const std::string& outDir, Report& report) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    report.error(path, 0, "cannot open file");
+    return false;
+  }
+  std::string text((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+  std::vector<Entry> entries;
+  unsigned errorsBefore = report.errors;
+  if (!parse(path, text, entries, report))
+    return false;
+  if (entries.empty()) {
+    report.error(path, 0, "no entries found");
+    return false;
+  }
+
+  size_t fieldCount = entries.front().values.size();
+  for (const Entry& e : entries) {
+    if (e.values.size() != fieldCount) {
+      report.error(path, e.line + 1, "expected " + std::to_string(fieldCount) + " fields, found " + std::to_string(e.values.size()));
+    }
+    if (e.name.size() > kMaxNameLength)
+      report.warning(path, e.line, "name longer than " + std::to_string(kMaxNameLength) + " characters will be truncated");
+  }
+  if (fieldCount > kMaxFields) {
+    report.error(path, 0, "more than " + std::to_string(kMaxFields) + " fields per entry");
+  }
+  if (report.errors != errorsBefore)
+    return false;
+
+  std::vector<Field> fields;
+  size_t recordSize = kRecordPrefix;
+  for (size_t c = 0; c < fieldCount; c++) {
+    fields.push_back(inferField(entries, c));
+    recordSize += fields.back().size;
+  }
+  if (recordSize > kMaxRecordSize) {
+    report.error(path, 0, "record size " + std::to_string(recordSize) + " exceeds " + std::to_string(kMaxRecordSize) + " bytes");
+    return false;
+  }
+
+  // In CRC only databases an entry whose CRC repeats can never be found by a first match search
+  if ((fieldCount == 1) && (fields[0].type == FIELD_HEX32)) {
+    std::map<std::string, size_t> seen;
+    for (const Entry& e : entries) {
+      auto it = seen.emplace(e.values[0], e.line);
+      if (!it.second)
+        report.warning(path, e.line, "CRC " + e.values[0] + " already used on line " + std::to_string(it.first->second));
+    }
+  }
+
+  // String pool
+  std::vector<uint8_t> pool;
+  std::vector<uint32_t> nameOffsets;
+  std::map<std::string, uint32_t> pooled;
+  for (const Entry& e : entries) {
+    auto it = pooled.find(e.name);
+    if (it == pooled.end()) {
+      it = pooled.emplace(e.name, static_cast<uint32_t>(pool.size())).first;
+      pool.insert(pool.end(), e.name.begin(), e.name.end());
+      pool.push_back(0);
+    }
+    nameOffsets.push_back(it->second);
+  }
+
+  size_t recordsOffset = kHeaderSize + fieldCount * 2;
+  size_t poolOffset = recordsOffset + entries.size() * recordSize;
+  std::vector<uint8_t> out(poolOffset, 0);
+
+  memcpy(out.data(), kMagic, sizeof(kMagic));
+  out[4] = kVersion;
+  out[5] = static_cast<uint8_t>(fieldCount);
+  put16(out, 6, static_cast<uint16_t>(recordSize));
+  put32(out, 8, static_cast<uint32_t>(entries.size()));
+  put32(out, 12, static_cast<uint32_t>(recordsOffset));
+  put32(out, 16, static_cast<uint32_t>(poolOffset));
+  put32(out, 20, static_cast<uint32_t>(pool.size()));
+  put32(out, 24, static_cast<uint32_t>(text.size()));
+
+  for (size_t c = 0; c < fieldCount; c++) {
+    out[kHeaderSize + c * 2] = fields[c].type;
+    out[kHeaderSize + c * 2 + 1] = fields[c].size;
+  }
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    size_t pos = recordsOffset + i * recordSize;
+    put32(out, pos, entries[i].txtOffset);
+    put32(out, pos + 4, nameOffsets[i]);
+    pos += kRecordPrefix;
+    for (size_t c = 0; c < fieldCount; c++) {
+      const std::string& v = entries[i].values[c];
+      switch (fields[c].type) {
+        case FIELD_HEX32:
+          put32(out, pos, strtoul(v.c_str(), nullptr, 16));
+          break;
+        case FIELD_BYTES:
+          for (size_t b = 0; b < fields[c].size; b++)
+            out[pos + b] = strtoul(v.substr(b * 2, 2).c_str(), nullptr, 16);
+          break;
+        case FIELD_DEC16:
+          put16(out, pos, strtoul(v.c_str(), nullptr, 10));
+          break;
+        case FIELD_HEX16:
+          put16(out, pos, strtoul(v.c_str(), nullptr, 16));
+          break;
+        case FIELD_STR:
+          memcpy(&out[pos], v.data(), v.size());
+          break;
+      }
+      pos += fields[c].size;
+    }
+  }
+  out.insert(out.end(), pool.begin(), pool.end());
+
+  std::string base = path.substr(path.find_last_of('/') + 1);
+  base = base.substr(0, base.find_last_of('.')) + ".odb";
+  std::string outPath = outDir.empty() ? path.substr(0, path.size() - path.substr(path.find_last_of('/') + 1).size()) + base : outDir + "/" + base;
+  std::ofstream os(outPath, std::ios::binary);
+  if (!os.write(reinterpret_cast<const char*>(out.data()), out.size())) {
+    report.error(outPath, 0, "cannot write file");
+    return false;
+  }
+
+  static const char* typeNames[] = { "?", "hex32", "bytes", "dec16", "hex16", "str" };
+  std::cout << path << ": " << entries.size() << " records of " << recordSize << " bytes, " << pool.size() << " byte name pool, fields:";
+  for (const Field& f : fields)
+    std::cout << " " << typeNames[f.type] << "[" << unsigned(f.size) << "]";
+  std::cout << " -> " << outPath << " (" << out.size() << " bytes)\n";
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string outDir;
+  std::vector<std::string> files;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-o") && i + 1 < argc) {
+      outDir = argv[++i];
+    } else {
+      files.push_back(argv[i]);
+    }
+  }
+  if (files.empty()) {
+    std::cerr << "usage: oscr_dbc [-o outdir] file.txt [file.txt ...]\n";
+    return 2;
+  }
+
+  Report report;
+  unsigned compiled = 0;
+  for (const std::string& f : files) {
+    if (compile(f, outDir, report))
+      compiled++;
+  }
+  std::cout << compiled << "/" << files.size() << " databases compiled, " << report.errors << " errors, " << report.warnings << " warnings\n";
+  return report.errors ? 1 : 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * oscr_remote - drives an OSCR built with OPTION_REMOTE over its serial port
+ *
+ * Every argument is one step. A command (INFO, STATUS, LIST /, CRC <file>,
+ * DUMP [core], SAVE [core], MENU <n>, PRESS) is sent and its OK/ERR line
+ * awaited, @NAME waits for the next "EVT NAME" line, for example @WAIT
+ * after a dump or @READY for the next menu. Everything the reader sends
+ * is copied to stdout, so the output can be parsed line by line.
+ *
+ * Build: g++ -O2 -std=c++17 -o oscr_remote oscr_remote.cpp
+ * Usage: oscr_remote [-p port] [-b baud] [-t seconds] step [step ...]
+ * Example: oscr_remote -p /dev/ttyUSB0 "DUMP N64" @WAIT PRESS @READY "SAVE N64" @WAIT PRESS
+ *
+ * The port is opened without hangup on close, so only the first run after
+ * plugging in resets the Mega. The first step waits until the reader
+ * answers INFO, which covers the time the bootloader needs after a reset.
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+speed_t baudConstant(long baud) {
+  switch (baud) {
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    default: return 0;
+  }
+}
+
+class Port {
+public:
+  bool open(const std::string& path, long baud) {
+    fd = ::open(path.c_str(), O_RDWR | O_NOCTTY);
+    if (fd < 0)
+      return false;
+
+    // Raw mode, no hangup on close so the next run does not reset the Mega again
+    termios tio;
+    if (tcgetattr(fd, &tio) == 0) {
+      cfmakeraw(&tio);
+      tio.c_cflag |= CLOCAL | CREAD;
+      tio.c_cflag &= ~HUPCL;
+      speed_t speed = baudConstant(baud);
+      cfsetispeed(&tio, speed);
+      cfsetospeed(&tio, speed);
+      tcsetattr(fd, TCSANOW, &tio);
+    }
+    return true;
+  }
+
+  void send(const std::string& line) {
+    std::string out = line + "\n";
+    if (write(fd, out.data(), out.size()) != (ssize_t)out.size())
+      perror("write");
+  }
+
+  // Next complete line without CR/LF, false on timeout
+  bool readLine(std::string& line, Clock::time_point deadline) {
+    for (;;) {
+      size_t end = buffer.find('\n');
+      if (end != std::string::npos) {
+        line = buffer.substr(0, end);
+        buffer.erase(0, end + 1);
+        if (!line.empty() && line.back() == '\r')
+          line.pop_back();
+        return true;
+      }
+
+      auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+      if (left <= 0)
+        return false;
+      pollfd p = { fd, POLLIN, 0 };
+      if (poll(&p, 1, (int)left) <= 0)
+        continue;
+      char chunk[256];
+      ssize_t n = read(fd, chunk, sizeof(chunk));
+      if (n <= 0)
+        return false;
+      buffer.append(chunk, n);
+    }
+  }
+
+private:
+  int fd = -1;
+  std::string buffer;
+};
+
+bool startsWith(const std::string& s, const std::string& prefix) {
+  return s.compare(0, prefix.size(), prefix) == 0;
+}
+
+// Sends INFO until the reader answers, it might still be in the bootloader
+bool connect(Port& port, int seconds) {
+  auto deadline = Clock::now() + std::chrono::seconds(seconds);
+  std::string line;
+  while (Clock::now() < deadline) {
+    port.send("INFO");
+    auto retry = std::min(deadline, Clock::now() + std::chrono::seconds(1));
+    while (port.readLine(line, retry)) {
+      std::cout << line << "\n";
+      if (startsWith(line, "OK INFO"))
+        return true;
+    }
+  }
+  return false;
+}
+
+// Runs one step, returns 0 when it succeeded, 1 on ERR and 2 on timeout
+int runStep(Port& port, const std::string& step, int seconds) {
+  auto deadline = Clock::now() + std::chrono::seconds(seconds);
+  std::string name = step.substr(0, step.find(' '));
+  std::string line;
+
+  if (startsWith(step, "@")) {
+    std::string event = "EVT " + step.substr(1);
+    while (port.readLine(line, deadline)) {
+      std::cout << line << "\n";
+      if ((line == event) || startsWith(line, event + " "))
+        return 0;
+    }
+  } else {
+    port.send(step);
+    while (port.readLine(line, deadline)) {
+      std::cout << line << "\n";
+      if (startsWith(line, "OK " + name))
+        return 0;
+      if (startsWith(line, "ERR " + name))
+        return 1;
+    }
+  }
+  std::cerr << "timeout: " << step << "\n";
+  return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string path = "/dev/ttyUSB0";
+  long baud = 9600;
+  int seconds = 600;
+  std::vector<std::string> steps;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-p") && i + 1 < argc) {
+      path = argv[++i];
+    } else if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+      baud = atol(argv[++i]);
+    } else if (!strcmp(argv[i], "-t") && i + 1 < argc) {
+      seconds = atoi(argv[++i]);
+    } else {
+      steps.push_back(argv[i]);
+    }
+  }
+  if (steps.empty() || !baudConstant(baud)) {
+    std::cerr << "usage: oscr_remote [-p port] [-b baud] [-t seconds] step [step ...]\n";
+    return 2;
+  }
+
+  Port port;
+  if (!port.open(path, baud)) {
+    perror(path.c_str());
+    return 2;
+  }
+  if (!connect(port, 10)) {
+    std::cerr << path << ": no answer to INFO\n";
+    return 2;
+  }
+
+  std::cout.setf(std::ios::unitbuf);
+  for (const std::string& step : steps) {
+    int result = runStep(port, step, seconds);
+    if (result)
+      return result;
+  }
+  return 0;
+}
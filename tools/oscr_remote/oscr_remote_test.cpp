@@ -0,0 +1,245 @@
+/*
+ * oscr_remote_test - runs oscr_remote against a simulated Cart Reader on a pty
+ *
+ * The simulator answers the remote commands like a reader built with
+ * OPTION_REMOTE that waits in the N64 cart menu. It ignores the first
+ * INFO, like a Mega that is still in the bootloader. Each case starts
+ * oscr_remote on the pty and checks its exit code and output.
+ *
+ * Build: g++ -O2 -std=c++17 -o oscr_remote_test oscr_remote_test.cpp
+ * Usage: oscr_remote_test [path to oscr_remote]
+ */
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// The reader side of the serial port, one instance per case
+class Simulator {
+public:
+  explicit Simulator(int fd)
+    : fd(fd) {}
+
+  // Feeds bytes sent by oscr_remote, answers every complete line
+  void receive(const char* data, size_t length) {
+    input.append(data, length);
+    size_t end;
+    while ((end = input.find('\n')) != std::string::npos) {
+      std::string line = input.substr(0, end);
+      input.erase(0, end + 1);
+      if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+      command(line);
+    }
+  }
+
+private:
+  void send(const std::string& line) {
+    std::string out = line + "\r\n";
+    if (write(fd, out.data(), out.size()) != (ssize_t)out.size())
+      perror("write");
+  }
+
+  void menu() {
+    inMenu = true;
+    send("EVT MENU N64 Cart");
+    send("EVT ITEM 0 Read ROM");
+    send("EVT ITEM 1 Read Save");
+    send("EVT ITEM 2 Back");
+    send("EVT READY");
+  }
+
+  void command(const std::string& line) {
+    size_t space = line.find(' ');
+    std::string cmd = line.substr(0, space);
+    std::string arg = (space == std::string::npos) ? "" : line.substr(space + 1);
+
+    if (cmd == "INFO") {
+      // Still in the bootloader
+      if (!booted) {
+        booted = true;
+        return;
+      }
+      send("OK INFO version=SIM hw=HW5 clock=16");
+    } else if (cmd == "LIST") {
+      if ((arg != "") && (arg != "/"))
+        return send("ERR LIST no folder");
+      send("DIR N64");
+      send("FILE 1024 config.txt");
+      send("OK LIST 2");
+    } else if (cmd == "CRC") {
+      if (arg != "config.txt")
+        return send("ERR CRC no file");
+      send("EVT PROGRESS 1024 1024");
+      send("OK CRC 1A2B3C4D 1024");
+    } else if (cmd == "DUMP") {
+      if (!inMenu)
+        return send("ERR DUMP busy");
+      if ((arg != "") && (strncasecmp("N64 Cart", arg.c_str(), arg.size()) != 0))
+        return send("ERR DUMP wrong core");
+      send("OK DUMP 0");
+      inMenu = false;
+      // The dump itself, the events come before the one the client waits for
+      send("EVT PROGRESS 4194304 8388608");
+      send("EVT PROGRESS 8388608 8388608");
+      send("EVT CRC 5A3B1C2D OK Super Mario 64 (USA).z64");
+      send("EVT WAIT");
+    } else if (cmd == "PRESS") {
+      if (inMenu)
+        return send("ERR PRESS in menu");
+      send("OK PRESS");
+      menu();
+    }
+  }
+
+  int fd;
+  std::string input;
+  bool booted = false;
+  bool inMenu = true;
+};
+
+struct Result {
+  int exitCode = -1;
+  std::string output;
+};
+
+// Runs oscr_remote with args on a new pty and simulates the reader until it exits
+Result run(const std::string& tool, const std::vector<std::string>& args) {
+  Result result;
+
+  int master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((master < 0) || grantpt(master) || unlockpt(master)) {
+    perror("pty");
+    return result;
+  }
+  std::string slavePath = ptsname(master);
+  // Kept open so the pty doesn't hang up between the tool's open and close
+  int slave = open(slavePath.c_str(), O_RDWR | O_NOCTTY);
+  termios tio;
+  tcgetattr(slave, &tio);
+  cfmakeraw(&tio);
+  tcsetattr(slave, TCSANOW, &tio);
+
+  int out[2];
+  if (pipe(out)) {
+    perror("pipe");
+    return result;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    dup2(out[1], STDOUT_FILENO);
+    close(out[0]);
+    close(out[1]);
+    close(master);
+    close(slave);
+    std::vector<char*> argv;
+    std::string port = "-p";
+    argv.push_back(const_cast<char*>(tool.c_str()));
+    argv.push_back(&port[0]);
+    argv.push_back(&slavePath[0]);
+    for (const std::string& arg : args)
+      argv.push_back(const_cast<char*>(arg.c_str()));
+    argv.push_back(nullptr);
+    execv(tool.c_str(), argv.data());
+    perror(tool.c_str());
+    _exit(127);
+  }
+  close(out[1]);
+
+  Simulator reader(master);
+  auto deadline = Clock::now() + std::chrono::seconds(20);
+  bool outputOpen = true;
+  while (outputOpen && (Clock::now() < deadline)) {
+    pollfd p[2] = { { master, POLLIN, 0 }, { out[0], POLLIN, 0 } };
+    if (poll(p, 2, 100) <= 0)
+      continue;
+    char chunk[256];
+    if (p[0].revents & POLLIN) {
+      ssize_t n = read(master, chunk, sizeof(chunk));
+      if (n > 0)
+        reader.receive(chunk, n);
+    }
+    if (p[1].revents & (POLLIN | POLLHUP)) {
+      ssize_t n = read(out[0], chunk, sizeof(chunk));
+      if (n > 0)
+        result.output.append(chunk, n);
+      else
+        outputOpen = false;
+    }
+  }
+  if (outputOpen)
+    kill(pid, SIGKILL);
+
+  int status;
+  waitpid(pid, &status, 0);
+  result.exitCode = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+  close(out[0]);
+  close(slave);
+  close(master);
+  return result;
+}
+
+int failures = 0;
+
+void check(const std::string& name, bool ok, const Result& result) {
+  std::cout << (ok ? "PASS " : "FAIL ") << name << "\n";
+  if (!ok) {
+    std::cout << "  exit code " << result.exitCode << ", output:\n"
+              << result.output;
+    failures++;
+  }
+}
+
+bool contains(const std::string& s, const std::string& part) {
+  return s.find(part) != std::string::npos;
+}
+
+bool endsWith(const std::string& s, const std::string& suffix) {
+  return (s.size() >= suffix.size()) && (s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::string tool = (argc > 1) ? argv[1] : "./oscr_remote";
+  Result r;
+
+  r = run(tool, { "INFO" });
+  check("INFO after the bootloader", (r.exitCode == 0) && contains(r.output, "OK INFO version=SIM hw=HW5 clock=16\n"), r);
+
+  r = run(tool, { "LIST /" });
+  check("LIST", (r.exitCode == 0) && contains(r.output, "DIR N64\nFILE 1024 config.txt\nOK LIST 2\n"), r);
+
+  r = run(tool, { "CRC config.txt" });
+  check("CRC", (r.exitCode == 0) && contains(r.output, "EVT PROGRESS 1024 1024\nOK CRC 1A2B3C4D 1024\n"), r);
+
+  r = run(tool, { "CRC missing.bin", "INFO" });
+  check("CRC of a missing file stops with ERR", (r.exitCode == 1) && endsWith(r.output, "ERR CRC no file\n"), r);
+
+  r = run(tool, { "DUMP N64", "@WAIT", "PRESS", "@READY" });
+  check("DUMP and event waits", (r.exitCode == 0) && contains(r.output, "OK DUMP 0\n") && contains(r.output, "EVT CRC 5A3B1C2D OK Super Mario 64 (USA).z64\nEVT WAIT\nOK PRESS\n") && endsWith(r.output, "EVT READY\n"), r);
+
+  r = run(tool, { "DUMP SNES" });
+  check("DUMP in the wrong core", (r.exitCode == 1) && endsWith(r.output, "ERR DUMP wrong core\n"), r);
+
+  r = run(tool, { "-t", "1", "INFO", "@WAIT" });
+  check("Event that never comes times out", r.exitCode == 2, r);
+
+  std::cout << (failures ? "FAILED\n" : "OK\n");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,662 @@
+/*
+ * oscr_verify - checks all dumps on an OSCR SD card against its databases
+ *
+ * Walks <card>/<SYSTEM>/ROM/ the way the firmware lays out dumps
+ * (N64/ROM/<name>/<n>/<name>.Z64, ...), hashes every file on a pool of
+ * threads and looks the CRC32 up in the same .txt databases from the card
+ * root that compareCRC() uses. Prints one line per dump and a summary.
+ *
+ * Build: g++ -O2 -std=c++17 -pthread -o oscr_verify oscr_verify.cpp
+ * Usage: oscr_verify [-j threads] [-d dbdir] [-q] /path/to/sdcard
+ *
+ * Like the firmware, the CRC32 of NES and Lynx dumps skips the 16 byte
+ * iNES and 64 byte LYNX header. For NES the header is also compared with
+ * the one in nes.txt. For SNES the internal checksum is recalculated,
+ * mirroring odd sized ROMs up to the next power of two like calc_checksum().
+ */
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define HAVE_ARM_CRC32 1
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Files up to this size are read in the hashing thread, larger ones get a reader thread
+constexpr size_t kChunkSize = 1 << 20;
+constexpr size_t kPipelineDepth = 4;
+constexpr uint64_t kStreamThreshold = 8 << 20;
+
+constexpr size_t kNesHeaderSize = 16;
+constexpr size_t kLynxHeaderSize = 64;
+
+/*==== CRC32 ======================================================*/
+
+// Slicing-by-8 over the reflected 0xEDB88320 polynomial, the same CRC32 as UPDATE_CRC in the firmware
+uint32_t crcTable[8][256];
+
+void crcInit() {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t c = i;
+    for (int k = 0; k < 8; k++)
+      c = (c & 1) ? (0xEDB88320 ^ (c >> 1)) : (c >> 1);
+    crcTable[0][i] = c;
+  }
+  for (uint32_t i = 0; i < 256; i++) {
+    for (int t = 1; t < 8; t++)
+      crcTable[t][i] = crcTable[0][crcTable[t - 1][i] & 0xFF] ^ (crcTable[t - 1][i] >> 8);
+  }
+}
+
+// Takes and returns the CRC without the final inversion, start with 0xFFFFFFFF
+uint32_t crcUpdate(uint32_t crc, const uint8_t* data, size_t length) {
+#ifdef HAVE_ARM_CRC32
+  while (length >= 8) {
+    uint64_t v;
+    memcpy(&v, data, 8);
+    crc = __crc32d(crc, v);
+    data += 8;
+    length -= 8;
+  }
+#else
+  while (length >= 8) {
+    uint32_t lo, hi;
+    memcpy(&lo, data, 4);
+    memcpy(&hi, data + 4, 4);
+    lo ^= crc;
+    crc = crcTable[7][lo & 0xFF] ^ crcTable[6][(lo >> 8) & 0xFF] ^ crcTable[5][(lo >> 16) & 0xFF] ^ crcTable[4][lo >> 24] ^ crcTable[3][hi & 0xFF] ^ crcTable[2][(hi >> 8) & 0xFF] ^ crcTable[1][(hi >> 16) & 0xFF] ^ crcTable[0][hi >> 24];
+    data += 8;
+    length -= 8;
+  }
+#endif
+  while (length--)
+    crc = crcTable[0][(crc ^ *data++) & 0xFF] ^ (crc >> 8);
+  return crc;
+}
+
+// The slicing loop reads little endian words
+bool crcSelfTest() {
+  const char* check = "123456789";
+  uint32_t crc = ~crcUpdate(0xFFFFFFFF, reinterpret_cast<const uint8_t*>(check), 9);
+  return crc == 0xCBF43926;
+}
+
+/*==== /CRC32 =====================================================*/
+
+/*==== DATABASES ==================================================*/
+
+struct DbEntry {
+  std::string name;
+  std::vector<std::string> fields;
+};
+
+struct Database {
+  std::string file;
+  std::vector<DbEntry> entries;
+  std::unordered_multimap<uint32_t, size_t> byCrc;
+};
+
+// Databases of every system folder whose name differs, anything else uses <folder>.txt
+struct SystemInfo {
+  const char* folder;
+  std::vector<const char*> databases;
+};
+
+const std::vector<SystemInfo> kSystems = {
+  { "ATARI", { "2600.txt" } },
+  { "ATARI8", { "atari8cart.txt" } },
+  { "ARC", { "arccart.txt" } },
+  { "BALLY", { "ballycart.txt" } },
+  { "C64", { "c64cart.txt" } },
+  { "COL", { "colv.txt" } },
+  { "FAIRCHILD", { "fairchildcart.txt" } },
+  { "LEAP", { "leapster.txt" } },
+  { "LJ", { "ljcart.txt" } },
+  { "LJPRO", { "ljcart.txt" } },
+  { "MD", { "md.txt", "32x.txt" } },
+  { "MSX", { "msxcart.txt" } },
+  { "ODY2", { "ody2cart.txt" } },
+  { "POKE", { "pkmn.txt" } },
+  { "PV1000", { "pv1000cart.txt" } },
+  { "PYUUTA", { "pyuutacart.txt" } },
+  { "RCA", { "rcacart.txt" } },
+  { "TI99", { "ti99cart.txt" } },
+  { "TRS80", { "trs80cart.txt" } },
+  { "VBOY", { "vb.txt" } },
+  { "VECTREX", { "vectrexcart.txt" } },
+  { "VIC20", { "vic20cart.txt" } },
+  { "VSMILE", { "vsmilecart.txt" } },
+};
+
+std::vector<std::string> split(const std::string& line) {
+  std::vector<std::string> out;
+  std::stringstream ss(line);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    out.push_back(item);
+  return out;
+}
+
+// Reads the name/fields/blank triplets, the first field is the CRC32 compareCRC() searches for
+bool loadDatabase(const fs::path& path, Database& db) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is)
+    return false;
+
+  db.file = path.filename().string();
+  std::string line, name;
+  while (std::getline(is, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty())
+      continue;
+    if (name.empty()) {
+      name = line;
+      continue;
+    }
+    DbEntry entry{ name, split(line) };
+    name.clear();
+    if (entry.fields.empty() || entry.fields[0].size() != 8)
+      continue;
+    char* end;
+    uint32_t crc = strtoul(entry.fields[0].c_str(), &end, 16);
+    if (*end)
+      continue;
+    db.byCrc.emplace(crc, db.entries.size());
+    db.entries.push_back(std::move(entry));
+  }
+  return true;
+}
+
+/*==== /DATABASES =================================================*/
+
+/*==== HASHING ====================================================*/
+
+enum class HeaderType { NONE, NES, LYNX };
+
+struct Job {
+  fs::path path;
+  std::string system;
+  uint64_t size = 0;
+  const std::vector<const Database*>* databases = nullptr;
+
+  // Results
+  bool readError = false;
+  HeaderType header = HeaderType::NONE;
+  uint8_t nesHeader[kNesHeaderSize] = {};
+  uint32_t crc = 0;
+  // Byte sums of the largest power of two and of the rest, for the SNES checksum
+  uint32_t sumBase = 0;
+  uint32_t sumRest = 0;
+  uint16_t snesHeaderChecksum = 0;
+  bool snesHeaderFound = false;
+};
+
+uint64_t snesBase(uint64_t size) {
+  uint64_t base = 1;
+  while ((base << 1) <= size)
+    base <<= 1;
+  return base;
+}
+
+// Gets the ROM data in order, either directly or from a reader thread that stays a few chunks ahead
+class ChunkStream {
+public:
+  ChunkStream(int fd, uint64_t size)
+    : fd(fd), size(size) {
+    if (size > kStreamThreshold) {
+      for (size_t i = 0; i < kPipelineDepth; i++)
+        free.push_back(std::make_unique<Chunk>());
+      reader = std::thread(&ChunkStream::readAhead, this);
+    } else {
+      direct = std::make_unique<Chunk>();
+    }
+  }
+
+  ~ChunkStream() {
+    if (reader.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        stop = true;
+      }
+      changed.notify_all();
+      reader.join();
+    }
+  }
+
+  // Returns the next chunk or nullptr at the end, the chunk stays valid until the next call
+  const std::vector<uint8_t>* next(bool& error) {
+    if (direct) {
+      direct->data.resize(kChunkSize);
+      ssize_t n = (offset < size) ? readFull(direct->data.data(), std::min<uint64_t>(kChunkSize, size - offset), offset) : 0;
+      if (n < 0) {
+        error = true;
+        return nullptr;
+      }
+      offset += n;
+      direct->data.resize(n);
+      return n ? &direct->data : nullptr;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    if (current)
+      free.push_back(std::move(current));
+    changed.notify_all();
+    changed.wait(lock, [&] { return !full.empty() || done; });
+    if (full.empty()) {
+      error = readError;
+      return nullptr;
+    }
+    current = std::move(full.front());
+    full.erase(full.begin());
+    return &current->data;
+  }
+
+private:
+  struct Chunk {
+    std::vector<uint8_t> data = std::vector<uint8_t>(kChunkSize);
+  };
+
+  ssize_t readFull(uint8_t* buffer, size_t length, uint64_t position) {
+    size_t got = 0;
+    while (got < length) {
+      ssize_t n = pread(fd, buffer + got, length - got, position + got);
+      if (n < 0)
+        return -1;
+      if (n == 0)
+        break;
+      got += n;
+    }
+    return got;
+  }
+
+  void readAhead() {
+    uint64_t position = 0;
+    for (;;) {
+      std::unique_ptr<Chunk> chunk;
+      {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return !free.empty() || stop; });
+        if (stop)
+          return;
+        chunk = std::move(free.back());
+        free.pop_back();
+      }
+      chunk->data.resize(kChunkSize);
+
+      ssize_t n = (position < size) ? readFull(chunk->data.data(), std::min<uint64_t>(kChunkSize, size - position), position) : 0;
+      position += (n > 0) ? n : 0;
+
+      std::lock_guard<std::mutex> lock(mutex);
+      if (n <= 0) {
+        readError = (n < 0);
+        done = true;
+        changed.notify_all();
+        return;
+      }
+      chunk->data.resize(n);
+      full.push_back(std::move(chunk));
+      changed.notify_all();
+    }
+  }
+
+  int fd;
+  uint64_t size;
+  uint64_t offset = 0;
+  std::unique_ptr<Chunk> direct;
+
+  std::thread reader;
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::vector<std::unique_ptr<Chunk>> free;
+  std::vector<std::unique_ptr<Chunk>> full;
+  std::unique_ptr<Chunk> current;
+  bool done = false;
+  bool stop = false;
+  bool readError = false;
+};
+
+// Looks for the LoROM, HiROM and ExHiROM header whose checksum and complement add up
+void findSnesHeader(Job& job, const uint8_t* data, size_t length, uint64_t position) {
+  static const uint64_t headers[] = { 0x7FC0, 0xFFC0, 0x40FFC0 };
+  for (uint64_t header : headers) {
+    uint64_t at = header + 0x1C;
+    if (job.snesHeaderFound || (at < position) || (at + 4 > position + length))
+      continue;
+    const uint8_t* p = data + (at - position);
+    uint16_t complement = p[0] | (p[1] << 8);
+    uint16_t checksum = p[2] | (p[3] << 8);
+    if ((uint16_t)(complement ^ checksum) == 0xFFFF) {
+      job.snesHeaderChecksum = checksum;
+      job.snesHeaderFound = true;
+    }
+  }
+}
+
+void hashFile(Job& job) {
+  int fd = open(job.path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    job.readError = true;
+    return;
+  }
+  posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  bool snes = (job.system == "SNES");
+  uint64_t base = snesBase(job.size);
+  uint64_t position = 0;
+  uint32_t crc = 0xFFFFFFFF;
+  bool error = false;
+  {
+    ChunkStream stream(fd, job.size);
+    while (const std::vector<uint8_t>* chunk = stream.next(error)) {
+      const uint8_t* data = chunk->data();
+      size_t length = chunk->size();
+
+      if (position == 0) {
+        size_t skip = 0;
+        if ((length >= kNesHeaderSize) && !memcmp(data, "NES\x1A", 4)) {
+          job.header = HeaderType::NES;
+          memcpy(job.nesHeader, data, kNesHeaderSize);
+          skip = kNesHeaderSize;
+        } else if ((length >= kLynxHeaderSize) && !memcmp(data, "LYNX", 4)) {
+          job.header = HeaderType::LYNX;
+          skip = kLynxHeaderSize;
+        }
+        crc = crcUpdate(crc, data + skip, length - skip);
+      } else {
+        crc = crcUpdate(crc, data, length);
+      }
+
+      if (snes) {
+        findSnesHeader(job, data, length, position);
+        size_t split = (position < base) ? std::min<uint64_t>(length, base - position) : 0;
+        for (size_t i = 0; i < split; i++)
+          job.sumBase += data[i];
+        for (size_t i = split; i < length; i++)
+          job.sumRest += data[i];
+      }
+      position += length;
+    }
+  }
+  close(fd);
+  job.readError = error;
+  job.crc = ~crc;
+}
+
+// Same result as calc_checksum(), the part above the largest power of two is mirrored to fill it
+uint16_t snesChecksum(const Job& job) {
+  uint64_t base = snesBase(job.size);
+  uint64_t rest = job.size - base;
+  uint32_t sum = job.sumBase;
+  if (rest)
+    sum += job.sumRest * (base / rest);
+  return sum & 0xFFFF;
+}
+
+/*==== /HASHING ===================================================*/
+
+/*==== REPORT =====================================================*/
+
+std::string hex(uint32_t value, int digits) {
+  char buffer[9];
+  snprintf(buffer, sizeof(buffer), "%0*X", digits, value);
+  return buffer;
+}
+
+std::string hexBytes(const uint8_t* data, size_t length) {
+  std::string out;
+  for (size_t i = 0; i < length; i++)
+    out += hex(data[i], 2);
+  return out;
+}
+
+struct Totals {
+  unsigned ok = 0;
+  unsigned unknown = 0;
+  unsigned warnings = 0;
+  unsigned errors = 0;
+};
+
+struct Match {
+  const Database* db;
+  const DbEntry* entry;
+};
+
+// Where the header and checksum of a dump differ from a database entry, or from the ROM header without one
+std::vector<std::string> entryNotes(const Job& job, const DbEntry* match) {
+  std::vector<std::string> notes;
+  if (match && (job.header == HeaderType::NES) && (match->fields.size() > 2) && (match->fields[2].size() == 2 * kNesHeaderSize)) {
+    std::string header = hexBytes(job.nesHeader, kNesHeaderSize);
+    if (strcasecmp(header.c_str(), match->fields[2].c_str()) != 0)
+      notes.push_back("iNES header " + header + " differs from " + match->fields[2]);
+  }
+  if (job.system == "SNES") {
+    uint16_t checksum = snesChecksum(job);
+    if (match && (match->fields.size() > 1) && (strtoul(match->fields[1].c_str(), nullptr, 16) != checksum))
+      notes.push_back("checksum " + hex(checksum, 4) + " differs from database " + match->fields[1]);
+    else if (!match && job.snesHeaderFound && (job.snesHeaderChecksum != checksum))
+      notes.push_back("checksum " + hex(checksum, 4) + " differs from header " + hex(job.snesHeaderChecksum, 4));
+    else if (!match && job.snesHeaderFound)
+      notes.push_back("checksum " + hex(checksum, 4) + " matches header");
+  }
+  return notes;
+}
+
+// One line per dump: status, CRC32, path and the matching database entry, then the other entries with the same CRC32
+void report(const Job& job, const fs::path& root, bool quiet, Totals& totals) {
+  std::string path = fs::relative(job.path, root).string();
+  if (job.readError) {
+    std::cout << "ERROR    " << path << ": read failed\n";
+    totals.errors++;
+    return;
+  }
+
+  // Every entry with the CRC32, in database order. A dump can be listed more than once,
+  // for example under several names or with different iNES headers.
+  std::vector<Match> matches;
+  for (const Database* db : *job.databases) {
+    std::vector<size_t> found;
+    auto range = db->byCrc.equal_range(job.crc);
+    for (auto it = range.first; it != range.second; ++it)
+      found.push_back(it->second);
+    std::sort(found.begin(), found.end());
+    for (size_t index : found)
+      matches.push_back({ db, &db->entries[index] });
+  }
+
+  // The first entry the header and checksum agree with, otherwise the first one with its notes
+  const Database* matchDb = nullptr;
+  const DbEntry* match = nullptr;
+  std::vector<std::string> notes;
+  for (const Match& candidate : matches) {
+    std::vector<std::string> candidateNotes = entryNotes(job, candidate.entry);
+    if (!match || (!notes.empty() && candidateNotes.empty())) {
+      matchDb = candidate.db;
+      match = candidate.entry;
+      notes = std::move(candidateNotes);
+    }
+  }
+  if (!match)
+    notes = entryNotes(job, nullptr);
+
+  const char* status;
+  if (!match) {
+    status = "UNKNOWN ";
+    totals.unknown++;
+  } else if (!notes.empty()) {
+    status = "WARNING ";
+    totals.warnings++;
+  } else {
+    status = "OK      ";
+    totals.ok++;
+  }
+  if (quiet && match && notes.empty())
+    return;
+
+  std::cout << status << hex(job.crc, 8) << " " << path;
+  if (match)
+    std::cout << " = " << match->name << " (" << matchDb->file << ")";
+  else if (job.databases->empty())
+    std::cout << " (no database)";
+  std::cout << "\n";
+  for (const std::string& note : notes)
+    std::cout << "         " << note << "\n";
+  for (const Match& other : matches) {
+    if (other.entry != match)
+      std::cout << "         also " << other.entry->name << " (" << other.db->file << ")\n";
+  }
+}
+
+/*==== /REPORT ====================================================*/
+
+bool isDump(const fs::path& path) {
+  std::string ext = path.extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+  // Copies of the log and the hashes that are written next to the dump
+  return (ext != ".txt") && (ext != ".log") && (ext != ".sha1") && (ext != ".md5");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+  std::string dbDir;
+  std::string card;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-j") && i + 1 < argc) {
+      threads = std::max(1, atoi(argv[++i]));
+    } else if (!strcmp(argv[i], "-d") && i + 1 < argc) {
+      dbDir = argv[++i];
+    } else if (!strcmp(argv[i], "-q")) {
+      quiet = true;
+    } else {
+      card = argv[i];
+    }
+  }
+  if (card.empty()) {
+    std::cerr << "usage: oscr_verify [-j threads] [-d dbdir] [-q] /path/to/sdcard\n";
+    return 2;
+  }
+  if (dbDir.empty())
+    dbDir = card;
+
+  crcInit();
+  if (!crcSelfTest()) {
+    std::cerr << "CRC32 self test failed\n";
+    return 2;
+  }
+
+  // Collect the dumps of every system that has a ROM folder
+  std::error_code ec;
+  std::map<std::string, Database> databases;
+  std::map<std::string, std::vector<const Database*>> systemDatabases;
+  std::vector<Job> jobs;
+  for (const fs::directory_entry& system : fs::directory_iterator(card, ec)) {
+    fs::path romDir = system.path() / "ROM";
+    if (!system.is_directory() || !fs::is_directory(romDir))
+      continue;
+
+    std::string folder = system.path().filename().string();
+    std::vector<std::string> names;
+    auto known = std::find_if(kSystems.begin(), kSystems.end(), [&](const SystemInfo& s) { return folder == s.folder; });
+    if (known != kSystems.end()) {
+      names.assign(known->databases.begin(), known->databases.end());
+    } else {
+      std::string name = folder + ".txt";
+      std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+      names.push_back(name);
+    }
+
+    std::vector<const Database*>& list = systemDatabases[folder];
+    for (const std::string& name : names) {
+      auto it = databases.find(name);
+      if (it == databases.end()) {
+        Database db;
+        if (!loadDatabase(fs::path(dbDir) / name, db))
+          continue;
+        it = databases.emplace(name, std::move(db)).first;
+      }
+      list.push_back(&it->second);
+    }
+
+    for (const fs::directory_entry& entry : fs::recursive_directory_iterator(romDir, ec)) {
+      if (!entry.is_regular_file() || !isDump(entry.path()))
+        continue;
+      Job job;
+      job.path = entry.path();
+      job.system = folder;
+      job.size = entry.file_size();
+      job.databases = &list;
+      jobs.push_back(std::move(job));
+    }
+  }
+  if (ec) {
+    std::cerr << card << ": " << ec.message() << "\n";
+    return 2;
+  }
+
+  uint64_t totalBytes = 0;
+  for (const Job& job : jobs)
+    totalBytes += job.size;
+  std::cerr << jobs.size() << " dumps, " << (totalBytes >> 20) << " MB, " << databases.size() << " databases, " << threads << " threads\n";
+
+  // Largest files first so a big one does not end up alone at the end
+  std::vector<size_t> order(jobs.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return jobs[a].size > jobs[b].size; });
+
+  auto start = std::chrono::steady_clock::now();
+  std::atomic<size_t> nextJob{ 0 };
+  std::vector<std::thread> pool;
+  for (unsigned t = 0; t < threads; t++) {
+    pool.emplace_back([&] {
+      for (size_t i; (i = nextJob++) < order.size();)
+        hashFile(jobs[order[i]]);
+    });
+  }
+  for (std::thread& t : pool)
+    t.join();
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) { return a.path < b.path; });
+  Totals totals;
+  for (const Job& job : jobs)
+    report(job, card, quiet, totals);
+
+  std::cout << jobs.size() << " dumps: " << totals.ok << " ok, " << totals.warnings << " warnings, " << totals.unknown << " unknown, " << totals.errors << " read errors\n";
+  std::cerr << "Hashed " << (totalBytes >> 20) << " MB in " << seconds << " s";
+  if (seconds > 0)
+    std::cerr << " (" << (int)(totalBytes / seconds / 1e6) << " MB/s)";
+  std::cerr << "\n";
+  return (totals.unknown || totals.warnings || totals.errors) ? 1 : 0;
+}